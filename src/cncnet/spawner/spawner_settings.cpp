@@ -0,0 +1,67 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          SPAWNER_SETTINGS.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Settings provided by the CnCNet spawner through SPAWN.INI.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "spawner_settings.h"
+#include "rawfile.h"
+#include "ccini.h"
+#include "debughandler.h"
+
+
+/**
+ *  The settings instance, only written to by Load_Settings.
+ */
+static Spawner::SettingsStruct SpawnerSettings {
+    false,      // IsLoaded
+    false       // UseMPAIBaseNodes
+};
+
+const Spawner::SettingsStruct &Spawner::Settings = SpawnerSettings;
+
+
+/**
+ *  Parses SPAWN.INI into the settings structure.
+ * 
+ *  @author: agent
+ */
+bool Spawner::Load_Settings()
+{
+    static char const * const SETTINGS = "Settings";
+
+    RawFileClass file("SPAWN.INI");
+    if (!file.Is_Available()) {
+        return false;
+    }
+
+    CCINIClass spawn_ini;
+    spawn_ini.Load(file, false);
+
+    SpawnerSettings.UseMPAIBaseNodes = spawn_ini.Get_Bool(SETTINGS, "UseMPAIBaseNodes", SpawnerSettings.UseMPAIBaseNodes);
+
+    SpawnerSettings.IsLoaded = true;
+
+    return true;
+}
@@ -0,0 +1,62 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          SPAWNER_SETTINGS.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Settings provided by the CnCNet spawner through SPAWN.INI.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+
+
+namespace Spawner
+{
+
+/**
+ *  The settings read from SPAWN.INI. These are parsed once at startup
+ *  and do not change for the lifetime of the session.
+ */
+typedef struct SettingsStruct
+{
+    /**
+     *  Was SPAWN.INI found and loaded?
+     */
+    bool IsLoaded;
+
+    /**
+     *  Should the AI use the base nodes from the map in multiplayer games?
+     */
+    bool UseMPAIBaseNodes;
+
+} SettingsStruct;
+
+
+bool Load_Settings();
+
+/**
+ *  Read-only access to the spawner settings.
+ */
+extern const SettingsStruct &Settings;
+
+};
@@ -130,12 +130,11 @@ int BlowfishEngine::Encrypt(void const * plaintext, int length, void * cyphertex
 
         int blocks = length / BYTES_PER_BLOCK;
 
-        for (int index = 0; index < blocks; index++) {
-            Process_Block(plaintext, cyphertext, P_Encrypt);
-            plaintext = ((char *)plaintext) + BYTES_PER_BLOCK;
-            cyphertext = ((char *)cyphertext) + BYTES_PER_BLOCK;
-        }
+        Process_Blocks(plaintext, cyphertext, blocks, P_Encrypt);
+
         int encrypted = blocks * BYTES_PER_BLOCK;
+        plaintext = ((char *)plaintext) + encrypted;
+        cyphertext = ((char *)cyphertext) + encrypted;
 
         if (encrypted < length) {
             std::memmove(cyphertext, plaintext, length - encrypted);
@@ -166,12 +165,11 @@ int BlowfishEngine::Decrypt(void const * cyphertext, int length, void * plaintex
 
         int blocks = length / BYTES_PER_BLOCK;
 
-        for (int index = 0; index < blocks; index++) {
-            Process_Block(cyphertext, plaintext, P_Decrypt);
-            cyphertext = ((char *)cyphertext) + BYTES_PER_BLOCK;
-            plaintext = ((char *)plaintext) + BYTES_PER_BLOCK;
-        }
+        Process_Blocks(cyphertext, plaintext, blocks, P_Decrypt);
+
         int encrypted = blocks * BYTES_PER_BLOCK;
+        cyphertext = ((char *)cyphertext) + encrypted;
+        plaintext = ((char *)plaintext) + encrypted;
 
         if (encrypted < length) {
             std::memmove(plaintext, cyphertext, length - encrypted);
@@ -188,43 +186,201 @@ int BlowfishEngine::Decrypt(void const * cyphertext, int length, void * plaintex
 }
 
 
+/**
+ *  Encrypts a run of whole blocks. The source and destination may be the same
+ *  buffer, any trailing partial block is left untouched.
+ */
+void BlowfishEngine::Encrypt_Blocks(void const * plaintext, void * cyphertext, int blocks)
+{
+    if (plaintext == nullptr || blocks <= 0) {
+        return;
+    }
+
+    if (cyphertext == nullptr) {
+        cyphertext = (void *)plaintext;
+    }
+
+    if (!IsKeyed) {
+        if (plaintext != cyphertext) {
+            std::memmove(cyphertext, plaintext, blocks * BYTES_PER_BLOCK);
+        }
+        return;
+    }
+
+    Process_Blocks(plaintext, cyphertext, blocks, P_Encrypt);
+}
+
+
+/**
+ *  Decrypts a run of whole blocks. The source and destination may be the same
+ *  buffer, any trailing partial block is left untouched.
+ */
+void BlowfishEngine::Decrypt_Blocks(void const * cyphertext, void * plaintext, int blocks)
+{
+    if (cyphertext == nullptr || blocks <= 0) {
+        return;
+    }
+
+    if (plaintext == nullptr) {
+        plaintext = (void *)cyphertext;
+    }
+
+    if (!IsKeyed) {
+        if (plaintext != cyphertext) {
+            std::memmove(plaintext, cyphertext, blocks * BYTES_PER_BLOCK);
+        }
+        return;
+    }
+
+    Process_Blocks(cyphertext, plaintext, blocks, P_Decrypt);
+}
+
+
+/**
+ *  The Blowfish "F" function and a single round. The block halves are held in
+ *  registers as native 32-bit values so the S-Box lookups are plain shifts.
+ */
+#define BF_F(x) \
+    ((((uint32_t)bf_S[0][(x) >> 24] + (uint32_t)bf_S[1][((x) >> 16) & 0xFF]) \
+        ^ (uint32_t)bf_S[2][((x) >> 8) & 0xFF]) + (uint32_t)bf_S[3][(x) & 0xFF])
+
+#define BF_ROUND(a, b, n) \
+    a ^= (uint32_t)ptable[n]; \
+    b ^= BF_F(a);
+
+
+static inline uint32_t Load_Big_Endian(unsigned char const * ptr)
+{
+    return ((uint32_t)ptr[0] << 24) | ((uint32_t)ptr[1] << 16) | ((uint32_t)ptr[2] << 8) | (uint32_t)ptr[3];
+}
+
+
+static inline void Store_Big_Endian(unsigned char * ptr, uint32_t value)
+{
+    ptr[0] = (unsigned char)(value >> 24);
+    ptr[1] = (unsigned char)(value >> 16);
+    ptr[2] = (unsigned char)(value >> 8);
+    ptr[3] = (unsigned char)value;
+}
+
+
+/**
+ *  Processes a single block with the given P-Array (encryption or decryption
+ *  order). All sixteen rounds are unrolled.
+ */
 void BlowfishEngine::Process_Block(void const * plaintext, void * cyphertext, unsigned long const * ptable)
 {
     unsigned char const * source = (unsigned char const *)plaintext;
-    Int left;
-    left.Char.C0 = *source++;
-    left.Char.C1 = *source++;
-    left.Char.C2 = *source++;
-    left.Char.C3 = *source++;
-
-    Int right;
-    right.Char.C0 = *source++;
-    right.Char.C1 = *source++;
-    right.Char.C2 = *source++;
-    right.Char.C3 = *source;
-
-    for (int index = 0; index < ROUNDS/2; index++) {
-        left.Long ^= *ptable++;
-        right.Long ^= ((( bf_S[0][left.Char.C0] + bf_S[1][left.Char.C1]) ^ bf_S[2][left.Char.C2]) + bf_S[3][left.Char.C3]);
-        right.Long ^= *ptable++;
-        left.Long ^= ((( bf_S[0][right.Char.C0] + bf_S[1][right.Char.C1]) ^ bf_S[2][right.Char.C2]) + bf_S[3][right.Char.C3]);
+    uint32_t left = Load_Big_Endian(source);
+    uint32_t right = Load_Big_Endian(source + 4);
+
+    BF_ROUND(left, right, 0);
+    BF_ROUND(right, left, 1);
+    BF_ROUND(left, right, 2);
+    BF_ROUND(right, left, 3);
+    BF_ROUND(left, right, 4);
+    BF_ROUND(right, left, 5);
+    BF_ROUND(left, right, 6);
+    BF_ROUND(right, left, 7);
+    BF_ROUND(left, right, 8);
+    BF_ROUND(right, left, 9);
+    BF_ROUND(left, right, 10);
+    BF_ROUND(right, left, 11);
+    BF_ROUND(left, right, 12);
+    BF_ROUND(right, left, 13);
+    BF_ROUND(left, right, 14);
+    BF_ROUND(right, left, 15);
+
+    left ^= (uint32_t)ptable[ROUNDS];
+    right ^= (uint32_t)ptable[ROUNDS+1];
+
+    unsigned char * out = (unsigned char *)cyphertext;
+    Store_Big_Endian(out, right);
+    Store_Big_Endian(out + 4, left);
+}
+
+
+/**
+ *  A single round applied to four independent blocks, the halves of each
+ *  block are held in a0-a3 and b0-b3.
+ */
+#define BF_ROUND_X4(a, b, n) \
+    { \
+        const uint32_t p = (uint32_t)ptable[n]; \
+        a##0 ^= p; a##1 ^= p; a##2 ^= p; a##3 ^= p; \
+        b##0 ^= BF_F(a##0); b##1 ^= BF_F(a##1); b##2 ^= BF_F(a##2); b##3 ^= BF_F(a##3); \
     }
 
-    left.Long ^= *ptable++;
-    right.Long ^= *ptable;
 
-    unsigned char * out = (unsigned char *)cyphertext;
-    *out++ = right.Char.C0;
-    *out++ = right.Char.C1;
-    *out++ = right.Char.C2;
-    *out++ = right.Char.C3;
-
-    *out++ = left.Char.C0;
-    *out++ = left.Char.C1;
-    *out++ = left.Char.C2;
-    *out = left.Char.C3;
+/**
+ *  Processes a run of whole blocks. Blocks are processed four at a time: the
+ *  rounds of each block form one long dependency chain of S-Box lookups, so
+ *  interleaving four independent chains keeps the load units busy instead of
+ *  waiting on each lookup in turn. The remaining blocks go through the single
+ *  block path.
+ * 
+ *  Each group of blocks is read fully before any of it is written, so in-place
+ *  processing is safe.
+ */
+void BlowfishEngine::Process_Blocks(void const * plaintext, void * cyphertext, int blocks, unsigned long const * ptable)
+{
+    unsigned char const * source = (unsigned char const *)plaintext;
+    unsigned char * dest = (unsigned char *)cyphertext;
+
+    for (; blocks >= 4; blocks -= 4) {
+        uint32_t l0 = Load_Big_Endian(source + 0);
+        uint32_t r0 = Load_Big_Endian(source + 4);
+        uint32_t l1 = Load_Big_Endian(source + 8);
+        uint32_t r1 = Load_Big_Endian(source + 12);
+        uint32_t l2 = Load_Big_Endian(source + 16);
+        uint32_t r2 = Load_Big_Endian(source + 20);
+        uint32_t l3 = Load_Big_Endian(source + 24);
+        uint32_t r3 = Load_Big_Endian(source + 28);
+
+        BF_ROUND_X4(l, r, 0);
+        BF_ROUND_X4(r, l, 1);
+        BF_ROUND_X4(l, r, 2);
+        BF_ROUND_X4(r, l, 3);
+        BF_ROUND_X4(l, r, 4);
+        BF_ROUND_X4(r, l, 5);
+        BF_ROUND_X4(l, r, 6);
+        BF_ROUND_X4(r, l, 7);
+        BF_ROUND_X4(l, r, 8);
+        BF_ROUND_X4(r, l, 9);
+        BF_ROUND_X4(l, r, 10);
+        BF_ROUND_X4(r, l, 11);
+        BF_ROUND_X4(l, r, 12);
+        BF_ROUND_X4(r, l, 13);
+        BF_ROUND_X4(l, r, 14);
+        BF_ROUND_X4(r, l, 15);
+
+        const uint32_t p_left = (uint32_t)ptable[ROUNDS];
+        const uint32_t p_right = (uint32_t)ptable[ROUNDS+1];
+
+        Store_Big_Endian(dest + 0, r0 ^ p_right);
+        Store_Big_Endian(dest + 4, l0 ^ p_left);
+        Store_Big_Endian(dest + 8, r1 ^ p_right);
+        Store_Big_Endian(dest + 12, l1 ^ p_left);
+        Store_Big_Endian(dest + 16, r2 ^ p_right);
+        Store_Big_Endian(dest + 20, l2 ^ p_left);
+        Store_Big_Endian(dest + 24, r3 ^ p_right);
+        Store_Big_Endian(dest + 28, l3 ^ p_left);
+
+        source += BYTES_PER_BLOCK * 4;
+        dest += BYTES_PER_BLOCK * 4;
+    }
+
+    for (; blocks > 0; --blocks) {
+        Process_Block(source, dest, ptable);
+        source += BYTES_PER_BLOCK;
+        dest += BYTES_PER_BLOCK;
+    }
 }
 
+#undef BF_ROUND_X4
+#undef BF_ROUND
+#undef BF_F
+
 
 void BlowfishEngine::Sub_Key_Encrypt(unsigned long & left, unsigned long & right)
 {
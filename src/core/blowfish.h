@@ -48,6 +48,9 @@ class BlowfishEngine
         int Encrypt(void const * plaintext, int length, void * cyphertext);
         int Decrypt(void const * cyphertext, int length, void * plaintext);
 
+        void Encrypt_Blocks(void const * plaintext, void * cyphertext, int blocks);
+        void Decrypt_Blocks(void const * cyphertext, void * plaintext, int blocks);
+
         enum {
             DEF_KEY_LENGTH = 16,
             MIN_KEY_LENGTH = 4,
@@ -62,6 +65,7 @@ class BlowfishEngine
 
         void Sub_Key_Encrypt(unsigned long & left, unsigned long & right);
         void Process_Block(void const * plaintext, void * cyphertext, unsigned long const * ptable);
+        void Process_Blocks(void const * plaintext, void * cyphertext, int blocks, unsigned long const * ptable);
 
     private:
         static unsigned long const P_Init[(int)ROUNDS+2];
@@ -78,15 +78,25 @@ int BlowPipe::Put(const void * source, int slen)
         }
     }
 
-    while (slen >= sizeof(Buffer)) {
+    /**
+     *  Process whole block runs through a larger local buffer so the
+     *  downstream pipe receives one call per run instead of one per block.
+     */
+    char run[BLOCK_RUN_SIZE];
+
+    while (slen >= (int)sizeof(Buffer)) {
+        int runlen = (slen < (int)sizeof(run)) ? slen : (int)sizeof(run);
+        int blocks = runlen / (int)sizeof(Buffer);
+        runlen = blocks * (int)sizeof(Buffer);
+
         if (Control == DECRYPT) {
-            BF->Decrypt(source, sizeof(Buffer), Buffer);
+            BF->Decrypt_Blocks(source, run, blocks);
         } else {
-            BF->Encrypt(source, sizeof(Buffer), Buffer);
+            BF->Encrypt_Blocks(source, run, blocks);
         }
-        total += Pipe::Put(Buffer, sizeof(Buffer));
-        source = ((char *)source) + sizeof(Buffer);
-        slen -= sizeof(Buffer);
+        total += Pipe::Put(run, runlen);
+        source = ((char *)source) + runlen;
+        slen -= runlen;
     }
 
     if (slen > 0) {
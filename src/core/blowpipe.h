@@ -59,6 +59,10 @@ class BlowPipe : public Pipe
         BlowfishEngine * BF;
 
     private:
+        enum {
+            BLOCK_RUN_SIZE = 1024
+        };
+
         char Buffer[8];
         int Counter;
         CryptControl Control;
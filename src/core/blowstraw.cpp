@@ -60,6 +60,34 @@ int BlowStraw::Get(void * source, int slen)
         }
         if (slen == 0) break;
 
+        /**
+         *  Fast path; read any whole block run straight into the caller's
+         *  buffer and process it in place, skipping the staging buffer.
+         */
+        if (slen >= (int)sizeof(Buffer)) {
+            int runlen = slen - (slen % (int)sizeof(Buffer));
+            int incount = Straw::Get(source, runlen);
+            if (incount == 0) break;
+
+            int blocks = incount / (int)sizeof(Buffer);
+            if (Control == DECRYPT) {
+                BF->Decrypt_Blocks(source, source, blocks);
+            } else {
+                BF->Encrypt_Blocks(source, source, blocks);
+            }
+
+            source = ((char *)source) + incount;
+            slen -= incount;
+            total += incount;
+
+            /**
+             *  A short read means the end of the data was reached, the
+             *  trailing partial block is passed through as-is.
+             */
+            if (incount < runlen) break;
+            continue;
+        }
+
         int incount = Straw::Get(Buffer, sizeof(Buffer));
         if (incount == 0) break;
 
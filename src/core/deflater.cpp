@@ -0,0 +1,355 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          DEFLATER.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Streaming deflate compressor with a fixed memory footprint.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "deflater.h"
+#include <algorithm>
+#include <cstring>
+
+
+/**
+ *  The base value and number of extra bits of each length and distance code.
+ */
+static const int LengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const int LengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const int DistanceBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+static const int DistanceExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+
+static uint32_t Reverse_Bits(uint32_t code, int length)
+{
+    uint32_t result = 0;
+    for (int i = 0; i < length; ++i) {
+        result = (result << 1) | (code & 1);
+        code >>= 1;
+    }
+    return result;
+}
+
+
+/**
+ *  The fixed Huffman codes (RFC 1951 3.2.6), bit reversed as the codes are
+ *  packed starting from their most significant bit. The length and distance
+ *  code of every value are looked up rather than searched for.
+ */
+struct FixedCodesStruct
+{
+    FixedCodesStruct()
+    {
+        for (int symbol = 0; symbol < 288; ++symbol) {
+            uint32_t code;
+            int length;
+            if (symbol < 144) {
+                code = 0x30 + symbol;
+                length = 8;
+            } else if (symbol < 256) {
+                code = 0x190 + (symbol - 144);
+                length = 9;
+            } else if (symbol < 280) {
+                code = symbol - 256;
+                length = 7;
+            } else {
+                code = 0xC0 + (symbol - 280);
+                length = 8;
+            }
+            Code[symbol] = Reverse_Bits(code, length);
+            Length[symbol] = length;
+        }
+
+        for (int code = 0; code < 30; ++code) {
+            DistanceCode[code] = Reverse_Bits(code, 5);
+        }
+
+        for (int length = 3; length <= 258; ++length) {
+            int code = 28;
+            while (LengthBase[code] > length) {
+                --code;
+            }
+            LengthCode[length] = code;
+        }
+    }
+
+    uint32_t Code[288];
+    int Length[288];
+    uint32_t DistanceCode[30];
+    int LengthCode[259];
+};
+
+static const FixedCodesStruct FixedCodes;
+
+
+DeflaterClass::DeflaterClass(OutputFunc output, void *param) :
+    Output(output),
+    Param(param),
+    Failed(false),
+    Position(0),
+    Lookahead(0),
+    BitBuffer(0),
+    BitCount(0),
+    BufferCount(0)
+{
+    std::fill(Head, Head + HASH_SIZE, -1);
+    std::fill(Prev, Prev + WINDOW_SIZE, -1);
+
+    /**
+     *  The stream is one block using the fixed codes, the final (empty) block
+     *  is added when the stream is finished.
+     */
+    Put_Bits(0, 1);
+    Put_Bits(1, 2);
+}
+
+
+/**
+ *  Adds data to the stream. Output is produced once enough input has been
+ *  gathered to search for matches.
+ *
+ *  @author: agent
+ */
+bool DeflaterClass::Write(const void *data, int length)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+
+    while (length > 0 && !Failed) {
+
+        if (Position + Lookahead == WINDOW_SIZE*2) {
+            Compress(false);
+            Slide_Window();
+        }
+
+        int count = std::min(WINDOW_SIZE*2 - (Position + Lookahead), length);
+        std::memcpy(&Window[Position + Lookahead], bytes, count);
+
+        Lookahead += count;
+        bytes += count;
+        length -= count;
+    }
+
+    return !Failed;
+}
+
+
+/**
+ *  Compresses the remaining input and ends the stream.
+ *
+ *  @author: agent
+ */
+bool DeflaterClass::Finish()
+{
+    Compress(true);
+
+    /**
+     *  End the block, then add an empty final block.
+     */
+    Put_Code(256);
+    Put_Bits(1, 1);
+    Put_Bits(1, 2);
+    Put_Code(256);
+
+    if (BitCount > 0) {
+        Put_Bits(0, 8 - BitCount);
+    }
+
+    Flush_Output();
+
+    return !Failed;
+}
+
+
+/**
+ *  Encodes the input, keeping enough back for the longest match unless the
+ *  stream is being flushed.
+ */
+void DeflaterClass::Compress(bool flush)
+{
+    while (!Failed && (Lookahead >= MIN_LOOKAHEAD || (flush && Lookahead > 0))) {
+
+        int length = 0;
+        int distance = 0;
+
+        if (Lookahead >= MIN_MATCH) {
+            length = Longest_Match(distance);
+            Insert_Hash(Position);
+        }
+
+        if (length >= MIN_MATCH) {
+            Put_Match(length, distance);
+            for (int i = 1; i < length; ++i) {
+                if (Lookahead - i >= MIN_MATCH) {
+                    Insert_Hash(Position + i);
+                }
+            }
+            Position += length;
+            Lookahead -= length;
+
+        } else {
+            Put_Literal(Window[Position]);
+            ++Position;
+            --Lookahead;
+        }
+    }
+}
+
+
+/**
+ *  Moves the upper half of the window down, so there is room for more input.
+ */
+void DeflaterClass::Slide_Window()
+{
+    std::memmove(&Window[0], &Window[WINDOW_SIZE], WINDOW_SIZE);
+    Position -= WINDOW_SIZE;
+
+    for (int &head : Head) {
+        head = head >= WINDOW_SIZE ? head - WINDOW_SIZE : -1;
+    }
+    for (int &prev : Prev) {
+        prev = prev >= WINDOW_SIZE ? prev - WINDOW_SIZE : -1;
+    }
+}
+
+
+void DeflaterClass::Insert_Hash(int position)
+{
+    int hash = ((Window[position] << 10) ^ (Window[position+1] << 5) ^ Window[position+2]) & HASH_MASK;
+    Prev[position & WINDOW_MASK] = Head[hash];
+    Head[hash] = position;
+}
+
+
+/**
+ *  Walks the hash chain for the current position, returning the length of
+ *  the longest match found (zero if none).
+ */
+int DeflaterClass::Longest_Match(int &distance) const
+{
+    int hash = ((Window[Position] << 10) ^ (Window[Position+1] << 5) ^ Window[Position+2]) & HASH_MASK;
+    int candidate = Head[hash];
+
+    const int limit = Position - MAX_DISTANCE;
+    const int max_length = std::min((int)MAX_MATCH, Lookahead);
+    const unsigned char *current = &Window[Position];
+
+    int best = 0;
+
+    for (int chain = 0; chain < MAX_CHAIN && candidate >= 0 && candidate >= limit; ++chain) {
+
+        const unsigned char *match = &Window[candidate];
+
+        if (match[best] == current[best] && match[0] == current[0]) {
+            int length = 0;
+            while (length < max_length && match[length] == current[length]) {
+                ++length;
+            }
+            if (length > best) {
+                best = length;
+                distance = Position - candidate;
+                if (best == max_length) {
+                    break;
+                }
+            }
+        }
+
+        int next = Prev[candidate & WINDOW_MASK];
+        if (next >= candidate) {
+            break;
+        }
+        candidate = next;
+    }
+
+    return best;
+}
+
+
+void DeflaterClass::Put_Literal(int value)
+{
+    Put_Code(value);
+}
+
+
+void DeflaterClass::Put_Match(int length, int distance)
+{
+    int code = FixedCodes.LengthCode[length];
+    Put_Code(257 + code);
+    Put_Bits(length - LengthBase[code], LengthExtra[code]);
+
+    code = 29;
+    while (DistanceBase[code] > distance) {
+        --code;
+    }
+    Put_Bits(FixedCodes.DistanceCode[code], 5);
+    Put_Bits(distance - DistanceBase[code], DistanceExtra[code]);
+}
+
+
+void DeflaterClass::Put_Code(int symbol)
+{
+    Put_Bits(FixedCodes.Code[symbol], FixedCodes.Length[symbol]);
+}
+
+
+void DeflaterClass::Put_Bits(uint32_t value, int count)
+{
+    BitBuffer |= value << BitCount;
+    BitCount += count;
+
+    while (BitCount >= 8) {
+        Buffer[BufferCount++] = (unsigned char)BitBuffer;
+        BitBuffer >>= 8;
+        BitCount -= 8;
+
+        if (BufferCount == OUTPUT_SIZE) {
+            Flush_Output();
+        }
+    }
+}
+
+
+bool DeflaterClass::Flush_Output()
+{
+    if (BufferCount > 0 && !Failed) {
+        if (!Output(Param, Buffer, BufferCount)) {
+            Failed = true;
+        }
+    }
+    BufferCount = 0;
+
+    return !Failed;
+}
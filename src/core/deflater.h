@@ -0,0 +1,109 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          DEFLATER.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Streaming deflate compressor with a fixed memory footprint.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+
+
+/**
+ *  Compresses a stream of any length into raw deflate data (RFC 1951), as used
+ *  by zip archives. The input is fed in pieces of any size and the output is
+ *  passed to the callback as it is produced, so memory use is fixed at the
+ *  size of this object regardless of the stream length.
+ *
+ *  Matches are found with hash chains over a 32KB window and encoded with the
+ *  fixed Huffman codes, trading a little ratio for speed and simplicity.
+ */
+class DeflaterClass
+{
+    public:
+        /**
+         *  Receives compressed output, returns false to abort the stream.
+         */
+        typedef bool (*OutputFunc)(void *param, const void *data, int length);
+
+        DeflaterClass(OutputFunc output, void *param);
+
+        bool Write(const void *data, int length);
+        bool Finish();
+
+    private:
+        enum {
+            WINDOW_SIZE = 32768,
+            WINDOW_MASK = WINDOW_SIZE-1,
+            HASH_SIZE = 32768,
+            HASH_MASK = HASH_SIZE-1,
+            MIN_MATCH = 3,
+            MAX_MATCH = 258,
+            MIN_LOOKAHEAD = MAX_MATCH+MIN_MATCH+1,
+            MAX_DISTANCE = WINDOW_SIZE-MIN_LOOKAHEAD,
+            MAX_CHAIN = 32,
+            OUTPUT_SIZE = 16384,
+        };
+
+        void Compress(bool flush);
+        void Slide_Window();
+        void Insert_Hash(int position);
+        int Longest_Match(int &distance) const;
+
+        void Put_Literal(int value);
+        void Put_Match(int length, int distance);
+        void Put_Bits(uint32_t value, int count);
+        void Put_Code(int symbol);
+        bool Flush_Output();
+
+    private:
+        OutputFunc Output;
+        void *Param;
+
+        /**
+         *  Set if the output callback failed, the rest of the stream is dropped.
+         */
+        bool Failed;
+
+        /**
+         *  The input, holding the previous 32KB for matches as well as the
+         *  bytes still to be compressed.
+         */
+        unsigned char Window[WINDOW_SIZE*2];
+        int Position;
+        int Lookahead;
+
+        /**
+         *  The most recent position of each hash and the previous position
+         *  with the same hash, for each position in the window. -1 is empty.
+         */
+        int Head[HASH_SIZE];
+        int Prev[WINDOW_SIZE];
+
+        uint32_t BitBuffer;
+        int BitCount;
+
+        unsigned char Buffer[OUTPUT_SIZE];
+        int BufferCount;
+};
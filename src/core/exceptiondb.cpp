@@ -0,0 +1,440 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          EXCEPTIONDB.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         The exception database, in its text and compiled forms.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "exceptiondb.h"
+#include "debughandler.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+
+/**
+ *  The longest line the text form may have: address, end address, bool, bool
+ *  and the description.
+ */
+#define EXCEPTION_DATABASE_LINE_MAX (11 + 1 + 11 + 2 + 2 + 1024)
+
+
+/**
+ *  The sizes of the compiled header and entries, in 32-bit words.
+ */
+#define EXCEPTION_DATABASE_HEADER_WORDS 5
+#define EXCEPTION_DATABASE_ENTRY_WORDS  4
+
+
+/**
+ *  The compiled form is stored little endian regardless of the host.
+ */
+static uint32_t Read_Word(const unsigned char *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+
+static void Write_Word(std::vector<unsigned char> &buffer, uint32_t value)
+{
+    buffer.push_back((unsigned char)(value));
+    buffer.push_back((unsigned char)(value >> 8));
+    buffer.push_back((unsigned char)(value >> 16));
+    buffer.push_back((unsigned char)(value >> 24));
+}
+
+
+/**
+ *  Sort predicate for the exception database, orders the entries by their
+ *  start address.
+ */
+static bool Exception_Database_Sort(const ExceptionInfoDatabaseStruct &a, const ExceptionInfoDatabaseStruct &b)
+{
+    return a.Address < b.Address;
+}
+
+
+/**
+ *  Empties the database.
+ *
+ *  @author: agent
+ */
+void ExceptionDatabaseClass::Clear()
+{
+    Entries.clear();
+    Descriptions.clear();
+    MaxRange = 0;
+}
+
+
+/**
+ *  Returns true if the data is a compiled database.
+ *
+ *  @author: agent
+ */
+bool ExceptionDatabaseClass::Is_Compiled(const void *data, int length)
+{
+    return data && length >= 4 && Read_Word((const unsigned char *)data) == EXCEPTION_DATABASE_ID;
+}
+
+
+/**
+ *  Loads the database from either form.
+ *
+ *  @author: agent
+ */
+bool ExceptionDatabaseClass::Load(const void *data, int length)
+{
+    if (Is_Compiled(data, length)) {
+        return Load_Compiled(data, length);
+    }
+    return Load_Text((const char *)data, length);
+}
+
+
+/**
+ *  Parses the text form into an address sorted table. Identical descriptions
+ *  are interned into a single pool rather than each entry holding its own copy.
+ *
+ *  @author: agent
+ */
+bool ExceptionDatabaseClass::Load_Text(const char *text, int length)
+{
+    Clear();
+
+    if (!text || length <= 0) {
+        return false;
+    }
+
+    /**
+     *  While loading, the descriptions are referenced by their offset into
+     *  the pool as the pool may grow. The pointers are fixed up at the end.
+     */
+    std::vector<uint32_t> offsets;
+    std::unordered_map<std::string, uint32_t> interned;
+
+    const char *end = text + length;
+    const char *line = text;
+
+    char line_buffer[EXCEPTION_DATABASE_LINE_MAX];
+
+    while (line < end) {
+
+        const char *line_end = (const char *)std::memchr(line, '\n', end - line);
+        if (!line_end) {
+            line_end = end;
+        }
+
+        int count = (int)(line_end - line);
+        const char *next = line_end < end ? line_end + 1 : end;
+
+        /**
+         *  Handle invalid line cases.
+         */
+        if (count >= (int)sizeof(line_buffer)) {
+            break;
+        }
+
+        std::memcpy(line_buffer, line, count);
+        while (count > 0 && line_buffer[count-1] == '\r') {
+            --count;
+        }
+        line_buffer[count] = '\0';
+        line = next;
+
+        char *cursor = line_buffer;
+
+        /**
+         *  Step over any indenting.
+         */
+        while (std::isspace((unsigned char)*cursor)) {
+            ++cursor;
+        }
+
+        /**
+         *  Handle commented out lines.
+         */
+        if (*cursor == ';' || *cursor == '\0') {
+            continue;
+        }
+
+        /**
+         *  Process the database line.
+         */
+        ExceptionInfoDatabaseStruct einfo;
+
+        if (cursor[0] != '0' || cursor[1] != 'x') {
+            DEBUG_WARNING("Invalid address format in exception database!\n");
+            Clear();
+            return false;
+        }
+        einfo.Address = std::strtoul(cursor+2, &cursor, 16);
+        einfo.EndAddress = einfo.Address;
+
+        if (*cursor == '-') {
+            ++cursor;
+            if (cursor[0] != '0' || cursor[1] != 'x') {
+                DEBUG_WARNING("Invalid address range format in exception database!\n");
+                Clear();
+                return false;
+            }
+            einfo.EndAddress = std::strtoul(cursor+2, &cursor, 16);
+            if (einfo.EndAddress < einfo.Address) {
+                DEBUG_WARNING("Invalid address range 0x%08X-0x%08X in exception database!\n", einfo.Address, einfo.EndAddress);
+                Clear();
+                return false;
+            }
+        }
+
+        cursor = std::strchr(cursor, ',');
+        if (!cursor) {
+            DEBUG_WARNING("Missing fields for 0x%08X in exception database!\n", einfo.Address);
+            continue;
+        }
+        einfo.CanContinue = std::strtoul(cursor+1, &cursor, 10) ? true : false;
+
+        cursor = std::strchr(cursor, ',');
+        if (!cursor) {
+            DEBUG_WARNING("Missing fields for 0x%08X in exception database!\n", einfo.Address);
+            continue;
+        }
+        einfo.Ignore = std::strtoul(cursor+1, &cursor, 10) ? true : false;
+
+        /**
+         *  The description is the remainder of the line.
+         */
+        cursor = std::strchr(cursor, ',');
+        if (!cursor) {
+            DEBUG_WARNING("Missing fields for 0x%08X in exception database!\n", einfo.Address);
+            continue;
+        }
+        std::string desc(cursor+1);
+
+        auto it = interned.find(desc);
+        if (it == interned.end()) {
+            it = interned.emplace(desc, (uint32_t)Descriptions.size()).first;
+            Descriptions.append(desc);
+            Descriptions.push_back('\0');
+        }
+
+        Entries.push_back(einfo);
+        offsets.push_back(it->second);
+    }
+
+    if (Entries.empty()) {
+        DEBUG_WARNING("Invalid format in exception database!\n");
+        Clear();
+        return false;
+    }
+
+    Finish(offsets);
+
+    return true;
+}
+
+
+/**
+ *  Loads the compiled form. Every offset and size is checked against the data,
+ *  as is the order of the entries, so a truncated or corrupt file is rejected
+ *  rather than read out of bounds.
+ *
+ *  @author: agent
+ */
+bool ExceptionDatabaseClass::Load_Compiled(const void *data, int length)
+{
+    Clear();
+
+    const unsigned char *bytes = (const unsigned char *)data;
+
+    if (!bytes || length < EXCEPTION_DATABASE_HEADER_WORDS * 4) {
+        DEBUG_WARNING("Compiled exception database is truncated!\n");
+        return false;
+    }
+
+    if (Read_Word(&bytes[0]) != EXCEPTION_DATABASE_ID || Read_Word(&bytes[4]) != EXCEPTION_DATABASE_VERSION) {
+        DEBUG_WARNING("Compiled exception database has an unknown version!\n");
+        return false;
+    }
+
+    uint32_t count = Read_Word(&bytes[8]);
+    uint32_t pool_size = Read_Word(&bytes[12]);
+
+    uint64_t expected = (uint64_t)EXCEPTION_DATABASE_HEADER_WORDS * 4 + (uint64_t)count * EXCEPTION_DATABASE_ENTRY_WORDS * 4 + pool_size;
+    if (!count || !pool_size || expected != (uint64_t)length) {
+        DEBUG_WARNING("Compiled exception database has an invalid size!\n");
+        return false;
+    }
+
+    const unsigned char *entry_data = &bytes[EXCEPTION_DATABASE_HEADER_WORDS * 4];
+    const char *pool = (const char *)&entry_data[count * EXCEPTION_DATABASE_ENTRY_WORDS * 4];
+
+    if (pool[pool_size-1] != '\0') {
+        DEBUG_WARNING("Compiled exception database has an unterminated description!\n");
+        return false;
+    }
+
+    Descriptions.assign(pool, pool_size);
+
+    std::vector<uint32_t> offsets;
+    offsets.reserve(count);
+    Entries.reserve(count);
+
+    for (uint32_t index = 0; index < count; ++index) {
+        const unsigned char *entry = &entry_data[index * EXCEPTION_DATABASE_ENTRY_WORDS * 4];
+
+        ExceptionInfoDatabaseStruct einfo;
+        einfo.Address = Read_Word(&entry[0]);
+        einfo.EndAddress = Read_Word(&entry[4]);
+        uint32_t flags = Read_Word(&entry[8]);
+        uint32_t offset = Read_Word(&entry[12]);
+
+        einfo.CanContinue = (flags & 1) != 0;
+        einfo.Ignore = (flags & 2) != 0;
+
+        if (einfo.EndAddress < einfo.Address || offset >= pool_size
+         || (index > 0 && einfo.Address < Entries.back().Address)) {
+            DEBUG_WARNING("Compiled exception database has an invalid entry!\n");
+            Clear();
+            return false;
+        }
+
+        Entries.push_back(einfo);
+        offsets.push_back(offset);
+    }
+
+    Finish(offsets);
+
+    if (MaxRange != Read_Word(&bytes[16])) {
+        DEBUG_WARNING("Compiled exception database has an invalid range!\n");
+        Clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ *  Writes the database in its compiled form.
+ *
+ *  @author: agent
+ */
+void ExceptionDatabaseClass::Save_Compiled(std::vector<unsigned char> &buffer) const
+{
+    buffer.clear();
+    buffer.reserve(EXCEPTION_DATABASE_HEADER_WORDS * 4 + Entries.size() * EXCEPTION_DATABASE_ENTRY_WORDS * 4 + Descriptions.size());
+
+    Write_Word(buffer, EXCEPTION_DATABASE_ID);
+    Write_Word(buffer, EXCEPTION_DATABASE_VERSION);
+    Write_Word(buffer, (uint32_t)Entries.size());
+    Write_Word(buffer, (uint32_t)Descriptions.size());
+    Write_Word(buffer, MaxRange);
+
+    for (const ExceptionInfoDatabaseStruct &einfo : Entries) {
+        Write_Word(buffer, einfo.Address);
+        Write_Word(buffer, einfo.EndAddress);
+        Write_Word(buffer, (einfo.CanContinue ? 1 : 0) | (einfo.Ignore ? 2 : 0));
+        Write_Word(buffer, (uint32_t)(einfo.Description - Descriptions.data()));
+    }
+
+    buffer.insert(buffer.end(), Descriptions.begin(), Descriptions.end());
+}
+
+
+/**
+ *  Finds the entry for the address. The closest start address at or before
+ *  the address wins, and ties go to the first entry listed.
+ *
+ *  @author: agent
+ */
+const ExceptionInfoDatabaseStruct *ExceptionDatabaseClass::Find(uint32_t address) const
+{
+    int count = Count();
+    if (!count) {
+        return nullptr;
+    }
+
+    /**
+     *  Find the first entry starting after the address.
+     */
+    int low = 0;
+    int high = count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (Entries[mid].Address <= address) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    const ExceptionInfoDatabaseStruct *found = nullptr;
+
+    for (int i = low-1; i >= 0; --i) {
+        const ExceptionInfoDatabaseStruct &entry = Entries[i];
+        if ((address - entry.Address) > MaxRange) {
+            break;
+        }
+        if (found && found->Address != entry.Address) {
+            break;
+        }
+        if (address <= entry.EndAddress) {
+            found = &entry;
+        }
+    }
+
+    return found;
+}
+
+
+/**
+ *  Returns the number of unique descriptions in the pool.
+ *
+ *  @author: agent
+ */
+int ExceptionDatabaseClass::Description_Count() const
+{
+    return (int)std::count(Descriptions.begin(), Descriptions.end(), '\0');
+}
+
+
+/**
+ *  Points the entries at their descriptions and sorts them by address, keeping
+ *  the file order of entries with the same start address so the first one
+ *  listed still takes priority.
+ *
+ *  @author: agent
+ */
+void ExceptionDatabaseClass::Finish(std::vector<uint32_t> &offsets)
+{
+    MaxRange = 0;
+
+    for (size_t i = 0; i < Entries.size(); ++i) {
+        Entries[i].Description = Descriptions.data() + offsets[i];
+        MaxRange = std::max(MaxRange, Entries[i].EndAddress - Entries[i].Address);
+    }
+
+    std::stable_sort(Entries.begin(), Entries.end(), Exception_Database_Sort);
+}
@@ -0,0 +1,127 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          EXCEPTIONDB.H
+ *
+ *  @author        agent
+ *
+ *  @brief         The exception database, in its text and compiled forms.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+#include <string>
+#include <vector>
+
+
+/**
+ *  Identifies a compiled exception database and its layout.
+ */
+#define EXCEPTION_DATABASE_ID       0x42444556 // "VEDB"
+#define EXCEPTION_DATABASE_VERSION  1
+
+
+/**
+ *  Definition for the exception database struct. If you update this
+ *  struct, make sure you check if you need to update the exception handler.
+ *
+ *  Entries cover the inclusive address range [Address, EndAddress] and are
+ *  kept sorted by their start address. The description points into the
+ *  shared (interned) description pool.
+ */
+struct ExceptionInfoDatabaseStruct
+{
+    ExceptionInfoDatabaseStruct() :
+        Address(0x00000000),
+        EndAddress(0x00000000),
+        CanContinue(false),
+        Ignore(false),
+        Description(nullptr)
+    {
+    }
+
+    uint32_t Address;
+    uint32_t EndAddress;
+    bool CanContinue;
+    bool Ignore;
+    const char *Description;
+};
+
+
+/**
+ *  The loaded exception database.
+ *
+ *  The text form has one entry per line, "0xADDRESS,continue,ignore,description"
+ *  where the address may also be a range "0xSTART-0xEND" and lines starting
+ *  with ';' are comments. The compiled form is the sorted table and the
+ *  description pool as written by Save_Compiled, so it can be loaded without
+ *  parsing or sorting.
+ *
+ *  A failed load always leaves the database empty.
+ */
+class ExceptionDatabaseClass
+{
+    public:
+        ExceptionDatabaseClass() : Entries(), Descriptions(), MaxRange(0) {}
+
+        /**
+         *  The entries point into the pool, so the database can not be copied.
+         */
+        ExceptionDatabaseClass(const ExceptionDatabaseClass &) = delete;
+        ExceptionDatabaseClass &operator=(const ExceptionDatabaseClass &) = delete;
+
+        void Clear();
+
+        bool Load(const void *data, int length);
+        bool Load_Text(const char *text, int length);
+        bool Load_Compiled(const void *data, int length);
+        void Save_Compiled(std::vector<unsigned char> &buffer) const;
+
+        const ExceptionInfoDatabaseStruct *Find(uint32_t address) const;
+
+        int Count() const { return (int)Entries.size(); }
+        const ExceptionInfoDatabaseStruct &operator[](int index) const { return Entries[index]; }
+
+        int Description_Count() const;
+        uint32_t Max_Range() const { return MaxRange; }
+
+        static bool Is_Compiled(const void *data, int length);
+
+    private:
+        void Finish(std::vector<uint32_t> &offsets);
+
+    private:
+        /**
+         *  The entries, sorted by their start address.
+         */
+        std::vector<ExceptionInfoDatabaseStruct> Entries;
+
+        /**
+         *  The pool of unique, null terminated descriptions.
+         */
+        std::string Descriptions;
+
+        /**
+         *  The widest address range of any entry, this bounds how far the
+         *  lookup needs to step back from the closest start address.
+         */
+        uint32_t MaxRange;
+};
@@ -113,6 +113,83 @@ bool Write_PNG_File(FileClass *name, Surface &pic, const PaletteClass *palette,
 }
 
 
+/**
+ *  Per channel lookup tables for converting 24bit RGB to the current 16bit
+ *  pixel format. The tables are rebuilt if the pixel format changes.
+ */
+static unsigned short PNGRedTable[256];
+static unsigned short PNGGreenTable[256];
+static unsigned short PNGBlueTable[256];
+static unsigned PNGTableCheck = 0;
+static bool PNGTablesBuilt = false;
+
+
+/**
+ *  Builds (or validates) the channel lookup tables. Each channel occupies its
+ *  own bits of the pixel, so a pixel is the combination of the three entries.
+ * 
+ *  @author: agent
+ */
+static void PNG_Build_Pixel_Tables()
+{
+    unsigned check = DSurface::RGB_To_Pixel(255, 128, 64);
+    if (PNGTablesBuilt && check == PNGTableCheck) {
+        return;
+    }
+
+    for (int i = 0; i < 256; ++i) {
+        PNGRedTable[i] = (unsigned short)DSurface::RGB_To_Pixel(i, 0, 0);
+        PNGGreenTable[i] = (unsigned short)DSurface::RGB_To_Pixel(0, i, 0);
+        PNGBlueTable[i] = (unsigned short)DSurface::RGB_To_Pixel(0, 0, i);
+    }
+
+    PNGTableCheck = check;
+    PNGTablesBuilt = true;
+}
+
+
+/**
+ *  Converts a row of 24bit RGB pixels to the 16bit pixel format.
+ * 
+ *  @author: agent
+ */
+static void PNG_Convert_Row(unsigned short *dst, const unsigned char *src, int width)
+{
+    int x = 0;
+
+    for (; x + 4 <= width; x += 4, src += 12) {
+        dst[x+0] = PNGRedTable[src[0]] | PNGGreenTable[src[1]] | PNGBlueTable[src[2]];
+        dst[x+1] = PNGRedTable[src[3]] | PNGGreenTable[src[4]] | PNGBlueTable[src[5]];
+        dst[x+2] = PNGRedTable[src[6]] | PNGGreenTable[src[7]] | PNGBlueTable[src[8]];
+        dst[x+3] = PNGRedTable[src[9]] | PNGGreenTable[src[10]] | PNGBlueTable[src[11]];
+    }
+
+    for (; x < width; ++x, src += 3) {
+        dst[x] = PNGRedTable[src[0]] | PNGGreenTable[src[1]] | PNGBlueTable[src[2]];
+    }
+}
+
+
+/**
+ *  Copies a decoded 24bit RGB image into a 16bit graphic surface.
+ * 
+ *  @author: agent
+ */
+static void PNG_Copy_To_Surface(BSurface *pic, const unsigned char *image)
+{
+    PNG_Build_Pixel_Tables();
+
+    int width = pic->Get_Width();
+
+    for (int y = 0; y < pic->Get_Height(); ++y) {
+        unsigned short *buffptr = (unsigned short *)pic->Lock(0, y);
+        PNG_Convert_Row(buffptr, image, width);
+        pic->Unlock();
+        image += width * 3;
+    }
+}
+
+
 /** 
  *  Read the contents of a PNG file into a graphic surface.
  * 
@@ -122,7 +199,6 @@ BSurface *Read_PNG_File(FileClass *name, unsigned char *palette, void *buff, lon
 {
     ASSERT(name != nullptr);
 
-    LodePNGState state;
     BSurface *pic = nullptr;
 
     unsigned char *png_image = nullptr;     // Output png image.
@@ -150,66 +226,36 @@ BSurface *Read_PNG_File(FileClass *name, unsigned char *palette, void *buff, lon
     png_buffer = (unsigned char *)std::malloc(png_buffersize);
     if (!png_buffer) {
         DEBUG_ERROR("Read_PNG_File() - Failed to allocate PNG buffer!\n");
+        if (file_opened) {
+            name->Close();
+        }
         return nullptr;
     }
 
-    if (!name->Read(png_buffer, png_buffersize)) {
-        DEBUG_ERROR("Read_PNG_File() - Failed to read PNG file!\n");
+    long read = name->Read(png_buffer, png_buffersize);
 
-        //delete [] png_buffer;
-        std::free(png_buffer);
-
-        return nullptr;
+    if (file_opened) {
+        name->Close();
     }
 
-    lodepng_state_init(&state);
-
-    state.info_raw.colortype = LCT_RGB;
-    state.info_raw.bitdepth = 8;
-    state.decoder.color_convert = false;
-
-    /**
-     *  Decode the PNG data.
-     */
-    unsigned error = lodepng_decode(&png_image, &png_width, &png_height, &state, png_buffer, png_buffersize);
-    if (!png_image || error) {
-        DEBUG_ERROR("Read_PNG_File() - Failed to decode PNG data!\n");
-    
-        lodepng_state_cleanup(&state);
-    
-        //delete [] png_buffer;
+    if (!read) {
+        DEBUG_ERROR("Read_PNG_File() - Failed to read PNG file!\n");
         std::free(png_buffer);
-        std::free(png_image);
-    
         return nullptr;
     }
 
     /**
-     *  We only support standard 8bit PNG RGB, report error otherwise.
+     *  Decode the PNG data, we only support standard 8bit PNG RGB.
      */
-    if (state.info_raw.bitdepth == 16
-     || state.info_raw.colortype == LCT_GREY
-     || state.info_raw.colortype == LCT_PALETTE
-     || state.info_raw.colortype == LCT_GREY_ALPHA
-     || state.info_raw.colortype == LCT_RGBA) {
+    png_image = Decode_PNG_Data(png_buffer, png_buffersize, png_width, png_height);
 
-        DEBUG_ERROR("Read_PNG_File() - Unsupported PNG format type!\n");
+    std::free(png_buffer);
 
-        lodepng_state_cleanup(&state);
-    
-        //delete [] png_buffer;
-        std::free(png_buffer);
-        std::free(png_image);
-    
+    if (!png_image) {
+        DEBUG_ERROR("Read_PNG_File() - Failed to decode PNG data or unsupported PNG format type!\n");
         return nullptr;
     }
 
-
-#ifndef NDEBUG
-    DEBUG_INFO("Read_PNG_File() - bitdepth: %d, colortype: %d.\n",
-        state.info_raw.bitdepth, state.info_raw.colortype);
-#endif
-
     if (buff) {
         Buffer b(buff, size);
         pic = new BSurface(png_width, png_height, 2, b);
@@ -218,34 +264,12 @@ BSurface *Read_PNG_File(FileClass *name, unsigned char *palette, void *buff, lon
     }
     ASSERT(pic != nullptr);
 
-    //size_t buffersize = lodepng_get_raw_size(png_width, png_height, &state.info_raw);
-    //ASSERT(buffersize == (png_width * png_height));
-
     /**
      *  Copy the decoded PNG data into the image surface.
      */
-    for (int y = 0; y < pic->Get_Height(); ++y) {
-    
-        unsigned short *buffptr = (unsigned short *)pic->Lock(0, y);
-        for (int x = 0; x < pic->Get_Width(); ++x) {
-    
-            int r = *png_image++; // & 0xFF;
-            int g = *png_image++; // & 0xFF;
-            int b = *png_image++; // & 0xFF;
-    
-            *buffptr++ = DSurface::RGB_To_Pixel(r, g, b);
-        }
-    
-        pic->Unlock();
-    }
+    PNG_Copy_To_Surface(pic, png_image);
 
-    std::free(png_buffer);
-
-    lodepng_state_cleanup(&state);
-
-    if (file_opened) {
-        name->Close();
-    }
+    std::free(png_image);
 
     return pic;
 }
@@ -260,3 +284,64 @@ BSurface *Read_PNG_File(FileClass *name, const Buffer &buff, PaletteClass *palet
 {
     return Read_PNG_File(name, (unsigned char *)palette, buff.Get_Buffer(), buff.Get_Size());
 }
+
+
+
+/** 
+ *  Decodes PNG data held in memory to 24bit RGB. This does not touch any game
+ *  state, so it is safe to call from worker threads.
+ * 
+ *  @return      The decoded image, which must be released with std::free, or
+ *               NULL if the data could not be decoded or is of an unsupported format.
+ * 
+ *  @author: agent
+ */
+unsigned char *Decode_PNG_Data(const void *data, size_t size, unsigned &width, unsigned &height)
+{
+    LodePNGState state;
+    unsigned char *png_image = nullptr;
+
+    lodepng_state_init(&state);
+
+    state.info_raw.colortype = LCT_RGB;
+    state.info_raw.bitdepth = 8;
+    state.decoder.color_convert = false;
+
+    unsigned error = lodepng_decode(&png_image, &width, &height, &state, (const unsigned char *)data, size);
+    if (!png_image || error) {
+        lodepng_state_cleanup(&state);
+        std::free(png_image);
+        return nullptr;
+    }
+
+    /**
+     *  We only support standard 8bit PNG RGB, same as Read_PNG_File.
+     */
+    if (state.info_raw.bitdepth != 8 || state.info_raw.colortype != LCT_RGB) {
+        lodepng_state_cleanup(&state);
+        std::free(png_image);
+        return nullptr;
+    }
+
+    lodepng_state_cleanup(&state);
+
+    return png_image;
+}
+
+
+/** 
+ *  Creates a graphic surface from a decoded 24bit RGB image.
+ * 
+ *  @author: agent
+ */
+BSurface *Create_PNG_Surface(const unsigned char *image, unsigned width, unsigned height)
+{
+    ASSERT(image != nullptr);
+
+    BSurface *pic = new BSurface(width, height, 2);
+    ASSERT(pic != nullptr);
+
+    PNG_Copy_To_Surface(pic, image);
+
+    return pic;
+}
@@ -40,3 +40,6 @@ class PaletteClass;
 bool Write_PNG_File(FileClass *name, Surface &pic, const PaletteClass *palette, bool greyscale = false);
 BSurface *Read_PNG_File(FileClass *name, unsigned char *palette = nullptr, void *buff = nullptr, long size = 0);
 BSurface *Read_PNG_File(FileClass *name, const Buffer &buff, PaletteClass *palette = nullptr);
+
+unsigned char *Decode_PNG_Data(const void *data, size_t size, unsigned &width, unsigned &height);
+BSurface *Create_PNG_Surface(const unsigned char *image, unsigned width, unsigned height);
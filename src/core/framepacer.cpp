@@ -0,0 +1,273 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          FRAMEPACER.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         High resolution frame pacing and frame time statistics.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "framepacer.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <mmsystem.h>
+#endif
+
+
+typedef std::chrono::steady_clock FramePacerClock;
+
+
+/**
+ *  The length of the coarse sleep used while a lot of the frame remains.
+ */
+static const std::chrono::microseconds FramePacerSleepStep(1000);
+
+/**
+ *  The starting estimate of how far a coarse sleep overshoots its request.
+ *  This is refined from the observed sleeps as the pacer runs.
+ */
+static const double FramePacerInitialOvershoot = 1.0;
+
+static FramePacerClock::time_point FramePacerDeadline;
+static bool FramePacerDeadlineValid = false;
+static double FramePacerOvershoot = FramePacerInitialOvershoot;
+#ifdef _WIN32
+static bool FramePacerTimerPeriodSet = false;
+#endif
+
+static FramePacerClock::time_point FramePacerLastMark;
+static bool FramePacerLastMarkValid = false;
+static float FramePacerHistory[FRAME_PACER_HISTORY_MAX];
+static int FramePacerHistoryHead = 0;
+static int FramePacerHistoryCount = 0;
+
+
+/**
+ *  Converts a clock duration to milliseconds.
+ */
+static double Frame_Pacer_Milliseconds(FramePacerClock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+
+/**
+ *  The share of the estimate kept on each wait, so an estimate left high by a
+ *  slow sleep falls back even while no coarse sleeps are being made.
+ */
+static const double FramePacerOvershootDecay = 0.95;
+
+
+/**
+ *  Performs one coarse sleep and folds the observed overshoot into the
+ *  running estimate. Overshoots larger than the estimate are taken at once so
+ *  a slow sleep is never repeated, smaller ones decay the estimate slowly.
+ *  An overshoot longer than the frame period is a stall (the process being
+ *  descheduled, for instance) rather than the timer, so it is ignored.
+ */
+static void Frame_Pacer_Coarse_Sleep(double period)
+{
+    FramePacerClock::time_point before = FramePacerClock::now();
+    std::this_thread::sleep_for(FramePacerSleepStep);
+    FramePacerClock::time_point after = FramePacerClock::now();
+
+    double overshoot = Frame_Pacer_Milliseconds(after - before) - Frame_Pacer_Milliseconds(FramePacerSleepStep);
+    overshoot = std::max(overshoot, 0.0);
+
+    if (overshoot > period) {
+        return;
+    }
+
+    if (overshoot > FramePacerOvershoot) {
+        FramePacerOvershoot = overshoot;
+    } else {
+        FramePacerOvershoot += (overshoot - FramePacerOvershoot) / 16.0;
+    }
+}
+
+
+/**
+ *  Waits until the next frame deadline for the frame rate. Most of the wait
+ *  is spent sleeping, the final part (the calibrated sleep overshoot) is spun
+ *  out against the monotonic clock so the deadline is met without relying on
+ *  the resolution of the system timer.
+ * 
+ *  @author: agent
+ */
+void Frame_Pacer_Wait(int frame_rate)
+{
+    if (frame_rate <= 0) {
+        return;
+    }
+
+#ifdef _WIN32
+    /**
+     *  Request the finest system timer resolution so the coarse sleeps are
+     *  close to their requested length rather than the default 15.6ms tick.
+     */
+    if (!FramePacerTimerPeriodSet) {
+        FramePacerTimerPeriodSet = (timeBeginPeriod(1) == TIMERR_NOERROR);
+    }
+#endif
+
+    FramePacerClock::duration period = std::chrono::duration_cast<FramePacerClock::duration>(
+        std::chrono::duration<double>(1.0 / frame_rate));
+
+    FramePacerClock::time_point now = FramePacerClock::now();
+
+    /**
+     *  Deadlines advance by exactly one period so the average frame rate does
+     *  not drift. If we have fallen more than a frame behind (a slow frame, or
+     *  the first wait) restart the schedule from now instead of rushing to
+     *  catch up.
+     */
+    if (!FramePacerDeadlineValid || now - FramePacerDeadline > period) {
+        FramePacerDeadline = now;
+        FramePacerDeadlineValid = true;
+    }
+
+    FramePacerDeadline += period;
+
+    /**
+     *  The estimate is limited to half the period, so no more than half a
+     *  frame (and one sleep step) is ever spun. It also decays on every wait,
+     *  as an estimate that is too high stops any coarse sleep being made and
+     *  so would never be corrected by them.
+     */
+    const double period_ms = Frame_Pacer_Milliseconds(period);
+
+    FramePacerOvershoot = std::min(FramePacerOvershoot * FramePacerOvershootDecay, period_ms / 2.0);
+
+    for (;;) {
+        double remaining = Frame_Pacer_Milliseconds(FramePacerDeadline - FramePacerClock::now());
+        if (remaining <= Frame_Pacer_Milliseconds(FramePacerSleepStep) + FramePacerOvershoot) {
+            break;
+        }
+        Frame_Pacer_Coarse_Sleep(period_ms);
+        FramePacerOvershoot = std::min(FramePacerOvershoot, period_ms / 2.0);
+    }
+
+    while (FramePacerClock::now() < FramePacerDeadline) {
+        std::this_thread::yield();
+    }
+}
+
+
+/**
+ *  Records the interval since the previous frame mark.
+ * 
+ *  @author: agent
+ */
+void Frame_Pacer_Mark_Frame()
+{
+    FramePacerClock::time_point now = FramePacerClock::now();
+
+    if (FramePacerLastMarkValid) {
+        FramePacerHistory[FramePacerHistoryHead] = float(Frame_Pacer_Milliseconds(now - FramePacerLastMark));
+        FramePacerHistoryHead = (FramePacerHistoryHead + 1) % FRAME_PACER_HISTORY_MAX;
+        FramePacerHistoryCount = std::min(FramePacerHistoryCount + 1, FRAME_PACER_HISTORY_MAX);
+    }
+
+    FramePacerLastMark = now;
+    FramePacerLastMarkValid = true;
+}
+
+
+/**
+ *  Clears the frame history and the pacing schedule.
+ * 
+ *  @author: agent
+ */
+void Frame_Pacer_Reset()
+{
+    FramePacerDeadlineValid = false;
+    FramePacerLastMarkValid = false;
+    FramePacerHistoryHead = 0;
+    FramePacerHistoryCount = 0;
+}
+
+
+/**
+ *  Releases the system timer resolution request.
+ * 
+ *  @author: agent
+ */
+void Frame_Pacer_Shutdown()
+{
+#ifdef _WIN32
+    if (FramePacerTimerPeriodSet) {
+        timeEndPeriod(1);
+        FramePacerTimerPeriodSet = false;
+    }
+#endif
+
+    Frame_Pacer_Reset();
+}
+
+
+/**
+ *  Fetches the number of frame intervals in the history.
+ * 
+ *  @author: agent
+ */
+int Frame_Pacer_History_Count()
+{
+    return FramePacerHistoryCount;
+}
+
+
+/**
+ *  Fetches the frame interval at the percentile (0 to 100) of the history, in
+ *  milliseconds.
+ * 
+ *  @author: agent
+ */
+float Frame_Pacer_Percentile(float percentile)
+{
+    if (!FramePacerHistoryCount) {
+        return 0.0f;
+    }
+
+    float sorted[FRAME_PACER_HISTORY_MAX];
+    std::copy(FramePacerHistory, FramePacerHistory + FramePacerHistoryCount, sorted);
+
+    percentile = std::min(std::max(percentile, 0.0f), 100.0f);
+    int index = int((percentile / 100.0f) * (FramePacerHistoryCount - 1) + 0.5f);
+
+    std::nth_element(sorted, sorted + index, sorted + FramePacerHistoryCount);
+
+    return sorted[index];
+}
+
+
+/**
+ *  Fetches the current estimate of the coarse sleep overshoot, in milliseconds.
+ * 
+ *  @author: agent
+ */
+float Frame_Pacer_Sleep_Overshoot()
+{
+    return float(FramePacerOvershoot);
+}
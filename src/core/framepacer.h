@@ -0,0 +1,46 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          FRAMEPACER.H
+ *
+ *  @author        agent
+ *
+ *  @brief         High resolution frame pacing and frame time statistics.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include <always.h>
+
+
+/**
+ *  The number of frame intervals kept for the percentile statistics.
+ */
+#define FRAME_PACER_HISTORY_MAX 240
+
+
+void Frame_Pacer_Wait(int frame_rate);
+void Frame_Pacer_Mark_Frame();
+void Frame_Pacer_Reset();
+void Frame_Pacer_Shutdown();
+
+int Frame_Pacer_History_Count();
+float Frame_Pacer_Percentile(float percentile);
+float Frame_Pacer_Sleep_Overshoot();
@@ -0,0 +1,387 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          IMAGECACHE.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Shared cache of image surfaces loaded from file.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "imagecache.h"
+#include "filepng.h"
+#include "ccfile.h"
+#include "bsurface.h"
+#include "vinifera_util.h"
+#include "debughandler.h"
+#include "asserthandler.h"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cctype>
+#include <cstdlib>
+#include <timeapi.h>
+
+
+/**
+ *  The maximum number of worker threads used to decode images.
+ */
+#define IMAGE_CACHE_THREADS_MAX 8
+
+
+/**
+ *  A cached image. The surface is NULL if no image file exists for the
+ *  name, this avoids probing the file system again for missing images.
+ */
+struct ImageCacheEntryStruct
+{
+    BSurface *Surface;
+    int RefCount;
+};
+
+
+static std::unordered_map<std::string, ImageCacheEntryStruct> ImageCache;
+static std::unordered_map<BSurface *, ImageCacheEntryStruct *> ImageCacheSurfaces;
+
+/**
+ *  While set, Image_Cache_Fetch only returns images that are already cached,
+ *  see Image_Cache_Defer_Loads.
+ */
+static bool ImageCacheDeferred = false;
+
+/**
+ *  The number of fetches, and the number of images loaded from disk. Each
+ *  name is only loaded once until it is purged, so the loads are unique.
+ */
+static int ImageCacheFetches = 0;
+static int ImageCacheLoads = 0;
+
+
+/**
+ *  Image filenames are given without an extension, and are not case sensitive.
+ */
+static std::string Image_Cache_Key(const char *filename)
+{
+    std::string key = filename;
+    for (char &c : key) {
+        c = (char)std::toupper((unsigned char)c);
+    }
+    return key;
+}
+
+
+static ImageCacheEntryStruct &Image_Cache_Add(const std::string &key, BSurface *surface)
+{
+    ImageCacheEntryStruct &entry = ImageCache[key];
+    entry.Surface = surface;
+    entry.RefCount = 0;
+
+    if (surface) {
+        ImageCacheSurfaces[surface] = &entry;
+    }
+
+    return entry;
+}
+
+
+/**
+ *  Fetch a shared image surface for the specified filename, loading it if
+ *  it is not already cached. Each successful fetch must be paired with a
+ *  call to Image_Cache_Release.
+ *
+ *  @return      NULL if the image file was not found.
+ * 
+ *  @warning     The input filename must not contain an extension!
+ * 
+ *  @author: agent
+ */
+BSurface *Image_Cache_Fetch(const char *filename)
+{
+    if (!filename || !filename[0]) {
+        return nullptr;
+    }
+
+    std::string key = Image_Cache_Key(filename);
+
+    ++ImageCacheFetches;
+
+    auto it = ImageCache.find(key);
+    if (it != ImageCache.end()) {
+        if (it->second.Surface) {
+            ++it->second.RefCount;
+        }
+        return it->second.Surface;
+    }
+
+    if (ImageCacheDeferred) {
+        return nullptr;
+    }
+
+    ++ImageCacheLoads;
+
+    ImageCacheEntryStruct &entry = Image_Cache_Add(key, Vinifera_Get_Image_Surface(key.c_str()));
+    if (entry.Surface) {
+        ++entry.RefCount;
+    }
+
+    return entry.Surface;
+}
+
+
+/**
+ *  Releases a reference to a surface returned by Image_Cache_Fetch. The
+ *  surface itself is kept in the cache so that loading a saved game does
+ *  not have to decode it again, it is only freed by Image_Cache_Clear.
+ * 
+ *  @author: agent
+ */
+void Image_Cache_Release(BSurface *surface)
+{
+    if (!surface) {
+        return;
+    }
+
+    auto it = ImageCacheSurfaces.find(surface);
+    if (it == ImageCacheSurfaces.end()) {
+        return;
+    }
+
+    ASSERT(it->second->RefCount > 0);
+    --it->second->RefCount;
+}
+
+
+/**
+ *  Sets whether fetching an image that is not cached yet should load it. This
+ *  is used while the rules are processed, so the cameo images can be loaded in
+ *  one batch once all the types are known, see Image_Cache_Preload.
+ * 
+ *  @author: agent
+ */
+void Image_Cache_Defer_Loads(bool defer)
+{
+    ImageCacheDeferred = defer;
+}
+
+
+/**
+ *  A single image to be decoded by the preloader.
+ */
+struct ImagePreloadJobStruct
+{
+    std::string Key;
+    std::vector<unsigned char> Data;
+    unsigned char *Image;
+    unsigned Width;
+    unsigned Height;
+};
+
+
+/**
+ *  Loads the specified images into the cache ahead of time. The PNG files are
+ *  read on the calling thread, as the file system is not thread safe, then
+ *  decoded in parallel. Any image without a PNG file falls back to the regular
+ *  loading path.
+ * 
+ *  @author: agent
+ */
+void Image_Cache_Preload(const char **filenames, int count)
+{
+    DWORD start_time = timeGetTime();
+
+    std::vector<ImagePreloadJobStruct> jobs;
+    std::vector<std::string> fallbacks;
+
+    /**
+     *  Gather the images that are not cached yet and read their file data.
+     */
+    for (int i = 0; i < count; ++i) {
+
+        if (!filenames[i] || !filenames[i][0]) {
+            continue;
+        }
+
+        std::string key = Image_Cache_Key(filenames[i]);
+        if (ImageCache.find(key) != ImageCache.end()) {
+            continue;
+        }
+
+        /**
+         *  Reserve the entry now so duplicate names are only loaded once.
+         */
+        Image_Cache_Add(key, nullptr);
+        ++ImageCacheLoads;
+
+        std::string png_name = key + ".PNG";
+        CCFileClass file(png_name.c_str());
+
+        if (!file.Is_Available()) {
+            fallbacks.push_back(key);
+            continue;
+        }
+
+        ImagePreloadJobStruct job;
+        job.Key = key;
+        job.Data.resize(file.Size());
+        job.Image = nullptr;
+        job.Width = 0;
+        job.Height = 0;
+
+        file.Open(FILE_ACCESS_READ);
+        long read = job.Data.empty() ? 0 : file.Read(job.Data.data(), (long)job.Data.size());
+        file.Close();
+
+        if (read != (long)job.Data.size() || job.Data.empty()) {
+            DEBUG_WARNING("Image cache: Failed to read \"%s\"!\n", png_name.c_str());
+            fallbacks.push_back(key);
+            continue;
+        }
+
+        jobs.push_back(std::move(job));
+    }
+
+    /**
+     *  Decode the PNG data on the worker threads.
+     */
+    std::atomic<int> next_job(0);
+
+    auto worker = [&]() {
+        for (int index = next_job++; index < (int)jobs.size(); index = next_job++) {
+            ImagePreloadJobStruct &job = jobs[index];
+            job.Image = Decode_PNG_Data(job.Data.data(), job.Data.size(), job.Width, job.Height);
+        }
+    };
+
+    int thread_count = std::min<int>(std::thread::hardware_concurrency(), IMAGE_CACHE_THREADS_MAX);
+    thread_count = std::min<int>(thread_count, (int)jobs.size());
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < thread_count; ++i) {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    /**
+     *  Create the surfaces, this must be done on the calling thread.
+     */
+    int decoded = 0;
+
+    for (ImagePreloadJobStruct &job : jobs) {
+        if (!job.Image) {
+            DEBUG_WARNING("Image cache: Failed to decode \"%s.PNG\"!\n", job.Key.c_str());
+            fallbacks.push_back(job.Key);
+            continue;
+        }
+
+        BSurface *surface = Create_PNG_Surface(job.Image, job.Width, job.Height);
+        std::free(job.Image);
+
+        Image_Cache_Add(job.Key, surface);
+        ++decoded;
+    }
+
+    for (const std::string &key : fallbacks) {
+        BSurface *surface = Vinifera_Get_Image_Surface(key.c_str());
+        if (surface) {
+            Image_Cache_Add(key, surface);
+            ++decoded;
+        }
+    }
+
+    DEBUG_INFO("Image cache: Preloaded %d images (%d PNG) in %d ms using %d threads.\n",
+        decoded, (int)jobs.size(), timeGetTime() - start_time, std::max(thread_count, 1));
+}
+
+
+/**
+ *  Frees the surfaces that are no longer referenced, along with the markers
+ *  for missing images. The images still held by the types stay cached.
+ * 
+ *  @author: agent
+ */
+void Image_Cache_Purge()
+{
+    int purged = 0;
+
+    for (auto it = ImageCache.begin(); it != ImageCache.end(); ) {
+        if (it->second.RefCount > 0) {
+            ++it;
+            continue;
+        }
+
+        if (it->second.Surface) {
+            ImageCacheSurfaces.erase(it->second.Surface);
+            delete it->second.Surface;
+            ++purged;
+        }
+
+        it = ImageCache.erase(it);
+    }
+
+    if (purged > 0) {
+        DEBUG_INFO("Image cache: Freed %d unreferenced images.\n", purged);
+    }
+}
+
+
+/**
+ *  Frees all cached surfaces.
+ * 
+ *  @author: agent
+ */
+void Image_Cache_Clear()
+{
+    for (auto &it : ImageCache) {
+        if (it.second.RefCount > 0) {
+            DEV_DEBUG_WARNING("Image cache: \"%s\" still has %d references!\n", it.first.c_str(), it.second.RefCount);
+        }
+        delete it.second.Surface;
+    }
+
+    ImageCache.clear();
+    ImageCacheSurfaces.clear();
+}
+
+
+/**
+ *  Prints the cache usage to the log.
+ * 
+ *  @author: agent
+ */
+void Image_Cache_Print_Stats()
+{
+    /**
+     *  Every unique load counts against the fetches, including the preloaded
+     *  images, so this is the share of fetches that reused a loaded image.
+     */
+    int reused = std::max(ImageCacheFetches - ImageCacheLoads, 0);
+    int ratio = ImageCacheFetches > 0 ? (reused * 100) / ImageCacheFetches : 0;
+
+    DEBUG_INFO("Image cache: %d entries, %d fetches, %d unique loads (%d%% reused).\n",
+        (int)ImageCache.size(), ImageCacheFetches, ImageCacheLoads, ratio);
+}
@@ -0,0 +1,43 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          IMAGECACHE.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Shared cache of image surfaces loaded from file.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include <always.h>
+
+
+class BSurface;
+
+
+BSurface *Image_Cache_Fetch(const char *filename);
+void Image_Cache_Release(BSurface *surface);
+
+void Image_Cache_Defer_Loads(bool defer);
+void Image_Cache_Preload(const char **filenames, int count);
+void Image_Cache_Purge();
+void Image_Cache_Clear();
+void Image_Cache_Print_Stats();
@@ -0,0 +1,237 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          LINEBATCH.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Batched drawing of the thick, shadowed and dashed overlay lines.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "linebatch.h"
+#include "asserthandler.h"
+#include "debughandler.h"
+#include <algorithm>
+#include <cstdlib>
+
+
+/**
+ *  The line patterns are always 16 entries long.
+ */
+#define LINE_PATTERN_SIZE 16
+
+
+LineBatchClass::LineBatchClass(XSurface *surface, const Rect &clip) :
+    Surface(surface),
+    Clip(clip),
+    DropStrokes(),
+    Strokes(),
+    DropPoints(),
+    Points()
+{
+    ASSERT(surface != nullptr);
+}
+
+
+LineBatchClass::~LineBatchClass()
+{
+    Flush();
+}
+
+
+/**
+ *  Adds a clipped line to the batch. A thick line is two pixels high, and
+ *  its drop shadow sits two pixels further down.
+ * 
+ *  @author: agent
+ */
+void LineBatchClass::Add_Line(Point2D &start, Point2D &end, unsigned color, unsigned drop_color, bool is_thick, bool is_dropshadow, const bool *pattern, int offset)
+{
+    int rows = is_thick ? 2 : 1;
+
+    if (is_dropshadow) {
+        StrokeStruct drop;
+        drop.Start = start;
+        drop.End = end;
+        drop.Start.Y += rows;
+        drop.End.Y += rows;
+        drop.Color = drop_color;
+        drop.Rows = rows;
+        drop.Pattern = pattern;
+        drop.Offset = offset;
+        DropStrokes.push_back(drop);
+    }
+
+    StrokeStruct stroke;
+    stroke.Start = start;
+    stroke.End = end;
+    stroke.Color = color;
+    stroke.Rows = rows;
+    stroke.Pattern = pattern;
+    stroke.Offset = offset;
+    Strokes.push_back(stroke);
+}
+
+
+/**
+ *  Adds a line end point square to the batch.
+ * 
+ *  @author: agent
+ */
+void LineBatchClass::Add_Point(Rect &rect, unsigned color, bool is_dropshadow)
+{
+    if (rect.Width <= 0 || rect.Height <= 0) {
+        return;
+    }
+
+    PointStruct point;
+    point.Area = rect;
+    point.Color = color;
+
+    if (is_dropshadow) {
+        DropPoints.push_back(point);
+    } else {
+        Points.push_back(point);
+    }
+}
+
+
+/**
+ *  Draws everything collected so far and empties the batch.
+ * 
+ *  @author: agent
+ */
+void LineBatchClass::Flush()
+{
+    Draw_Strokes(DropStrokes);
+    Draw_Strokes(Strokes);
+    Draw_Points(DropPoints);
+    Draw_Points(Points);
+
+    DropStrokes.clear();
+    Strokes.clear();
+    DropPoints.clear();
+    Points.clear();
+}
+
+
+/**
+ *  Draws a list of strokes with a single surface lock. Each stroke is walked
+ *  once with a Bresenham stepper, writing all of its rows at every step.
+ * 
+ *  @author: agent
+ */
+void LineBatchClass::Draw_Strokes(std::vector<StrokeStruct> &strokes)
+{
+    if (strokes.empty()) {
+        return;
+    }
+
+    /**
+     *  The stepper writes 16-bit pixels directly, other surface formats
+     *  are drawn through the surface line functions instead.
+     */
+    if (Surface->Get_Bytes_Per_Pixel() != 2) {
+        for (StrokeStruct &stroke : strokes) {
+            for (int row = 0; row < stroke.Rows; ++row) {
+                Point2D start(stroke.Start.X, stroke.Start.Y + row);
+                Point2D end(stroke.End.X, stroke.End.Y + row);
+                if (stroke.Pattern) {
+                    Surface->Draw_Dashed_Line(start, end, stroke.Color, const_cast<bool *>(stroke.Pattern), stroke.Offset);
+                } else {
+                    Surface->Draw_Line(start, end, stroke.Color);
+                }
+            }
+        }
+        return;
+    }
+
+    unsigned char *buffer = (unsigned char *)Surface->Lock();
+    if (!buffer) {
+        Surface->Unlock();
+        return;
+    }
+
+    int pitch = Surface->Get_Pitch();
+
+    /**
+     *  The visible area is the clip rectangle limited to the surface.
+     */
+    int clip_left = std::max(Clip.X, 0);
+    int clip_top = std::max(Clip.Y, 0);
+    int clip_right = std::min(Clip.X + Clip.Width, Surface->Get_Width());
+    int clip_bottom = std::min(Clip.Y + Clip.Height, Surface->Get_Height());
+
+    for (const StrokeStruct &stroke : strokes) {
+
+        unsigned short color = (unsigned short)stroke.Color;
+
+        int x = stroke.Start.X;
+        int y = stroke.Start.Y;
+        int dx = std::abs(stroke.End.X - x);
+        int dy = -std::abs(stroke.End.Y - y);
+        int sx = x < stroke.End.X ? 1 : -1;
+        int sy = y < stroke.End.Y ? 1 : -1;
+        int error = dx + dy;
+
+        for (int step = 0; ; ++step) {
+
+            bool is_on = !stroke.Pattern || stroke.Pattern[(step + stroke.Offset) & (LINE_PATTERN_SIZE-1)];
+
+            if (is_on && x >= clip_left && x < clip_right) {
+                for (int row = 0; row < stroke.Rows; ++row) {
+                    int py = y + row;
+                    if (py >= clip_top && py < clip_bottom) {
+                        *(unsigned short *)(buffer + (py * pitch) + (x * sizeof(unsigned short))) = color;
+                    }
+                }
+            }
+
+            if (x == stroke.End.X && y == stroke.End.Y) {
+                break;
+            }
+
+            int error2 = error * 2;
+            if (error2 >= dy) {
+                error += dy;
+                x += sx;
+            }
+            if (error2 <= dx) {
+                error += dx;
+                y += sy;
+            }
+        }
+    }
+
+    Surface->Unlock();
+}
+
+
+/**
+ *  Fills a list of end point squares.
+ * 
+ *  @author: agent
+ */
+void LineBatchClass::Draw_Points(std::vector<PointStruct> &points)
+{
+    for (PointStruct &point : points) {
+        Surface->Fill_Rect(point.Area, point.Color);
+    }
+}
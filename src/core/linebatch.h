@@ -0,0 +1,83 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          LINEBATCH.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Batched drawing of the thick, shadowed and dashed overlay lines.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include <always.h>
+#include "xsurface.h"
+#include <vector>
+
+
+/**
+ *  Collects the overlay lines (action lines, NavCom queue lines and target
+ *  lasers) and their end point squares, and draws them all on Flush. Each
+ *  line is walked once for its shadow and once for the line itself, with
+ *  all of the thickness rows written in the same walk.
+ * 
+ *  The drawing order of the individual calls is kept, all shadows are drawn
+ *  before the lines and all end point shadows before the end points.
+ */
+class LineBatchClass
+{
+    public:
+        LineBatchClass(XSurface *surface, const Rect &clip);
+        ~LineBatchClass();
+
+        void Add_Line(Point2D &start, Point2D &end, unsigned color, unsigned drop_color, bool is_thick, bool is_dropshadow, const bool *pattern = nullptr, int offset = 0);
+        void Add_Point(Rect &rect, unsigned color, bool is_dropshadow = false);
+
+        void Flush();
+
+    private:
+        struct StrokeStruct
+        {
+            Point2D Start;
+            Point2D End;
+            unsigned Color;
+            int Rows;
+            const bool *Pattern;
+            int Offset;
+        };
+
+        struct PointStruct
+        {
+            Rect Area;
+            unsigned Color;
+        };
+
+        void Draw_Strokes(std::vector<StrokeStruct> &strokes);
+        void Draw_Points(std::vector<PointStruct> &points);
+
+    private:
+        XSurface *Surface;
+        Rect Clip;
+
+        std::vector<StrokeStruct> DropStrokes;
+        std::vector<StrokeStruct> Strokes;
+        std::vector<PointStruct> DropPoints;
+        std::vector<PointStruct> Points;
+};
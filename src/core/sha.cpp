@@ -34,6 +34,282 @@
  ******************************************************************************/
 #include "sha.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SHA_NI_TARGET
+#else
+#include <cpuid.h>
+#define SHA_NI_TARGET __attribute__((target("sha,ssse3,sse4.1")))
+#include <x86intrin.h>
+#define _byteswap_ulong __builtin_bswap32
+#endif
+
+
+/**
+ *  Processes a run of blocks using the SHA extensions. The digest is kept in
+ *  registers for the whole run, only being loaded and stored once.
+ * 
+ *  The message schedule for rounds 16-79 follows the same pattern every four
+ *  rounds with the message registers rotating, so each group is expressed
+ *  through the SHA_NI_ROUNDS macro. Only the "func" (round function index)
+ *  must be an immediate.
+ */
+#define SHA_NI_ROUNDS(e_cur, e_next, m0, m1, m2, m3, func) \
+    e_cur = _mm_sha1nexte_epu32(e_cur, m0); \
+    e_next = abcd; \
+    m1 = _mm_sha1msg2_epu32(m1, m0); \
+    abcd = _mm_sha1rnds4_epu32(abcd, e_cur, func); \
+    m3 = _mm_sha1msg1_epu32(m3, m0); \
+    m2 = _mm_xor_si128(m2, m0);
+
+SHA_NI_TARGET static void SHA_NI_Process_Blocks(uint32_t * state, unsigned char const * data, long blocks)
+{
+    const __m128i mask = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    __m128i abcd = _mm_loadu_si128((__m128i const *)state);
+    __m128i e0 = _mm_set_epi32(state[4], 0, 0, 0);
+    __m128i e1;
+    abcd = _mm_shuffle_epi32(abcd, 0x1B);
+
+    for (long index = 0; index < blocks; ++index) {
+
+        __m128i abcd_save = abcd;
+        __m128i e0_save = e0;
+
+        /**
+         *  Rounds 0-15 load the message words.
+         */
+        __m128i msg0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)(data + 0)), mask);
+        e0 = _mm_add_epi32(e0, msg0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        __m128i msg1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)(data + 16)), mask);
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+        __m128i msg2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)(data + 32)), mask);
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        __m128i msg3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)(data + 48)), mask);
+        SHA_NI_ROUNDS(e1, e0, msg3, msg0, msg1, msg2, 0);
+
+        /**
+         *  Rounds 16-75.
+         */
+        SHA_NI_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 0);
+        SHA_NI_ROUNDS(e1, e0, msg1, msg2, msg3, msg0, 1);
+        SHA_NI_ROUNDS(e0, e1, msg2, msg3, msg0, msg1, 1);
+        SHA_NI_ROUNDS(e1, e0, msg3, msg0, msg1, msg2, 1);
+        SHA_NI_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 1);
+        SHA_NI_ROUNDS(e1, e0, msg1, msg2, msg3, msg0, 1);
+        SHA_NI_ROUNDS(e0, e1, msg2, msg3, msg0, msg1, 2);
+        SHA_NI_ROUNDS(e1, e0, msg3, msg0, msg1, msg2, 2);
+        SHA_NI_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 2);
+        SHA_NI_ROUNDS(e1, e0, msg1, msg2, msg3, msg0, 2);
+        SHA_NI_ROUNDS(e0, e1, msg2, msg3, msg0, msg1, 2);
+        SHA_NI_ROUNDS(e1, e0, msg3, msg0, msg1, msg2, 3);
+        SHA_NI_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 3);
+        SHA_NI_ROUNDS(e1, e0, msg1, msg2, msg3, msg0, 3);
+        SHA_NI_ROUNDS(e0, e1, msg2, msg3, msg0, msg1, 3);
+
+        /**
+         *  Rounds 76-79.
+         */
+        e1 = _mm_sha1nexte_epu32(e1, msg3);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+        e0 = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+
+        data += 64;
+    }
+
+    abcd = _mm_shuffle_epi32(abcd, 0x1B);
+    _mm_storeu_si128((__m128i *)state, abcd);
+    state[4] = _mm_extract_epi32(e0, 3);
+}
+
+#undef SHA_NI_ROUNDS
+
+
+/**
+ *  Processes runs of blocks from four independent streams at once, one stream
+ *  per 32-bit lane of the SSE2 registers. Used when the SHA extensions are not
+ *  available. A lane with a step of zero reads the same block each time, this
+ *  is used for the unused lanes.
+ */
+#define SHA_X4_ROTL(x, n) _mm_or_si128(_mm_slli_epi32((x), (n)), _mm_srli_epi32((x), 32 - (n)))
+
+static inline __m128i SHA_X4_Byte_Swap(__m128i x)
+{
+    x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+    x = _mm_shufflelo_epi16(x, 0xB1);
+    return _mm_shufflehi_epi16(x, 0xB1);
+}
+
+static void SHA_X4_Process_Blocks(uint32_t (*state)[5], unsigned char const ** data, int const * step, long blocks)
+{
+    __m128i a = _mm_set_epi32(state[3][0], state[2][0], state[1][0], state[0][0]);
+    __m128i b = _mm_set_epi32(state[3][1], state[2][1], state[1][1], state[0][1]);
+    __m128i c = _mm_set_epi32(state[3][2], state[2][2], state[1][2], state[0][2]);
+    __m128i d = _mm_set_epi32(state[3][3], state[2][3], state[1][3], state[0][3]);
+    __m128i e = _mm_set_epi32(state[3][4], state[2][4], state[1][4], state[0][4]);
+
+    unsigned char const * source[4] = { data[0], data[1], data[2], data[3] };
+
+    for (long index = 0; index < blocks; ++index) {
+
+        __m128i w[16];
+
+        /**
+         *  Load four words from each stream and transpose them, so each
+         *  register holds the same word of every stream.
+         */
+        for (int group = 0; group < 4; ++group) {
+            __m128i v0 = _mm_loadu_si128((__m128i const *)(source[0] + group * 16));
+            __m128i v1 = _mm_loadu_si128((__m128i const *)(source[1] + group * 16));
+            __m128i v2 = _mm_loadu_si128((__m128i const *)(source[2] + group * 16));
+            __m128i v3 = _mm_loadu_si128((__m128i const *)(source[3] + group * 16));
+
+            __m128i t0 = _mm_unpacklo_epi32(v0, v1);
+            __m128i t1 = _mm_unpacklo_epi32(v2, v3);
+            __m128i t2 = _mm_unpackhi_epi32(v0, v1);
+            __m128i t3 = _mm_unpackhi_epi32(v2, v3);
+
+            w[group*4+0] = SHA_X4_Byte_Swap(_mm_unpacklo_epi64(t0, t1));
+            w[group*4+1] = SHA_X4_Byte_Swap(_mm_unpackhi_epi64(t0, t1));
+            w[group*4+2] = SHA_X4_Byte_Swap(_mm_unpacklo_epi64(t2, t3));
+            w[group*4+3] = SHA_X4_Byte_Swap(_mm_unpackhi_epi64(t2, t3));
+        }
+
+        const __m128i a_save = a;
+        const __m128i b_save = b;
+        const __m128i c_save = c;
+        const __m128i d_save = d;
+        const __m128i e_save = e;
+
+#define SHA_X4_ROUND(func, constant) \
+        { \
+            if (round >= 16) { \
+                __m128i x = _mm_xor_si128(_mm_xor_si128(w[(round-3)&15], w[(round-8)&15]), _mm_xor_si128(w[(round-14)&15], w[round&15])); \
+                w[round&15] = SHA_X4_ROTL(x, 1); \
+            } \
+            __m128i temp = _mm_add_epi32(_mm_add_epi32(SHA_X4_ROTL(a, 5), (func)), _mm_add_epi32(_mm_add_epi32(e, w[round&15]), _mm_set1_epi32(constant))); \
+            e = d; \
+            d = c; \
+            c = SHA_X4_ROTL(b, 30); \
+            b = a; \
+            a = temp; \
+        }
+
+        int round;
+        for (round = 0; round < 20; ++round) SHA_X4_ROUND(_mm_xor_si128(d, _mm_and_si128(b, _mm_xor_si128(c, d))), 0x5a827999);
+        for (; round < 40; ++round) SHA_X4_ROUND(_mm_xor_si128(_mm_xor_si128(b, c), d), 0x6ed9eba1);
+        for (; round < 60; ++round) SHA_X4_ROUND(_mm_or_si128(_mm_and_si128(b, c), _mm_and_si128(d, _mm_or_si128(b, c))), (int)0x8f1bbcdc);
+        for (; round < 80; ++round) SHA_X4_ROUND(_mm_xor_si128(_mm_xor_si128(b, c), d), (int)0xca62c1d6);
+
+#undef SHA_X4_ROUND
+
+        a = _mm_add_epi32(a, a_save);
+        b = _mm_add_epi32(b, b_save);
+        c = _mm_add_epi32(c, c_save);
+        d = _mm_add_epi32(d, d_save);
+        e = _mm_add_epi32(e, e_save);
+
+        for (int lane = 0; lane < 4; ++lane) {
+            source[lane] += step[lane];
+        }
+    }
+
+    uint32_t out[5][4];
+    _mm_storeu_si128((__m128i *)out[0], a);
+    _mm_storeu_si128((__m128i *)out[1], b);
+    _mm_storeu_si128((__m128i *)out[2], c);
+    _mm_storeu_si128((__m128i *)out[3], d);
+    _mm_storeu_si128((__m128i *)out[4], e);
+
+    for (int lane = 0; lane < 4; ++lane) {
+        for (int word = 0; word < 5; ++word) {
+            state[lane][word] = out[word][lane];
+        }
+    }
+}
+
+#undef SHA_X4_ROTL
+
+
+/**
+ *  Executes the CPUID instruction for the leaf and sub-leaf.
+ */
+static void SHA_CPUID(int * regs, int leaf, int subleaf)
+{
+#if defined(_MSC_VER)
+    __cpuidex(regs, leaf, subleaf);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+
+/**
+ *  The SHA extensions also rely on SSSE3 (byte shuffle) and SSE4.1 (extract).
+ * 
+ *  This is checked locally rather than through CPUDetectClass, as this file
+ *  is also built into the launcher, which does not link the CPU detection.
+ */
+static bool SHA_Detect_Extensions()
+{
+    int regs[4];
+
+    SHA_CPUID(regs, 0, 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+
+    SHA_CPUID(regs, 1, 0);
+    bool has_ssse3 = !!(regs[2] & (1 << 9));
+    bool has_sse41 = !!(regs[2] & (1 << 19));
+
+    SHA_CPUID(regs, 7, 0);
+    bool has_sha = !!(regs[1] & (1 << 29));
+
+    return has_sha && has_ssse3 && has_sse41;
+}
+
+
+static bool SHA_Detect_SSE2()
+{
+    int regs[4];
+
+    SHA_CPUID(regs, 1, 0);
+    return !!(regs[3] & (1 << 26));
+}
+
+
+static bool SHAUseExtensions = SHA_Detect_Extensions();
+static bool SHAUseLanes = SHA_Detect_SSE2();
+
+
+/**
+ *  Allows the SHA extensions to be turned off, so the code paths can be
+ *  compared. They can only be turned on if the processor supports them.
+ */
+void SHA::Set_Extensions_Enabled(bool enabled)
+{
+    SHAUseExtensions = enabled && SHA_Detect_Extensions();
+}
 
 
 void SHA::Process_Partial(void const * & data, long & length)
@@ -64,26 +340,110 @@ void SHA::Hash(void const * data, long length)
     if (length == 0) return;
 
     long blocks = (length / SRC_BLOCK_SIZE);
-    long const * source = (long const *)data;
-    for (int bcount = 0; bcount < blocks; bcount++) {
-        Process_Block(source, Acc);
-        Length += (long)SRC_BLOCK_SIZE;
-        source += SRC_BLOCK_SIZE/sizeof(long);
-        length -= (long)SRC_BLOCK_SIZE;
+    if (blocks > 0) {
+        Process_Blocks(data, blocks, Acc);
+        Length += blocks * (long)SRC_BLOCK_SIZE;
+        length -= blocks * (long)SRC_BLOCK_SIZE;
+        data = ((char const *)data) + blocks * (long)SRC_BLOCK_SIZE;
     }
 
-    data = source;
     Process_Partial(data, length);
 }
 
 
+/**
+ *  Hashes data into several independent SHA objects. When the SHA extensions
+ *  are not available, the whole blocks of up to four streams are processed
+ *  together using SSE2, which is close to four times the throughput of hashing
+ *  them one at a time. Each stream ends in the same state as if Hash() had
+ *  been called on it with its data.
+ */
+void SHA::Hash_Streams(SHA * const * streams, void const * const * data, long const * lengths, int count)
+{
+    static const unsigned char ZeroBlock[SRC_BLOCK_SIZE] = { 0 };
+
+    for (int first = 0; first < count; first += 4) {
+
+        int lanes = std::min(count - first, 4);
+
+        SHA * sha[4] = { nullptr };
+        void const * source[4] = { nullptr };
+        long length[4] = { 0 };
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            sha[lane] = streams[first+lane];
+            source[lane] = data[first+lane];
+            length[lane] = lengths[first+lane];
+
+            sha[lane]->IsCached = false;
+            sha[lane]->Process_Partial(source[lane], length[lane]);
+        }
+
+        /**
+         *  Process whole blocks four streams at a time while at least two
+         *  streams still have them; a single stream is faster on its own.
+         */
+        while (!SHAUseExtensions && SHAUseLanes) {
+
+            int active = 0;
+            long blocks = 0;
+            for (int lane = 0; lane < lanes; ++lane) {
+                long available = length[lane] / SRC_BLOCK_SIZE;
+                if (available > 0) {
+                    blocks = active ? std::min(blocks, available) : available;
+                    ++active;
+                }
+            }
+
+            if (active < 2) {
+                break;
+            }
+
+            uint32_t state[4][5] = { { 0 } };
+            unsigned char const * pointers[4];
+            int step[4];
+
+            for (int lane = 0; lane < 4; ++lane) {
+                if (lane < lanes && length[lane] >= (long)SRC_BLOCK_SIZE) {
+                    std::memcpy(state[lane], sha[lane]->Acc.Long, sizeof(state[lane]));
+                    pointers[lane] = (unsigned char const *)source[lane];
+                    step[lane] = SRC_BLOCK_SIZE;
+                } else {
+                    pointers[lane] = ZeroBlock;
+                    step[lane] = 0;
+                }
+            }
+
+            SHA_X4_Process_Blocks(state, pointers, step, blocks);
+
+            for (int lane = 0; lane < lanes; ++lane) {
+                if (step[lane] == 0) {
+                    continue;
+                }
+                std::memcpy(sha[lane]->Acc.Long, state[lane], sizeof(state[lane]));
+                sha[lane]->Length += blocks * (long)SRC_BLOCK_SIZE;
+                length[lane] -= blocks * (long)SRC_BLOCK_SIZE;
+                source[lane] = ((char const *)source[lane]) + blocks * (long)SRC_BLOCK_SIZE;
+            }
+        }
+
+        /**
+         *  Whatever is left of each stream is hashed on its own.
+         */
+        for (int lane = 0; lane < lanes; ++lane) {
+            sha[lane]->Hash(source[lane], length[lane]);
+        }
+    }
+}
+
+
 int SHA::Result(void * result) const
 {
     if (IsCached) {
         std::memcpy(result, &FinalResult, sizeof(FinalResult));
     }
 
-    long length = Length + PartialCount;
+    uint64_t length = Length + PartialCount;
     int partialcount = PartialCount;
     char partial[SRC_BLOCK_SIZE];
     std::memcpy(partial, Partial, sizeof(Partial));
@@ -92,7 +452,7 @@ int SHA::Result(void * result) const
 
     SHADigest acc = Acc;
     if ((SRC_BLOCK_SIZE - partialcount) < 9) {
-        if (partialcount+1 < SRC_BLOCK_SIZE) {
+        if (partialcount+1 < (int)SRC_BLOCK_SIZE) {
             std::memset(&partial[partialcount+1], '\0', SRC_BLOCK_SIZE - (partialcount+1));
         }
         Process_Block(&partial[0], acc);
@@ -102,12 +462,20 @@ int SHA::Result(void * result) const
     }
 
     std::memset(&partial[partialcount], '\0', SRC_BLOCK_SIZE - partialcount);
-    *(long *)(&partial[SRC_BLOCK_SIZE-4]) = _byteswap_ulong((length*8));
+
+    /**
+     *  The message length in bits is stored as a 64-bit big endian value.
+     */
+    uint64_t bits = length * 8;
+    for (int index = 0; index < 8; index++) {
+        partial[SRC_BLOCK_SIZE-1-index] = (char)(bits >> (index * 8));
+    }
+
     Process_Block(&partial[0], acc);
 
     std::memcpy((char *)&FinalResult, &acc, sizeof(acc));
-    for (int index = 0; index < sizeof(FinalResult)/sizeof(long); index++) {
-        (long &)FinalResult.Long[index] = _byteswap_ulong(FinalResult.Long[index]);
+    for (int index = 0; index < (int)(sizeof(FinalResult)/sizeof(uint32_t)); index++) {
+        (uint32_t &)FinalResult.Long[index] = _byteswap_ulong(FinalResult.Long[index]);
     }
     (bool&)IsCached = true;
     std::memcpy(result, &FinalResult, sizeof(FinalResult));
@@ -116,35 +484,70 @@ int SHA::Result(void * result) const
 }
 
 
+/**
+ *  Processes a single block. The four round groups are split into their own
+ *  loops so the round function and constant are not selected per round.
+ */
 void SHA::Process_Block(void const * source, SHADigest & acc) const
 {
-    long block[PROC_BLOCK_SIZE/sizeof(long)];
-    long const * data = (long const *)source;
+    uint32_t block[PROC_BLOCK_SIZE/sizeof(uint32_t)];
+    uint32_t const * data = (uint32_t const *)source;
     int index;
-    for (index = 0; index < SRC_BLOCK_SIZE/sizeof(long); index++) {
+    for (index = 0; index < (int)(SRC_BLOCK_SIZE/sizeof(uint32_t)); index++) {
         block[index] = _byteswap_ulong(data[index]);
     }
 
-    for (index = SRC_BLOCK_SIZE/sizeof(long); index < PROC_BLOCK_SIZE/sizeof(long); index++) {
+    for (index = SRC_BLOCK_SIZE/sizeof(uint32_t); index < (int)(PROC_BLOCK_SIZE/sizeof(uint32_t)); index++) {
         block[index] = _rotl(block[index-3] ^ block[index-8] ^ block[index-14] ^ block[index-16], 1);
     }
 
-    SHADigest alt = acc;
-    for (index = 0; index < PROC_BLOCK_SIZE/sizeof(long); index++) {
-        long temp = _rotl(alt.Long[0], 5) +
-                        Do_Function(index, alt.Long[1], alt.Long[2], alt.Long[3]) +
-                        alt.Long[4] + block[index] + Get_Constant(index);
-        alt.Long[4] = alt.Long[3];
-        alt.Long[3] = alt.Long[2];
-        alt.Long[2] = _rotl(alt.Long[1], 30);
-        alt.Long[1] = alt.Long[0];
-        alt.Long[0] = temp;
-    }
-    acc.Long[0] += alt.Long[0];
-    acc.Long[1] += alt.Long[1];
-    acc.Long[2] += alt.Long[2];
-    acc.Long[3] += alt.Long[3];
-    acc.Long[4] += alt.Long[4];
+    uint32_t a = acc.Long[0];
+    uint32_t b = acc.Long[1];
+    uint32_t c = acc.Long[2];
+    uint32_t d = acc.Long[3];
+    uint32_t e = acc.Long[4];
+
+#define SHA_ROUND(func, constant) \
+    { \
+        uint32_t temp = _rotl(a, 5) + (func) + e + block[index] + (constant); \
+        e = d; \
+        d = c; \
+        c = _rotl(b, 30); \
+        b = a; \
+        a = temp; \
+    }
+
+    for (index = 0; index < 20; index++) SHA_ROUND(d ^ (b & (c ^ d)), K1);
+    for (; index < 40; index++) SHA_ROUND(b ^ c ^ d, K2);
+    for (; index < 60; index++) SHA_ROUND((b & c) | (d & (b | c)), K3);
+    for (; index < 80; index++) SHA_ROUND(b ^ c ^ d, K4);
+
+#undef SHA_ROUND
+
+    acc.Long[0] += a;
+    acc.Long[1] += b;
+    acc.Long[2] += c;
+    acc.Long[3] += d;
+    acc.Long[4] += e;
+}
+
+
+/**
+ *  Processes a run of whole blocks, using the SHA extensions when the processor
+ *  supports them.
+ */
+void SHA::Process_Blocks(void const * source, long blocks, SHADigest & acc) const
+{
+    if (SHAUseExtensions) {
+        SHA_NI_Process_Blocks((uint32_t *)&acc.Long[0], (unsigned char const *)source, blocks);
+        return;
+    }
+
+    unsigned char const * data = (unsigned char const *)source;
+    for (long bcount = 0; bcount < blocks; bcount++) {
+        Process_Block(data, acc);
+        data += SRC_BLOCK_SIZE;
+    }
 }
 
 
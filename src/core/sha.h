@@ -60,13 +60,16 @@ class SHA
 
         void Hash(void const * data, long length);
 
+        static void Hash_Streams(SHA * const * streams, void const * const * data, long const * lengths, int count);
+        static void Set_Extensions_Enabled(bool enabled);
+
         int Print_Result(char *output);
 
         static int Digest_Size() { return sizeof(SHADigest); }
 
     private:
         typedef union {
-            unsigned long Long[5];
+            uint32_t Long[5];
             unsigned char Char[20];
         } SHADigest;
 
@@ -81,8 +84,8 @@ class SHA
             K2=0x6ed9eba1L,
             K3=0x8f1bbcdcL,
             K4=0xca62c1d6L,
-            SRC_BLOCK_SIZE=16*sizeof(long),
-            PROC_BLOCK_SIZE=80*sizeof(long)
+            SRC_BLOCK_SIZE=16*sizeof(uint32_t),
+            PROC_BLOCK_SIZE=80*sizeof(uint32_t)
         };
 
         long Get_Constant(int index) const {
@@ -116,6 +119,7 @@ class SHA
         };
 
         void Process_Block(void const * source, SHADigest & acc) const;
+        void Process_Blocks(void const * source, long blocks, SHADigest & acc) const;
         void Process_Partial(void const * & data, long & length);
 
         void Print(const void *buffer, char *stringbuff);
@@ -124,7 +128,7 @@ class SHA
         bool IsCached;
         SHADigest FinalResult;
         SHADigest Acc;
-        long Length;
+        uint64_t Length;
         int PartialCount;
         char Partial[SRC_BLOCK_SIZE];
 };
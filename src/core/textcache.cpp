@@ -0,0 +1,267 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          TEXTCACHE.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Cache of rasterised text runs for per-frame overlays.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "textcache.h"
+#include "bsurface.h"
+#include "xsurface.h"
+#include "wwfont.h"
+#include "colorscheme.h"
+#include "debughandler.h"
+#include "asserthandler.h"
+#include <algorithm>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <cstdio>
+
+
+/**
+ *  The maximum number of text runs kept in the cache. Super weapon timers
+ *  produce a new run each second, so this only needs to hold a few seconds
+ *  worth of overlay text.
+ */
+#define TEXT_RUN_CACHE_MAX 128
+
+
+/**
+ *  A rasterised text run. The surface holds the text drawn with its
+ *  alignment flags removed, so the run can be placed at any position.
+ */
+struct TextRunStruct
+{
+    std::string Key;
+    BSurface *Surface;
+    bool IsOpaque;
+};
+
+
+/**
+ *  Most recently used runs are kept at the front of the list.
+ */
+static std::list<TextRunStruct> TextRunList;
+static std::unordered_map<std::string, std::list<TextRunStruct>::iterator> TextRunMap;
+
+static int TextRunHits = 0;
+static int TextRunRasterised = 0;
+static int TextRunEvictions = 0;
+
+
+/**
+ *  Builds the lookup key for a text run from its font style, colour
+ *  scheme and content.
+ * 
+ *  @author: agent
+ */
+static std::string Text_Run_Key(const char *text, ColorScheme *fore, TextPrintType style)
+{
+    char prefix[32];
+    std::snprintf(prefix, sizeof(prefix), "%08X:%08X:", (unsigned)style, (uintptr_t)fore);
+
+    std::string key(prefix);
+    key += text;
+    return key;
+}
+
+
+/**
+ *  Rasterises the text into a new cache surface.
+ * 
+ *  @author: agent
+ */
+static BSurface *Text_Run_Rasterise(const char *text, ColorScheme *fore, TextPrintType style)
+{
+    WWFontClass *font = Font_Ptr(style);
+    if (!font) {
+        return nullptr;
+    }
+
+    Rect text_rect;
+    font->String_Pixel_Rect(text, &text_rect);
+    if (text_rect.Width <= 0 || text_rect.Height <= 0) {
+        return nullptr;
+    }
+
+    BSurface *surface = new BSurface(text_rect.Width, text_rect.Height, 2);
+    surface->Fill(0);
+
+    /**
+     *  The run is always drawn left aligned at the origin, the caller
+     *  position is adjusted for the alignment when the run is blitted.
+     */
+    TextPrintType draw_style = TextPrintType(style & ~(TPF_RIGHT|TPF_CENTER));
+
+    Fancy_Text_Print(text, surface, &surface->Get_Rect(), &Point2D(0, 0), fore, COLOR_TBLACK, draw_style);
+
+    ++TextRunRasterised;
+
+    return surface;
+}
+
+
+/**
+ *  Fetches a cached run, rasterising it if it is not in the cache yet.
+ * 
+ *  @author: agent
+ */
+static TextRunStruct *Text_Run_Fetch(const char *text, ColorScheme *fore, TextPrintType style, bool opaque)
+{
+    std::string key = Text_Run_Key(text, fore, style);
+
+    auto it = TextRunMap.find(key);
+    if (it != TextRunMap.end()) {
+        TextRunList.splice(TextRunList.begin(), TextRunList, it->second);
+        ++TextRunHits;
+        return &TextRunList.front();
+    }
+
+    BSurface *surface = Text_Run_Rasterise(text, fore, style);
+    if (!surface) {
+        return nullptr;
+    }
+
+    /**
+     *  Evict the least recently used run if the cache is full.
+     */
+    if (TextRunList.size() >= TEXT_RUN_CACHE_MAX) {
+        TextRunStruct &last = TextRunList.back();
+        delete last.Surface;
+        TextRunMap.erase(last.Key);
+        TextRunList.pop_back();
+        ++TextRunEvictions;
+    }
+
+    TextRunStruct run;
+    run.Key = key;
+    run.Surface = surface;
+    run.IsOpaque = opaque;
+
+    TextRunList.push_front(run);
+    TextRunMap[key] = TextRunList.begin();
+
+    return &TextRunList.front();
+}
+
+
+/**
+ *  Drop in replacement for Fancy_Text_Print for text that is redrawn every
+ *  frame. The text is rasterised once and then blitted from the cache.
+ * 
+ *  Only use this for text that changes slowly. Text that changes every frame
+ *  (frame counters, timings) would miss the cache on every draw and evict
+ *  the runs that are worth keeping.
+ * 
+ *  Runs with a drop or full shadow, or with a background colour other than
+ *  transparent, are passed through to the font printer as the shadow pixels
+ *  would be lost in the transparent blit.
+ * 
+ *  @author: agent
+ */
+void Text_Run_Print(const char *text, XSurface *surface, Rect *clip, Point2D *point, ColorScheme *fore, unsigned back, TextPrintType style)
+{
+    ASSERT(surface != nullptr);
+    ASSERT(clip != nullptr);
+    ASSERT(point != nullptr);
+
+    if (!text || !*text) {
+        return;
+    }
+
+    bool opaque = (style & TPF_SOLIDBLACK_BG) != 0;
+
+    if (back != COLOR_TBLACK || (style & (TPF_DROPSHADOW|TPF_FULLSHADOW)) != 0) {
+        Fancy_Text_Print(text, surface, clip, point, fore, back, style);
+        return;
+    }
+
+    TextRunStruct *run = Text_Run_Fetch(text, fore, style, opaque);
+    if (!run) {
+        return;
+    }
+
+    Rect src_rect = run->Surface->Get_Rect();
+
+    /**
+     *  Apply the alignment to the blit position.
+     */
+    int x = point->X;
+    int y = point->Y;
+
+    if (style & TPF_RIGHT) {
+        x -= src_rect.Width;
+    } else if (style & TPF_CENTER) {
+        x -= src_rect.Width / 2;
+    }
+
+    /**
+     *  Clip the run against the clipping rectangle.
+     */
+    int left = std::max(x, clip->X);
+    int top = std::max(y, clip->Y);
+    int right = std::min(x + src_rect.Width, clip->X + clip->Width);
+    int bottom = std::min(y + src_rect.Height, clip->Y + clip->Height);
+
+    if (right <= left || bottom <= top) {
+        return;
+    }
+
+    src_rect.X = left - x;
+    src_rect.Y = top - y;
+    src_rect.Width = right - left;
+    src_rect.Height = bottom - top;
+
+    Rect dest_rect(left, top, right - left, bottom - top);
+
+    surface->Copy_From(dest_rect, *run->Surface, src_rect, !run->IsOpaque);
+}
+
+
+/**
+ *  Frees all cached text runs.
+ * 
+ *  @author: agent
+ */
+void Text_Run_Cache_Clear()
+{
+    for (TextRunStruct &run : TextRunList) {
+        delete run.Surface;
+    }
+
+    TextRunList.clear();
+    TextRunMap.clear();
+}
+
+
+/**
+ *  Prints the cache usage to the log.
+ * 
+ *  @author: agent
+ */
+void Text_Run_Cache_Print_Stats()
+{
+    DEBUG_INFO("Text run cache: %d entries, %d hits, %d rasterised, %d evicted.\n",
+        (int)TextRunList.size(), TextRunHits, TextRunRasterised, TextRunEvictions);
+}
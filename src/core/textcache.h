@@ -0,0 +1,42 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          TEXTCACHE.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Cache of rasterised text runs for per-frame overlays.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include <always.h>
+#include "point.h"
+#include "textprint.h"
+
+
+class XSurface;
+class ColorScheme;
+
+
+void Text_Run_Print(const char *text, XSurface *surface, Rect *clip, Point2D *point, ColorScheme *fore, unsigned back, TextPrintType style);
+
+void Text_Run_Cache_Clear();
+void Text_Run_Cache_Print_Stats();
@@ -0,0 +1,474 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          ZIPWRITER.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Writes zip archives, compressing the files in parallel.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "zipwriter.h"
+#include "deflater.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+
+/**
+ *  The size of the buffers files are streamed through.
+ */
+#define ZIP_CHUNK_SIZE (64*1024)
+
+#define ZIP_METHOD_STORE    0
+#define ZIP_METHOD_DEFLATE  8
+
+#define ZIP_LOCAL_HEADER_SIZE   30
+#define ZIP_CRC_OFFSET          14
+
+
+/**
+ *  The state of each entry, filled in by whichever thread processes it.
+ */
+struct ZipResultStruct
+{
+    ZipResultStruct() : Done(false), Success(false), CRC(0), Size(0), CompressedSize(0), Time(0), Date(0), Offset(0) {}
+
+    bool Done;
+    bool Success;
+    uint32_t CRC;
+    uint32_t Size;
+    uint32_t CompressedSize;
+    uint16_t Time;
+    uint16_t Date;
+    uint32_t Offset;
+    std::string TempFilename;
+};
+
+
+struct ZipOutputStruct
+{
+    std::FILE *File;
+    uint64_t Count;
+};
+
+
+/**
+ *  Updates a CRC-32 (as used by zip) with the data.
+ *
+ *  @author: agent
+ */
+uint32_t Zip_CRC32(uint32_t crc, const void *data, int length)
+{
+    static const struct CRCTableStruct {
+        CRCTableStruct()
+        {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+                }
+                Table[i] = value;
+            }
+        }
+        uint32_t Table[256];
+    } crc_table;
+
+    const unsigned char *bytes = (const unsigned char *)data;
+
+    crc = ~crc;
+    for (int i = 0; i < length; ++i) {
+        crc = crc_table.Table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+
+static void Put_Word(std::vector<unsigned char> &buffer, uint16_t value)
+{
+    buffer.push_back((unsigned char)value);
+    buffer.push_back((unsigned char)(value >> 8));
+}
+
+
+static void Put_Long(std::vector<unsigned char> &buffer, uint32_t value)
+{
+    Put_Word(buffer, (uint16_t)value);
+    Put_Word(buffer, (uint16_t)(value >> 16));
+}
+
+
+static bool Write_Buffer(std::FILE *file, const std::vector<unsigned char> &buffer)
+{
+    return std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+}
+
+
+static bool Deflate_Output(void *param, const void *data, int length)
+{
+    ZipOutputStruct *output = (ZipOutputStruct *)param;
+    output->Count += length;
+    return std::fwrite(data, 1, length, output->File) == (size_t)length;
+}
+
+
+/**
+ *  Gets the modification time of the file in the MS-DOS format zip uses.
+ */
+static void Get_File_Time(const char *filename, uint16_t &time, uint16_t &date)
+{
+    struct stat info;
+    std::time_t modified = (stat(filename, &info) == 0) ? info.st_mtime : std::time(nullptr);
+
+    std::tm *local = std::localtime(&modified);
+    if (!local || local->tm_year < 80) {
+        time = 0;
+        date = (1 << 5) | 1;
+        return;
+    }
+
+    time = (uint16_t)((local->tm_hour << 11) | (local->tm_min << 5) | (local->tm_sec / 2));
+    date = (uint16_t)(((local->tm_year - 80) << 9) | ((local->tm_mon + 1) << 5) | local->tm_mday);
+}
+
+
+/**
+ *  Deflates a file into a temporary file, recording its CRC and sizes.
+ */
+static bool Compress_File(const char *filename, const char *tempname, ZipResultStruct &result)
+{
+    std::FILE *in = std::fopen(filename, "rb");
+    if (!in) {
+        return false;
+    }
+
+    std::FILE *out = std::fopen(tempname, "wb");
+    if (!out) {
+        std::fclose(in);
+        return false;
+    }
+
+    ZipOutputStruct output = { out, 0 };
+    DeflaterClass *deflater = new DeflaterClass(Deflate_Output, &output);
+    unsigned char *buffer = new unsigned char [ZIP_CHUNK_SIZE];
+
+    bool success = true;
+    uint64_t size = 0;
+    uint32_t crc = 0;
+
+    size_t read;
+    while (success && (read = std::fread(buffer, 1, ZIP_CHUNK_SIZE, in)) > 0) {
+        crc = Zip_CRC32(crc, buffer, (int)read);
+        size += read;
+        success = deflater->Write(buffer, (int)read);
+    }
+
+    success = success && !std::ferror(in) && deflater->Finish();
+    success = (std::fclose(out) == 0) && success;
+    std::fclose(in);
+
+    delete [] buffer;
+    delete deflater;
+
+    /**
+     *  Zip64 is not supported, so each file is limited to 4GB.
+     */
+    if (!success || size > 0xFFFFFFFF || output.Count > 0xFFFFFFFF) {
+        return false;
+    }
+
+    result.CRC = crc;
+    result.Size = (uint32_t)size;
+    result.CompressedSize = (uint32_t)output.Count;
+
+    return true;
+}
+
+
+/**
+ *  Copies a file into the archive, recording its CRC and size.
+ */
+static bool Copy_File(std::FILE *out, const char *filename, unsigned char *buffer, uint32_t &crc, uint64_t &size)
+{
+    std::FILE *in = std::fopen(filename, "rb");
+    if (!in) {
+        return false;
+    }
+
+    bool success = true;
+    crc = 0;
+    size = 0;
+
+    size_t read;
+    while (success && (read = std::fread(buffer, 1, ZIP_CHUNK_SIZE, in)) > 0) {
+        crc = Zip_CRC32(crc, buffer, (int)read);
+        size += read;
+        success = std::fwrite(buffer, 1, read, out) == read;
+    }
+
+    success = success && !std::ferror(in);
+    std::fclose(in);
+
+    return success;
+}
+
+
+/**
+ *  Adds a file to the archive under the given name. If "store" is set the
+ *  file is not compressed, for data that is already compressed.
+ *
+ *  @author: agent
+ */
+void ZipWriterClass::Add_File(const char *name, const char *filename, bool store)
+{
+    EntryStruct entry;
+    entry.Name = name;
+    entry.Filename = filename;
+    entry.Store = store;
+
+    /**
+     *  Zip paths always use forward slashes.
+     */
+    std::replace(entry.Name.begin(), entry.Name.end(), '\\', '/');
+
+    Entries.push_back(entry);
+}
+
+
+/**
+ *  Writes the archive, replacing the file if it exists. "threads" is the
+ *  number of files compressed at once, zero uses one per processor. On
+ *  failure the partial archive is removed.
+ *
+ *  @author: agent
+ */
+bool ZipWriterClass::Write(const char *filename, int threads)
+{
+    const int count = (int)Entries.size();
+
+    std::vector<ZipResultStruct> results(count);
+    std::vector<int> deflated;
+
+    for (int index = 0; index < count; ++index) {
+        Get_File_Time(Entries[index].Filename.c_str(), results[index].Time, results[index].Date);
+        if (!Entries[index].Store) {
+            results[index].TempFilename = std::string(filename) + "." + std::to_string(index) + ".tmp";
+            deflated.push_back(index);
+        }
+    }
+
+    std::FILE *out = std::fopen(filename, "wb");
+    if (!out) {
+        return false;
+    }
+
+    /**
+     *  Start the workers, each takes the next file to compress until none
+     *  are left.
+     */
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::atomic<int> next(0);
+    std::atomic<bool> abort(false);
+
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+    }
+    threads = std::max(1, std::min(threads, (int)deflated.size()));
+
+    auto worker = [&]() {
+        int job;
+        while ((job = next++) < (int)deflated.size()) {
+            const int index = deflated[job];
+            ZipResultStruct result = results[index];
+            bool success = !abort && Compress_File(Entries[index].Filename.c_str(), result.TempFilename.c_str(), result);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            results[index].CRC = result.CRC;
+            results[index].Size = result.Size;
+            results[index].CompressedSize = result.CompressedSize;
+            results[index].Success = success;
+            results[index].Done = true;
+            finished.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    if (!deflated.empty()) {
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back(worker);
+        }
+    }
+
+    /**
+     *  Append the entries in order as they become ready.
+     */
+    unsigned char *buffer = new unsigned char [ZIP_CHUNK_SIZE];
+    std::vector<unsigned char> header;
+    bool success = true;
+
+    for (int index = 0; index < count && success; ++index) {
+
+        const EntryStruct &entry = Entries[index];
+        ZipResultStruct &result = results[index];
+
+        if (!entry.Store) {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [&]() { return result.Done; });
+            if (!result.Success) {
+                success = false;
+                break;
+            }
+        }
+
+        long offset = std::ftell(out);
+        if (offset < 0) {
+            success = false;
+            break;
+        }
+        result.Offset = (uint32_t)offset;
+
+        header.clear();
+        Put_Long(header, 0x04034B50);
+        Put_Word(header, 20);
+        Put_Word(header, 0);
+        Put_Word(header, entry.Store ? ZIP_METHOD_STORE : ZIP_METHOD_DEFLATE);
+        Put_Word(header, result.Time);
+        Put_Word(header, result.Date);
+        Put_Long(header, result.CRC);
+        Put_Long(header, result.CompressedSize);
+        Put_Long(header, result.Size);
+        Put_Word(header, (uint16_t)entry.Name.size());
+        Put_Word(header, 0);
+        header.insert(header.end(), entry.Name.begin(), entry.Name.end());
+
+        if (!Write_Buffer(out, header)) {
+            success = false;
+            break;
+        }
+
+        if (entry.Store) {
+
+            /**
+             *  The CRC and size are only known once the file has been copied,
+             *  so they are filled in afterwards.
+             */
+            uint64_t size = 0;
+            success = Copy_File(out, entry.Filename.c_str(), buffer, result.CRC, size) && size <= 0xFFFFFFFF;
+            if (success) {
+                result.Size = (uint32_t)size;
+                result.CompressedSize = (uint32_t)size;
+
+                header.clear();
+                Put_Long(header, result.CRC);
+                Put_Long(header, result.CompressedSize);
+                Put_Long(header, result.Size);
+
+                success = std::fseek(out, offset + ZIP_CRC_OFFSET, SEEK_SET) == 0
+                       && Write_Buffer(out, header)
+                       && std::fseek(out, 0, SEEK_END) == 0;
+            }
+
+        } else {
+            uint32_t crc;
+            uint64_t size;
+            success = Copy_File(out, result.TempFilename.c_str(), buffer, crc, size) && size == result.CompressedSize;
+            std::remove(result.TempFilename.c_str());
+        }
+    }
+
+    /**
+     *  Write the central directory.
+     */
+    long directory_offset = std::ftell(out);
+    success = success && directory_offset >= 0;
+
+    for (int index = 0; index < count && success; ++index) {
+        const EntryStruct &entry = Entries[index];
+        const ZipResultStruct &result = results[index];
+
+        header.clear();
+        Put_Long(header, 0x02014B50);
+        Put_Word(header, 20);
+        Put_Word(header, 20);
+        Put_Word(header, 0);
+        Put_Word(header, entry.Store ? ZIP_METHOD_STORE : ZIP_METHOD_DEFLATE);
+        Put_Word(header, result.Time);
+        Put_Word(header, result.Date);
+        Put_Long(header, result.CRC);
+        Put_Long(header, result.CompressedSize);
+        Put_Long(header, result.Size);
+        Put_Word(header, (uint16_t)entry.Name.size());
+        Put_Word(header, 0);
+        Put_Word(header, 0);
+        Put_Word(header, 0);
+        Put_Word(header, 0);
+        Put_Long(header, 0);
+        Put_Long(header, result.Offset);
+        header.insert(header.end(), entry.Name.begin(), entry.Name.end());
+
+        success = Write_Buffer(out, header);
+    }
+
+    long directory_end = std::ftell(out);
+    success = success && directory_end >= 0;
+
+    if (success) {
+        header.clear();
+        Put_Long(header, 0x06054B50);
+        Put_Word(header, 0);
+        Put_Word(header, 0);
+        Put_Word(header, (uint16_t)count);
+        Put_Word(header, (uint16_t)count);
+        Put_Long(header, (uint32_t)(directory_end - directory_offset));
+        Put_Long(header, (uint32_t)directory_offset);
+        Put_Word(header, 0);
+
+        success = Write_Buffer(out, header);
+    }
+
+    /**
+     *  Stop any workers still running and clean up.
+     */
+    abort = true;
+    for (std::thread &thread : workers) {
+        thread.join();
+    }
+
+    for (int index : deflated) {
+        std::remove(results[index].TempFilename.c_str());
+    }
+
+    delete [] buffer;
+
+    success = (std::fclose(out) == 0) && success;
+
+    if (!success) {
+        std::remove(filename);
+    }
+
+    return success;
+}
@@ -0,0 +1,65 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          ZIPWRITER.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Writes zip archives, compressing the files in parallel.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+#include <string>
+#include <vector>
+
+
+/**
+ *  Builds a zip archive from files on disk.
+ *
+ *  Every file is streamed through fixed size buffers, so memory use does not
+ *  depend on the size of the files. Files to be compressed are deflated on
+ *  worker threads at the same time, each into a temporary file next to the
+ *  archive, and are then appended in order. Stored files are copied straight
+ *  into the archive.
+ */
+class ZipWriterClass
+{
+    public:
+        ZipWriterClass() : Entries() {}
+
+        void Add_File(const char *name, const char *filename, bool store = false);
+
+        bool Write(const char *filename, int threads = 0);
+
+    private:
+        struct EntryStruct
+        {
+            std::string Name;
+            std::string Filename;
+            bool Store;
+        };
+
+        std::vector<EntryStruct> Entries;
+};
+
+
+uint32_t Zip_CRC32(uint32_t crc, const void *data, int length);
@@ -0,0 +1,287 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          CRASHRECORD.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Fast capture of a compact binary crash record for offline analysis.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "crashrecord.h"
+#include "vinifera_gitinfo.h"
+#include <Windows.h>
+#include <winternl.h> // Must be after Windows.h!
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+
+bool FastCrashCapture = false;
+
+
+/**
+ *  The captured record. This is kept in static storage so capturing does not
+ *  need any stack space or heap allocation, either of which may be what
+ *  failed in the first place.
+ */
+static CrashRecordHeaderStruct CrashHeader;
+static uint32_t CrashFrames[CRASH_RECORD_FRAMES_MAX];
+static CrashRecordModuleStruct CrashModules[CRASH_RECORD_MODULES_MAX];
+
+
+/**
+ *  Walks the frame pointer chain of the current thread, validating each frame
+ *  against the thread's stack bounds rather than going through DbgHelp.
+ */
+static int Crash_Record_Walk_Stack(uint32_t eip, uint32_t ebp, uint32_t *frames, int max_frames)
+{
+    NT_TIB *tib = (NT_TIB *)NtCurrentTeb();
+    uintptr_t stack_low = (uintptr_t)tib->StackLimit;
+    uintptr_t stack_high = (uintptr_t)tib->StackBase;
+
+    int count = 0;
+    frames[count++] = eip;
+
+    uintptr_t frame = ebp;
+    while (count < max_frames) {
+
+        /**
+         *  Each frame holds the previous frame pointer followed by the return
+         *  address, so both must lie inside the stack.
+         */
+        if (frame < stack_low || frame + (sizeof(uint32_t) * 2) > stack_high || (frame & 3) != 0) {
+            break;
+        }
+
+        uint32_t *ptr = (uint32_t *)frame;
+        uint32_t next = ptr[0];
+        uint32_t retaddr = ptr[1];
+
+        if (retaddr == 0) {
+            break;
+        }
+
+        frames[count++] = retaddr;
+
+        /**
+         *  The stack grows down, so the chain must move upwards.
+         */
+        if (next <= frame) {
+            break;
+        }
+
+        frame = next;
+    }
+
+    return count;
+}
+
+
+/**
+ *  The loader's entry for a module, as far as it is needed here. The layout of
+ *  these leading fields has not changed since Windows NT, winternl.h only
+ *  hides the size of the image and the base name behind reserved fields.
+ */
+typedef struct CrashLoaderEntryStruct
+{
+    LIST_ENTRY InLoadOrderLinks;
+    LIST_ENTRY InMemoryOrderLinks;
+    LIST_ENTRY InInitializationOrderLinks;
+    void *DllBase;
+    void *EntryPoint;
+    ULONG SizeOfImage;
+    UNICODE_STRING FullDllName;
+    UNICODE_STRING BaseDllName;
+} CrashLoaderEntryStruct;
+
+
+/**
+ *  Records the base, size and build timestamp of each loaded module.
+ * 
+ *  The modules are read straight from the loader's list in the process
+ *  environment block. Unlike a toolhelp snapshot this does not allocate or
+ *  take the loader lock, either of which can deadlock or fail when the crash
+ *  happened inside the heap or the loader. The list is not locked, so the walk
+ *  is bounded and guarded in case another thread is loading or unloading a
+ *  module at the same time.
+ */
+static int Crash_Record_Collect_Modules(CrashRecordModuleStruct *modules, int max_modules)
+{
+    int count = 0;
+
+    __try {
+
+        PEB *peb = ((TEB *)NtCurrentTeb())->ProcessEnvironmentBlock;
+        if (!peb || !peb->Ldr) {
+            return 0;
+        }
+
+        LIST_ENTRY *head = &peb->Ldr->InMemoryOrderModuleList;
+        int steps = 0;
+
+        for (LIST_ENTRY *link = head->Flink; link && link != head && count < max_modules && steps < max_modules * 2; link = link->Flink, ++steps) {
+
+            CrashLoaderEntryStruct *entry = CONTAINING_RECORD(link, CrashLoaderEntryStruct, InMemoryOrderLinks);
+            if (!entry->DllBase) {
+                continue;
+            }
+
+            CrashRecordModuleStruct &module = modules[count];
+            module.Base = (uint32_t)(uintptr_t)entry->DllBase;
+            module.Size = entry->SizeOfImage;
+            module.TimeDateStamp = 0;
+
+            /**
+             *  The loader keeps the names as UTF-16, module names are plain
+             *  ASCII in practice so the high bytes are simply dropped.
+             */
+            int length = std::min<int>(entry->BaseDllName.Length / sizeof(WCHAR), sizeof(module.Name)-1);
+            for (int i = 0; i < length; ++i) {
+                WCHAR c = entry->BaseDllName.Buffer[i];
+                module.Name[i] = (c < 0x80) ? (char)c : '?';
+            }
+            module.Name[length] = '\0';
+
+            IMAGE_DOS_HEADER *dos = (IMAGE_DOS_HEADER *)entry->DllBase;
+            if (dos->e_magic == IMAGE_DOS_SIGNATURE) {
+                IMAGE_NT_HEADERS *nt = (IMAGE_NT_HEADERS *)((unsigned char *)entry->DllBase + dos->e_lfanew);
+                if (nt->Signature == IMAGE_NT_SIGNATURE) {
+                    module.TimeDateStamp = nt->FileHeader.TimeDateStamp;
+                }
+            }
+
+            ++count;
+        }
+
+    } __except (EXCEPTION_EXECUTE_HANDLER) {
+        /**
+         *  Keep the modules read before the list changed underneath us.
+         */
+    }
+
+    return count;
+}
+
+
+/**
+ *  Finds the module containing the address.
+ */
+static const CrashRecordModuleStruct *Crash_Record_Find_Module(uint32_t address)
+{
+    for (uint32_t i = 0; i < CrashHeader.ModuleCount; ++i) {
+        const CrashRecordModuleStruct &module = CrashModules[i];
+        if (address >= module.Base && address < module.Base + module.Size) {
+            return &module;
+        }
+    }
+    return nullptr;
+}
+
+
+/**
+ *  Captures the raw exception state; the registers, the frame addresses and
+ *  the loaded modules. No symbols are resolved, that is left to offline
+ *  analysis of the written record.
+ */
+bool Crash_Record_Capture(struct _EXCEPTION_POINTERS *e_info)
+{
+    if (!e_info) {
+        return false;
+    }
+
+    EXCEPTION_RECORD *record = e_info->ExceptionRecord;
+    CONTEXT *context = e_info->ContextRecord;
+
+    std::memset(&CrashHeader, 0, sizeof(CrashHeader));
+
+    CrashHeader.ID = CRASH_RECORD_ID;
+    CrashHeader.Version = CRASH_RECORD_VERSION;
+    CrashHeader.ExceptionCode = record->ExceptionCode;
+    CrashHeader.ExceptionAddress = (uint32_t)(uintptr_t)record->ExceptionAddress;
+
+    if (record->ExceptionCode == EXCEPTION_ACCESS_VIOLATION && record->NumberParameters >= 2) {
+        CrashHeader.AccessType = (uint32_t)record->ExceptionInformation[0];
+        CrashHeader.AccessAddress = (uint32_t)record->ExceptionInformation[1];
+    }
+
+    CrashHeader.Eip = context->Eip;
+    CrashHeader.Esp = context->Esp;
+    CrashHeader.Ebp = context->Ebp;
+
+    std::strncpy(CrashHeader.BuildHash, Vinifera_Git_Hash(), sizeof(CrashHeader.BuildHash)-1);
+
+    CrashHeader.FrameCount = Crash_Record_Walk_Stack(context->Eip, context->Ebp, CrashFrames, CRASH_RECORD_FRAMES_MAX);
+    CrashHeader.ModuleCount = Crash_Record_Collect_Modules(CrashModules, CRASH_RECORD_MODULES_MAX);
+
+    return true;
+}
+
+
+/**
+ *  Writes the captured record to a file.
+ */
+bool Crash_Record_Write(const char *filename)
+{
+    if (CrashHeader.ID != CRASH_RECORD_ID) {
+        return false;
+    }
+
+    HANDLE handle = CreateFileA(filename, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    DWORD written = 0;
+    BOOL ok = WriteFile(handle, &CrashHeader, sizeof(CrashHeader), &written, nullptr);
+    ok = ok && WriteFile(handle, CrashFrames, sizeof(uint32_t) * CrashHeader.FrameCount, &written, nullptr);
+    ok = ok && WriteFile(handle, CrashModules, sizeof(CrashRecordModuleStruct) * CrashHeader.ModuleCount, &written, nullptr);
+
+    CloseHandle(handle);
+
+    return ok != FALSE;
+}
+
+
+/**
+ *  Prints the captured frames as raw addresses with their module and offset,
+ *  in place of the symbolised call stack.
+ */
+void Crash_Record_Dump_Stack(stackcallback_ptr_t callback)
+{
+    if (callback == nullptr) {
+        return;
+    }
+
+    char buffer[256];
+
+    callback("Call Stack:\r\n");
+
+    for (uint32_t i = 0; i < CrashHeader.FrameCount; ++i) {
+        uint32_t address = CrashFrames[i];
+        const CrashRecordModuleStruct *module = Crash_Record_Find_Module(address);
+        if (module) {
+            std::snprintf(buffer, sizeof(buffer), "  0x%08X %s+0x%X\r\n", address, module->Name, address - module->Base);
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "  0x%08X <Unknown>\r\n", address);
+        }
+        callback(buffer);
+    }
+}
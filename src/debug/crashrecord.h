@@ -0,0 +1,88 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          CRASHRECORD.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Fast capture of a compact binary crash record for offline analysis.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+#include "stackdump.h"
+#include <Windows.h>
+
+
+/**
+ *  Identifies a crash record file and its layout.
+ */
+#define CRASH_RECORD_ID         0x53524356 // "VCRS"
+#define CRASH_RECORD_VERSION    1
+
+#define CRASH_RECORD_FRAMES_MAX     64
+#define CRASH_RECORD_MODULES_MAX    128
+
+
+/**
+ *  A loaded module at the time of the crash. The timestamp and image size
+ *  from the PE header identify the exact build, so the matching symbols can
+ *  be found when the record is analysed offline.
+ */
+typedef struct CrashRecordModuleStruct
+{
+    uint32_t Base;
+    uint32_t Size;
+    uint32_t TimeDateStamp;
+    char Name[64];
+} CrashRecordModuleStruct;
+
+
+/**
+ *  The crash record header, followed by "FrameCount" frame addresses
+ *  and then "ModuleCount" module entries.
+ */
+typedef struct CrashRecordHeaderStruct
+{
+    uint32_t ID;
+    uint32_t Version;
+    uint32_t ExceptionCode;
+    uint32_t ExceptionAddress;
+    uint32_t AccessType;
+    uint32_t AccessAddress;
+    uint32_t Eip;
+    uint32_t Esp;
+    uint32_t Ebp;
+    uint32_t FrameCount;
+    uint32_t ModuleCount;
+    char BuildHash[48];
+} CrashRecordHeaderStruct;
+
+
+/**
+ *  Capture only raw addresses on an exception, skipping symbol resolution?
+ */
+extern bool FastCrashCapture;
+
+
+bool Crash_Record_Capture(struct _EXCEPTION_POINTERS *e_info);
+bool Crash_Record_Write(const char *filename);
+void Crash_Record_Dump_Stack(stackcallback_ptr_t callback);
@@ -27,6 +27,7 @@
  ******************************************************************************/
 #include "exceptionhandler.h"
 #include "stackdump.h"
+#include "crashrecord.h"
 #include "minidump.h"
 #include "cpudetect.h"
 #include "buildnum.h"
@@ -120,19 +121,25 @@ void Clear_All_Surfaces()
 
 
 /**
- *  Finds the first instance of the address in the loaded database and extracts its info.
+ *  Finds the database entry covering the address and extracts its info.
+ * 
+ *  The database is sorted by start address, so this binary searches for the
+ *  last entry starting at or before the address, then steps back over any
+ *  earlier entries whose range could still reach it. The entry with the
+ *  closest start address wins, ties going to the first one listed.
  */
 static bool Exception_Find_Datbase_Entry(uintptr_t address, bool &can_continue, bool &ignore, FixedString<1024> &desc)
 {
-    for (int i = 0; i < ExceptionInfoDatabase.Count(); ++i) {
-        if (ExceptionInfoDatabase[i].Address == address) {
-            can_continue = ExceptionInfoDatabase[i].CanContinue;
-            ignore = ExceptionInfoDatabase[i].Ignore;
-            desc = ExceptionInfoDatabase[i].Description;
-            return true;
-        }
+    const ExceptionInfoDatabaseStruct *found = ExceptionInfoDatabase.Find(address);
+
+    if (!found) {
+        return false;
     }
-    return false;
+
+    can_continue = found->CanContinue;
+    ignore = found->Ignore;
+    desc = found->Description;
+    return true;
 }
 
 
@@ -302,7 +309,15 @@ static void Dump_Exception_Info(unsigned int e_code, struct _EXCEPTION_POINTERS
      */
     ExceptionBuffer.Clear();
 
-    Init_Symbol_Info();
+    /**
+     *  In fast capture mode only the raw addresses are recorded, so avoid
+     *  loading the symbols entirely.
+     */
+    if (FastCrashCapture) {
+        Crash_Record_Capture(e_info);
+    } else {
+        Init_Symbol_Info();
+    }
 
     EXCEPTION_RECORD *record = e_info->ExceptionRecord;
     CONTEXT *context = e_info->ContextRecord;
@@ -400,7 +415,11 @@ static void Dump_Exception_Info(unsigned int e_code, struct _EXCEPTION_POINTERS
 
     int stack_skip_frames = 1; // #TODO: This needs checking. Value of 1 skips the EIP address, which seems ideal.
 
-    Stack_Dump_From_Context(context->Eip, context->Esp, context->Ebp, Exception_Stack_Dump_Handler, stack_skip_frames);
+    if (FastCrashCapture) {
+        Crash_Record_Dump_Stack(Exception_Stack_Dump_Handler);
+    } else {
+        Stack_Dump_From_Context(context->Eip, context->Esp, context->Ebp, Exception_Stack_Dump_Handler, stack_skip_frames);
+    }
 
     Exception_Printf("\r\n");
 
@@ -927,6 +946,19 @@ LONG Vinifera_Exception_Handler(unsigned int e_code, struct _EXCEPTION_POINTERS
          */
         ExceptionFile.Write(ExceptionBuffer.Peek_Buffer(), ExceptionBuffer.Get_Length());
 
+        /**
+         *  Write the binary crash record alongside the log for offline symbolisation.
+         */
+        if (FastCrashCapture) {
+            std::snprintf(filename_buffer, sizeof(filename_buffer), "%s\\CRASH_%02u-%02u-%04u_%02u-%02u-%02u.BIN",
+                Vinifera_DebugDirectory,
+                Execute_Day, Execute_Month, Execute_Year, Execute_Hour, Execute_Min, Execute_Sec);
+
+            if (!Crash_Record_Write(filename_buffer)) {
+                DEBUG_WARNING("Failed to write the crash record!\n");
+            }
+        }
+
         if (LastExceptionCRC && CurrentExceptionCRC == LastExceptionCRC) {
             DEBUG_WARNING("Exception dump is identical to the previous exception!\n");
         }
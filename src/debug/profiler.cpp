@@ -0,0 +1,292 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          PROFILER.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Lightweight scoped timers for profiling the main loop.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "profiler.h"
+#include "debughandler.h"
+#include <Windows.h>
+#include <cstdio>
+#include <cstring>
+
+
+/**
+ *  The maximum number of timed events kept for the trace output. Once full,
+ *  the oldest events are overwritten.
+ */
+#define PROFILE_EVENTS_MAX 16384
+
+
+/**
+ *  A single timed event.
+ */
+typedef struct ProfileEventStruct
+{
+    uint64_t Start;
+    uint64_t End;
+    unsigned long ThreadID;
+    ProfileSectionType Section;
+} ProfileEventStruct;
+
+
+static const char *ProfileSectionNames[PROFILE_COUNT] = {
+    "Frame",
+    "Map Render",
+    "Render Post",
+    "EBolts",
+    "Super Timers",
+    "House AI",
+    "Factory AI",
+    "Rules Reload"
+};
+
+
+static ProfileEventStruct ProfileEvents[PROFILE_EVENTS_MAX];
+static int ProfileEventHead = 0;
+static int ProfileEventCount = 0;
+
+static uint64_t ProfileFrameTicks[PROFILE_COUNT];
+static float ProfileHistory[PROFILE_HISTORY_MAX][PROFILE_COUNT];
+static int ProfileHistoryHead = 0;
+static int ProfileHistoryCount = 0;
+
+
+/**
+ *  Fetches the performance counter frequency, in ticks per millisecond.
+ */
+static double Profiler_Ticks_Per_Millisecond()
+{
+    static double _ticks_per_ms = 0.0;
+
+    if (_ticks_per_ms == 0.0) {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        _ticks_per_ms = double(frequency.QuadPart) / 1000.0;
+    }
+
+    return _ticks_per_ms;
+}
+
+
+/**
+ *  Fetches the current high resolution timestamp.
+ * 
+ *  @author: agent
+ */
+uint64_t Profiler_Timestamp()
+{
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+}
+
+
+/**
+ *  Records a timed event for the section, ending now.
+ * 
+ *  @author: agent
+ */
+void Profiler_Record(ProfileSectionType section, uint64_t start)
+{
+    uint64_t end = Profiler_Timestamp();
+
+    ProfileEventStruct &event = ProfileEvents[ProfileEventHead];
+    event.Start = start;
+    event.End = end;
+    event.ThreadID = GetCurrentThreadId();
+    event.Section = section;
+
+    ProfileEventHead = (ProfileEventHead + 1) % PROFILE_EVENTS_MAX;
+    if (ProfileEventCount < PROFILE_EVENTS_MAX) {
+        ++ProfileEventCount;
+    }
+
+    ProfileFrameTicks[section] += (end - start);
+}
+
+
+/**
+ *  Moves the section times accumulated this frame into the history.
+ * 
+ *  @author: agent
+ */
+void Profiler_End_Frame()
+{
+    if (!Vinifera_Developer_Profiler) {
+        return;
+    }
+
+    const double ticks_per_ms = Profiler_Ticks_Per_Millisecond();
+
+    for (int section = PROFILE_FIRST; section < PROFILE_COUNT; ++section) {
+        ProfileHistory[ProfileHistoryHead][section] = float(double(ProfileFrameTicks[section]) / ticks_per_ms);
+        ProfileFrameTicks[section] = 0;
+    }
+
+    ProfileHistoryHead = (ProfileHistoryHead + 1) % PROFILE_HISTORY_MAX;
+    if (ProfileHistoryCount < PROFILE_HISTORY_MAX) {
+        ++ProfileHistoryCount;
+    }
+}
+
+
+/**
+ *  Clears all recorded events and history.
+ * 
+ *  @author: agent
+ */
+void Profiler_Reset()
+{
+    ProfileEventHead = 0;
+    ProfileEventCount = 0;
+    ProfileHistoryHead = 0;
+    ProfileHistoryCount = 0;
+
+    std::memset(ProfileFrameTicks, 0, sizeof(ProfileFrameTicks));
+    std::memset(ProfileHistory, 0, sizeof(ProfileHistory));
+}
+
+
+const char *Profiler_Section_Name(ProfileSectionType section)
+{
+    return ProfileSectionNames[section];
+}
+
+
+int Profiler_History_Count()
+{
+    return ProfileHistoryCount;
+}
+
+
+/**
+ *  Fetches the time (in milliseconds) the section took in a previous frame.
+ * 
+ *  @author: agent
+ */
+float Profiler_Frame_Time(ProfileSectionType section, int frames_ago)
+{
+    if (frames_ago < 0 || frames_ago >= ProfileHistoryCount) {
+        return 0.0f;
+    }
+
+    int index = (ProfileHistoryHead - 1 - frames_ago + PROFILE_HISTORY_MAX) % PROFILE_HISTORY_MAX;
+
+    return ProfileHistory[index][section];
+}
+
+
+/**
+ *  Fetches the average time (in milliseconds) the section took over the history.
+ * 
+ *  @author: agent
+ */
+float Profiler_Average_Time(ProfileSectionType section)
+{
+    if (!ProfileHistoryCount) {
+        return 0.0f;
+    }
+
+    float total = 0.0f;
+    for (int i = 0; i < ProfileHistoryCount; ++i) {
+        total += ProfileHistory[i][section];
+    }
+
+    return total / ProfileHistoryCount;
+}
+
+
+/**
+ *  Fetches the longest time (in milliseconds) the section took over the history.
+ * 
+ *  @author: agent
+ */
+float Profiler_Peak_Time(ProfileSectionType section)
+{
+    float peak = 0.0f;
+    for (int i = 0; i < ProfileHistoryCount; ++i) {
+        if (ProfileHistory[i][section] > peak) {
+            peak = ProfileHistory[i][section];
+        }
+    }
+
+    return peak;
+}
+
+
+/**
+ *  Writes the recorded events to a file in the Chrome trace event format,
+ *  this can be viewed with "chrome://tracing" or Perfetto.
+ * 
+ *  @author: agent
+ */
+bool Profiler_Write_Trace(const char *filename)
+{
+    FILE *fp = std::fopen(filename, "w");
+    if (fp == nullptr) {
+        DEBUG_ERROR("Failed to open profiler trace file for writing!\n");
+        return false;
+    }
+
+    const double ticks_per_us = Profiler_Ticks_Per_Millisecond() / 1000.0;
+    const int first = (ProfileEventHead - ProfileEventCount + PROFILE_EVENTS_MAX) % PROFILE_EVENTS_MAX;
+
+    /**
+     *  Events are recorded when they end, so an enclosing event is stored after
+     *  the events nested within it. Find the earliest start to use as time zero.
+     */
+    uint64_t base = ProfileEventCount ? ProfileEvents[first].Start : 0;
+    for (int i = 0; i < ProfileEventCount; ++i) {
+        const ProfileEventStruct &event = ProfileEvents[(first + i) % PROFILE_EVENTS_MAX];
+        if (event.Start < base) {
+            base = event.Start;
+        }
+    }
+
+    std::fprintf(fp, "{\"traceEvents\":[\n");
+
+    for (int i = 0; i < ProfileEventCount; ++i) {
+        const ProfileEventStruct &event = ProfileEvents[(first + i) % PROFILE_EVENTS_MAX];
+
+        double start = double(event.Start - base) / ticks_per_us;
+        double duration = double(event.End - event.Start) / ticks_per_us;
+
+        std::fprintf(fp, "{\"name\":\"%s\",\"cat\":\"vinifera\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lu,\"tid\":%lu}%s\n",
+            ProfileSectionNames[event.Section],
+            start,
+            duration,
+            GetCurrentProcessId(),
+            event.ThreadID,
+            (i < ProfileEventCount-1) ? "," : "");
+    }
+
+    std::fprintf(fp, "],\"displayTimeUnit\":\"ms\"}\n");
+
+    std::fclose(fp);
+
+    DEBUG_INFO("Profiler: Wrote %d events to %s.\n", ProfileEventCount, filename);
+
+    return true;
+}
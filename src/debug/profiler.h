@@ -0,0 +1,101 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          PROFILER.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Lightweight scoped timers for profiling the main loop.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+#include "vinifera_globals.h"
+
+
+/**
+ *  The sections of the main loop that are instrumented.
+ */
+enum ProfileSectionType
+{
+    PROFILE_FRAME,              // The whole game frame (Main_Loop).
+    PROFILE_MAP_RENDER,         // Map.Render() when in frame step mode.
+    PROFILE_RENDER_POST,        // TacticalExtension::Render_Post().
+    PROFILE_EBOLTS,             // EBoltClass::Draw_All().
+    PROFILE_SUPER_TIMERS,       // TacticalExtension::Draw_Super_Timers().
+    PROFILE_HOUSE_AI,           // HouseClass::Expert_AI().
+    PROFILE_FACTORY_AI,         // FactoryClass::AI().
+    PROFILE_RULES_RELOAD,       // Developer rules reloading.
+
+    PROFILE_COUNT,
+
+    PROFILE_FIRST = PROFILE_FRAME
+};
+
+
+/**
+ *  The number of frames kept for the frame time graph and breakdown.
+ */
+#define PROFILE_HISTORY_MAX 128
+
+
+uint64_t Profiler_Timestamp();
+void Profiler_Record(ProfileSectionType section, uint64_t start);
+void Profiler_End_Frame();
+void Profiler_Reset();
+
+const char *Profiler_Section_Name(ProfileSectionType section);
+int Profiler_History_Count();
+float Profiler_Frame_Time(ProfileSectionType section, int frames_ago);
+float Profiler_Average_Time(ProfileSectionType section);
+float Profiler_Peak_Time(ProfileSectionType section);
+
+bool Profiler_Write_Trace(const char *filename);
+
+
+/**
+ *  Times the scope it is declared in. When the profiler is disabled this
+ *  costs a single flag test on entry and exit.
+ */
+class ProfileScopeClass
+{
+    public:
+        ProfileScopeClass(ProfileSectionType section) :
+            Section(section),
+            Start(Vinifera_Developer_Profiler ? Profiler_Timestamp() : 0)
+        {
+        }
+
+        ~ProfileScopeClass()
+        {
+            if (Start) {
+                Profiler_Record(Section, Start);
+            }
+        }
+
+    private:
+        ProfileScopeClass(const ProfileScopeClass &) = delete;
+        ProfileScopeClass &operator=(const ProfileScopeClass &) = delete;
+
+    private:
+        ProfileSectionType Section;
+        uint64_t Start;
+};
@@ -36,6 +36,7 @@
 #include "particle.h"
 #include "particletype.h"
 #include "particlesys.h"
+#include "particlesysext_hooks.h"
 #include "target.h"
 #include "cell.h"
 #include "rules.h"
@@ -120,6 +121,11 @@ static void Anim_Spawn_Particles(AnimClass *this_ptr)
     animtypeext = Extension::Fetch<AnimTypeClassExtension>(this_ptr->Class);
     if (animtypeext->ParticleToSpawn != PARTICLE_NONE) {
 
+        /**
+         *  Make room in the particle tracker for the whole batch at once.
+         */
+        Particle_Tracker_Presize(animtypeext->NumberOfParticles);
+
         for (int i = 0; i < animtypeext->NumberOfParticles; ++i) {
 
             Coordinate spawn_coord = this_ptr->Coord;
@@ -0,0 +1,90 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          BUILDABLESCACHE.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Caches the objects a house can build between factory updates.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "buildablescache.h"
+
+
+BuildablesCacheClass::BuildablesCacheClass(int list_count, TechStateFunc tech_state, BuildFunc build) :
+    TechStateCalc(tech_state),
+    Build(build),
+    Lists(list_count),
+    TechStateHouse(nullptr),
+    TechStateFrame(-1),
+    TechStateQuick(0),
+    TechState(0)
+{
+    Invalidate();
+}
+
+
+/**
+ *  Fetches the objects the house can build for the list. The full tech state
+ *  is calculated at most once per frame unless the quick state changes, and
+ *  the list is only rebuilt when the full tech state has changed.
+ *
+ *  @author: agent
+ */
+const std::vector<int> &BuildablesCacheClass::Fetch(void *house, int list, int frame, uint32_t quick_state)
+{
+    if (TechStateFrame != frame || TechStateHouse != house || TechStateQuick != quick_state) {
+        TechState = TechStateCalc(house);
+        TechStateHouse = house;
+        TechStateFrame = frame;
+        TechStateQuick = quick_state;
+    }
+
+    ListStruct &cache = Lists[list];
+
+    if (!cache.IsValid || cache.House != house || cache.TechState != TechState) {
+        cache.Buildables.clear();
+        Build(house, list, cache.Buildables);
+        cache.House = house;
+        cache.TechState = TechState;
+        cache.IsValid = true;
+    }
+
+    return cache.Buildables;
+}
+
+
+/**
+ *  Forces the lists to be rebuilt on the next fetch.
+ *
+ *  @author: agent
+ */
+void BuildablesCacheClass::Invalidate()
+{
+    TechStateHouse = nullptr;
+    TechStateFrame = -1;
+
+    for (ListStruct &cache : Lists) {
+        cache.House = nullptr;
+        cache.TechState = 0;
+        cache.IsValid = false;
+        cache.Buildables.clear();
+    }
+}
@@ -0,0 +1,90 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          BUILDABLESCACHE.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Caches the objects a house can build between factory updates.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+#include <vector>
+
+
+/**
+ *  Caches the lists of objects a house can build, one list for each kind of
+ *  factory, so a house with many factories only works them out once.
+ *
+ *  A list is reused while the tech state of the house is unchanged. The full
+ *  tech state is a hash over everything that decides what can be built and
+ *  is only calculated once per frame; within a frame a cheap quick state is
+ *  compared instead, which must change whenever the full state might have.
+ *  Events that the quick state does not see must call Invalidate.
+ */
+class BuildablesCacheClass
+{
+    public:
+        /**
+         *  Calculates the full tech state of the house.
+         */
+        typedef uint32_t (*TechStateFunc)(void *house);
+
+        /**
+         *  Fills the list with the objects the house can build.
+         */
+        typedef void (*BuildFunc)(void *house, int list, std::vector<int> &buildables);
+
+        BuildablesCacheClass(int list_count, TechStateFunc tech_state, BuildFunc build);
+
+        const std::vector<int> &Fetch(void *house, int list, int frame, uint32_t quick_state);
+        void Invalidate();
+
+        /**
+         *  Mixes a value into a tech state hash (FNV-1a) started from HASH_START.
+         */
+        static void Hash(uint32_t &hash, int value) { hash = (hash ^ uint32_t(value)) * 16777619U; }
+
+        static const uint32_t HASH_START = 2166136261U;
+
+    private:
+        struct ListStruct
+        {
+            void *House;
+            uint32_t TechState;
+            bool IsValid;
+            std::vector<int> Buildables;
+        };
+
+        TechStateFunc TechStateCalc;
+        BuildFunc Build;
+
+        std::vector<ListStruct> Lists;
+
+        /**
+         *  The tech state of the house calculated this frame.
+         */
+        void *TechStateHouse;
+        int TechStateFrame;
+        uint32_t TechStateQuick;
+        uint32_t TechState;
+};
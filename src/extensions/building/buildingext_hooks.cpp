@@ -26,6 +26,7 @@
  *
  ******************************************************************************/
 #include "buildingext_hooks.h"
+#include "buildablescache.h"
 #include "buildingext_init.h"
 #include "buildingext.h"
 #include "buildingtypeext.h"
@@ -64,6 +65,7 @@
 #include "asserthandler.h"
 #include "debughandler.h"
 #include "session.h"
+#include "vinifera_globals.h"
 
 #include "hooker.h"
 #include "hooker_macros.h"
@@ -107,6 +109,178 @@ bool BuildingClassExt::_Can_Have_Rally_Point()
 }
 
 
+/**
+ *  Mixes a value into a tech state hash.
+ *
+ *  @author: agent
+ */
+static inline void Buildables_Hash(uint32_t &hash, int value)
+{
+    BuildablesCacheClass::Hash(hash, value);
+}
+
+
+/**
+ *  Calculates a hash of everything that decides what a house can build;
+ *  the number of each object it owns (prerequisites, factories and build
+ *  limits), its power, its tech level and the side it acts like, the build
+ *  cheat and the size of the type lists.
+ *
+ *  This is only proportional to the number of types, unlike the Can_Build
+ *  and Who_Can_Build_Me checks which scan the owned buildings for every type.
+ *
+ *  @author: agent
+ */
+static uint32_t Buildables_Tech_State(void *param)
+{
+    HouseClass *house = (HouseClass *)param;
+    uint32_t hash = BuildablesCacheClass::HASH_START;
+
+    Buildables_Hash(hash, Vinifera_DeveloperMode && Vinifera_Developer_BuildCheat);
+    Buildables_Hash(hash, house->Power);
+    Buildables_Hash(hash, house->Drain);
+    Buildables_Hash(hash, house->Control.TechLevel);
+    Buildables_Hash(hash, house->ActLike);
+
+    Buildables_Hash(hash, BuildingTypes.Count());
+    for (int i = 0; i < BuildingTypes.Count(); ++i) {
+        Buildables_Hash(hash, house->BQuantity.Count_Of((BuildingType)i));
+    }
+
+    Buildables_Hash(hash, UnitTypes.Count());
+    for (int i = 0; i < UnitTypes.Count(); ++i) {
+        Buildables_Hash(hash, house->UQuantity.Count_Of((UnitType)i));
+    }
+
+    Buildables_Hash(hash, InfantryTypes.Count());
+    for (int i = 0; i < InfantryTypes.Count(); ++i) {
+        Buildables_Hash(hash, house->IQuantity.Count_Of((InfantryType)i));
+    }
+
+    Buildables_Hash(hash, AircraftTypes.Count());
+    for (int i = 0; i < AircraftTypes.Count(); ++i) {
+        Buildables_Hash(hash, house->AQuantity.Count_Of((AircraftType)i));
+    }
+
+    return hash;
+}
+
+
+/**
+ *  Calculates a hash of the parts of the tech state that are cheap to check;
+ *  the house's power, tech level and number of buildings, and the number of
+ *  objects in the game. Any object being created or destroyed changes this,
+ *  as does the house gaining or losing a building to a capture.
+ *
+ *  @author: agent
+ */
+static uint32_t Buildables_Quick_Tech_State(HouseClass *house)
+{
+    uint32_t hash = BuildablesCacheClass::HASH_START;
+
+    Buildables_Hash(hash, house->Power);
+    Buildables_Hash(hash, house->Drain);
+    Buildables_Hash(hash, house->Control.TechLevel);
+    Buildables_Hash(hash, house->CurBuildings);
+    Buildables_Hash(hash, Buildings.Count());
+    Buildables_Hash(hash, Units.Count());
+    Buildables_Hash(hash, Infantry.Count());
+    Buildables_Hash(hash, Aircrafts.Count());
+
+    return hash;
+}
+
+
+/**
+ *  Works out the objects of the given type the house can build.
+ *
+ *  @author: agent
+ */
+static void Buildables_Build(void *param, int list, std::vector<int> &buildables)
+{
+    HouseClass *house = (HouseClass *)param;
+    RTTIType rtti = (RTTIType)list;
+
+    switch (rtti)
+    {
+    case RTTI_AIRCRAFTTYPE:
+        for (int i = 0; i < AircraftTypes.Count(); i++)
+        {
+            if (house->Can_Build(AircraftTypes[i], false, true) && AircraftTypes[i]->Who_Can_Build_Me(true, false, false, house) != nullptr)
+            {
+                buildables.push_back(i);
+            }
+        }
+        break;
+
+    case RTTI_BUILDINGTYPE:
+        for (int i = 0; i < BuildingTypes.Count(); i++)
+        {
+            if (house->Can_Build(BuildingTypes[i], false, true) && BuildingTypes[i]->Who_Can_Build_Me(true, false, false, house) != nullptr)
+            {
+                buildables.push_back(i);
+            }
+        }
+        break;
+
+    case RTTI_INFANTRYTYPE:
+        for (int i = 0; i < InfantryTypes.Count(); i++)
+        {
+            if (house->Can_Build(InfantryTypes[i], false, true) && InfantryTypes[i]->Who_Can_Build_Me(true, false, false, house) != nullptr)
+            {
+                buildables.push_back(i);
+            }
+        }
+        break;
+
+    case RTTI_UNITTYPE:
+        for (int i = 0; i < UnitTypes.Count(); i++)
+        {
+            if (house->Can_Build(UnitTypes[i], false, true) && UnitTypes[i]->Who_Can_Build_Me(true, false, false, house) != nullptr)
+            {
+                buildables.push_back(i);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+/**
+ *  The buildable objects of the player house for each object type.
+ */
+static BuildablesCacheClass BuildablesCache(RTTI_COUNT, Buildables_Tech_State, Buildables_Build);
+
+
+/**
+ *  Fetches the objects of the given type the house can build. The list is only
+ *  recalculated when the tech state of the house has changed, so a house with
+ *  many factories only does the full scan once.
+ *
+ *  @author: agent
+ */
+static const std::vector<int> &Buildables_Fetch(HouseClass *house, RTTIType rtti)
+{
+    return BuildablesCache.Fetch(house, rtti, Frame, Buildables_Quick_Tech_State(house));
+}
+
+
+/**
+ *  Forces the buildable objects to be recalculated on the next update. This
+ *  must be called for any change to what can be built that the quick tech
+ *  state does not see, such as an object changing owner.
+ *
+ *  @author: agent
+ */
+void Buildables_Cache_Invalidate()
+{
+    BuildablesCache.Invalidate();
+}
+
+
 /**
  *  Makes the game check whether you can actually build the object before adding it to the sidebar,
  *  preventing grayed out cameos (except for build limited types)
@@ -122,44 +296,17 @@ void BuildingClassExt::_Update_Buildables()
         switch (Class->ToBuild)
         {
         case RTTI_AIRCRAFTTYPE:
-            for (int i = 0; i < AircraftTypes.Count(); i++)
-            {
-                if (PlayerPtr->Can_Build(AircraftTypes[i], false, true) && AircraftTypes[i]->Who_Can_Build_Me(true, false, false, PlayerPtr) != nullptr)
-                {
-                    Map.Add(RTTI_AIRCRAFTTYPE, i);
-                }
-            }
-            break;
-
         case RTTI_BUILDINGTYPE:
-            for (int i = 0; i < BuildingTypes.Count(); i++)
-            {
-                if (PlayerPtr->Can_Build(BuildingTypes[i], false, true) && BuildingTypes[i]->Who_Can_Build_Me(true, false, false, PlayerPtr) != nullptr)
-                {
-                    Map.Add(RTTI_BUILDINGTYPE, i);
-                }
-            }
-            break;
-
         case RTTI_INFANTRYTYPE:
-            for (int i = 0; i < InfantryTypes.Count(); i++)
-            {
-                if (PlayerPtr->Can_Build(InfantryTypes[i], false, true) && InfantryTypes[i]->Who_Can_Build_Me(true, false, false, PlayerPtr) != nullptr)
-                {
-                    Map.Add(RTTI_INFANTRYTYPE, i);
-                }
-            }
-            break;
-
         case RTTI_UNITTYPE:
-            for (int i = 0; i < UnitTypes.Count(); i++)
+        {
+            const std::vector<int> &buildables = Buildables_Fetch(PlayerPtr, Class->ToBuild);
+            for (int i = 0; i < (int)buildables.size(); i++)
             {
-                if (PlayerPtr->Can_Build(UnitTypes[i], false, true) && UnitTypes[i]->Who_Can_Build_Me(true, false, false, PlayerPtr) != nullptr)
-                {
-                    Map.Add(RTTI_UNITTYPE, i);
-                }
+                Map.Add(Class->ToBuild, buildables[i]);
             }
             break;
+        }
 
         default:
             break;
@@ -29,3 +29,5 @@
 
 
 void BuildingClassExtension_Hooks();
+
+void Buildables_Cache_Invalidate();
@@ -27,6 +27,7 @@
  ******************************************************************************/
 #include "cellext_hooks.h"
 #include "cellext_const.h"
+#include "shapeexpand.h"
 #include "tibsun_globals.h"
 #include "session.h"
 #include "rules.h"
@@ -36,11 +37,79 @@
 #include "fatal.h"
 #include "debughandler.h"
 #include "asserthandler.h"
+#include <vector>
 
 #include "hooker.h"
 #include "hooker_macros.h"
 
 
+/**
+ *  Retrieves a shape from the cached mix files, along with the size of its
+ *  entry so the shape data can be checked against it.
+ * 
+ *  @author: agent
+ */
+static const unsigned char *Cell_Retrieve_Shape(const char *filename, size_t &size)
+{
+	void *data = nullptr;
+	long entry_size = 0;
+
+	size = 0;
+
+	if (!MFCC::Offset(filename, &data, nullptr, nullptr, &entry_size) || !data || entry_size <= 0) {
+		return nullptr;
+	}
+
+	size = (size_t)entry_size;
+
+	return (const unsigned char *)data;
+}
+
+
+/**
+ *  The shroud and fog shapes used for single player games.
+ */
+static const ShapeFileStruct *Cell_LoadedShroudShape = nullptr;
+static const ShapeFileStruct *Cell_LoadedFogShape = nullptr;
+static std::vector<unsigned char> Cell_ExpandedShroudShape;
+static std::vector<unsigned char> Cell_ExpandedFogShape;
+
+
+/**
+ *  Performs a one-time load of the shroud and fog shapes, expanding any
+ *  compressed frames so the decode is not repeated for every cell drawn.
+ * 
+ *  @author: agent
+ */
+static void Cell_Load_Shroud_Fog_Shapes()
+{
+	static bool _one_time = false;
+
+	if (_one_time) {
+		return;
+	}
+
+	size_t shroud_size;
+	size_t fog_size;
+	const unsigned char *shroud_shape = Cell_Retrieve_Shape("SHROUD.SHP", shroud_size);
+	const unsigned char *fog_shape = Cell_Retrieve_Shape("FOG.SHP", fog_size);
+
+	Cell_LoadedShroudShape = Shape_Expand(shroud_shape, shroud_size, Cell_ExpandedShroudShape)
+		? (const ShapeFileStruct *)&Cell_ExpandedShroudShape[0]
+		: (const ShapeFileStruct *)shroud_shape;
+
+	Cell_LoadedFogShape = Shape_Expand(fog_shape, fog_size, Cell_ExpandedFogShape)
+		? (const ShapeFileStruct *)&Cell_ExpandedFogShape[0]
+		: (const ShapeFileStruct *)fog_shape;
+
+	DEBUG_INFO("Cell: Shroud shape %s, fog shape %s.\n",
+		Cell_ExpandedShroudShape.empty() ? "used as is" : "expanded",
+		Cell_ExpandedFogShape.empty() ? "used as is" : "expanded");
+
+	_one_time = true;
+}
+
+
 /**
  *  #issue-381
  * 
@@ -50,10 +119,6 @@
  */
 DECLARE_PATCH(_CellClass_Draw_Shroud_Fog_Patch)
 {
-	static bool _shroud_one_time = false;
-	static const ShapeFileStruct *_shroud_shape;
-	static const ShapeFileStruct *_fog_shape;
-
 	/**
 	 *  Stolen bytes/code.
 	 */
@@ -62,11 +127,7 @@ DECLARE_PATCH(_CellClass_Draw_Shroud_Fog_Patch)
 	/**
 	 *  Perform a one-time load of the shroud and fog shape data.
 	 */
-	if (!_shroud_one_time) {
-		_shroud_shape = (const ShapeFileStruct *)MFCC::Retrieve("SHROUD.SHP");
-		_fog_shape = (const ShapeFileStruct *)MFCC::Retrieve("FOG.SHP");
-		_shroud_one_time = true;
-	}
+	Cell_Load_Shroud_Fog_Shapes();
 
 	/**
 	 *  If we are playing a multiplayer game, use the hardcoded shape data.
@@ -76,8 +137,8 @@ DECLARE_PATCH(_CellClass_Draw_Shroud_Fog_Patch)
 		Cell_FogShape = (const ShapeFileStruct *)&FogShapeBinary;
 
 	} else {
-		Cell_ShroudShape = _shroud_shape;
-		Cell_FogShape = _fog_shape;
+		Cell_ShroudShape = Cell_LoadedShroudShape;
+		Cell_FogShape = Cell_LoadedFogShape;
 	}
 
 	/**
@@ -97,9 +158,6 @@ continue_function:
  */
 DECLARE_PATCH(_CellClass_Draw_Fog_Patch)
 {
-	static bool _fog_one_time = false;
-	static const ShapeFileStruct *_fog_shape;
-	
 	/**
 	 *  Stolen bytes/code.
 	 */
@@ -108,10 +166,7 @@ DECLARE_PATCH(_CellClass_Draw_Fog_Patch)
 	/**
 	 *  Perform a one-time load of the fog shape data.
 	 */
-	if (!_fog_one_time) {
-		_fog_shape = (const ShapeFileStruct *)MFCC::Retrieve("FOG.SHP");
-		_fog_one_time = true;
-	}
+	Cell_Load_Shroud_Fog_Shapes();
 
 	/**
 	 *  If we are playing a multiplayer game, use the hardcoded shape data.
@@ -120,7 +175,7 @@ DECLARE_PATCH(_CellClass_Draw_Fog_Patch)
 		Cell_FixupFogShape = (const ShapeFileStruct *)&FogShapeBinary;
 
 	} else {
-		Cell_FixupFogShape = _fog_shape;
+		Cell_FixupFogShape = Cell_LoadedFogShape;
 	}
 
 	/**
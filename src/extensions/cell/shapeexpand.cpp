@@ -0,0 +1,181 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          SHAPEEXPAND.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Expands the compressed frames of a shape into raw frames.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "shapeexpand.h"
+#include <cstring>
+
+
+/**
+ *  The largest expanded shape accepted, far more than any shroud or fog
+ *  shape needs, so a corrupt header cannot ask for gigabytes.
+ */
+#define SHAPE_EXPAND_SIZE_MAX (64*1024*1024)
+
+
+/**
+ *  Expands a compressed frame into the raw frame at "dst". The frame data
+ *  must lie within [src, end). Returns false if the frame is malformed.
+ */
+static bool Shape_Expand_Frame(const ShapeExpandFrameStruct &frame, const unsigned char *src, const unsigned char *end, unsigned char *dst)
+{
+    for (int y = 0; y < frame.Height; ++y) {
+
+        if (end - src < 2) {
+            return false;
+        }
+
+        const unsigned char *line = src;
+        int line_length = line[0] | (line[1] << 8);
+        if (line_length < 2 || line_length > end - line) {
+            return false;
+        }
+
+        const unsigned char *line_end = line + line_length;
+        unsigned char *row = dst + (y * frame.Width);
+        int x = 0;
+
+        for (const unsigned char *ptr = line + 2; ptr < line_end; ++ptr) {
+
+            if ((frame.Flags & SHAPE_FRAME_TRANSPARENT) && *ptr == 0) {
+                if (++ptr >= line_end) {
+                    return false;
+                }
+                x += *ptr;
+
+            } else {
+                if (x >= frame.Width) {
+                    return false;
+                }
+                row[x++] = *ptr;
+            }
+
+            if (x > frame.Width) {
+                return false;
+            }
+        }
+
+        src = line_end;
+    }
+
+    return true;
+}
+
+
+/**
+ *  Expands the compressed frames of a shape into raw frames, so the draws are
+ *  a plain copy of the frame rather than a line by line decode. "size" is the
+ *  size of the shape data, every offset and line is checked against it.
+ *  Returns false if the shape has no compressed frames, or if it is malformed,
+ *  in which case "expanded" is left empty and the original shape should be
+ *  used.
+ * 
+ *  @author: agent
+ */
+bool Shape_Expand(const unsigned char *shape, size_t size, std::vector<unsigned char> &expanded)
+{
+    expanded.clear();
+
+    if (!shape || size < sizeof(ShapeExpandHeaderStruct)) {
+        return false;
+    }
+
+    const ShapeExpandHeaderStruct *header = (const ShapeExpandHeaderStruct *)shape;
+    const ShapeExpandFrameStruct *frames = (const ShapeExpandFrameStruct *)(shape + sizeof(ShapeExpandHeaderStruct));
+
+    const size_t headers_size = sizeof(ShapeExpandHeaderStruct) + (header->FrameCount * sizeof(ShapeExpandFrameStruct));
+    if (headers_size > size) {
+        return false;
+    }
+
+    bool has_compressed = false;
+    uint64_t expanded_size = headers_size;
+
+    for (int i = 0; i < header->FrameCount; ++i) {
+
+        const ShapeExpandFrameStruct &frame = frames[i];
+        if (!frame.Offset) {
+            continue;
+        }
+
+        const uint64_t frame_size = (uint64_t)frame.Width * frame.Height;
+
+        /**
+         *  The frame data must start after the headers and within the shape,
+         *  a raw frame must also end within it.
+         */
+        if (frame.Offset < headers_size || frame.Offset >= size) {
+            return false;
+        }
+
+        if (frame.Flags & SHAPE_FRAME_COMPRESSED) {
+            has_compressed = true;
+        } else if (frame.Offset + frame_size > size) {
+            return false;
+        }
+
+        expanded_size += frame_size;
+    }
+
+    if (!has_compressed || expanded_size > SHAPE_EXPAND_SIZE_MAX) {
+        return false;
+    }
+
+    expanded.assign((size_t)expanded_size, 0);
+    std::memcpy(expanded.data(), shape, headers_size);
+
+    ShapeExpandFrameStruct *new_frames = (ShapeExpandFrameStruct *)(expanded.data() + sizeof(ShapeExpandHeaderStruct));
+    size_t offset = headers_size;
+
+    for (int i = 0; i < header->FrameCount; ++i) {
+
+        const ShapeExpandFrameStruct &frame = frames[i];
+        ShapeExpandFrameStruct &new_frame = new_frames[i];
+
+        if (!frame.Offset) {
+            continue;
+        }
+
+        const unsigned char *src = shape + frame.Offset;
+        unsigned char *dst = expanded.data() + offset;
+
+        if (!(frame.Flags & SHAPE_FRAME_COMPRESSED)) {
+            std::memcpy(dst, src, frame.Width * frame.Height);
+
+        } else {
+            if (!Shape_Expand_Frame(frame, src, shape + size, dst)) {
+                expanded.clear();
+                return false;
+            }
+            new_frame.Flags = frame.Flags & ~SHAPE_FRAME_COMPRESSED;
+        }
+
+        new_frame.Offset = (unsigned int)offset;
+        offset += frame.Width * frame.Height;
+    }
+
+    return true;
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          SHAPEEXPAND.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Expands the compressed frames of a shape into raw frames.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+#include <vector>
+
+
+/**
+ *  The layout of a Tiberian Sun shape file header and its frame headers.
+ */
+#pragma pack(push, 1)
+typedef struct ShapeExpandHeaderStruct
+{
+    unsigned short Zero;
+    unsigned short Width;
+    unsigned short Height;
+    unsigned short FrameCount;
+} ShapeExpandHeaderStruct;
+
+typedef struct ShapeExpandFrameStruct
+{
+    unsigned short X;
+    unsigned short Y;
+    unsigned short Width;
+    unsigned short Height;
+    unsigned int Flags;
+    unsigned char Color[4];
+    unsigned int Reserved;
+    unsigned int Offset;
+} ShapeExpandFrameStruct;
+#pragma pack(pop)
+
+
+/**
+ *  Frame flags. A compressed frame prefixes each line with its length, and
+ *  when also transparent, encodes runs of transparent pixels as a zero byte
+ *  followed by the run length.
+ */
+#define SHAPE_FRAME_TRANSPARENT 0x01
+#define SHAPE_FRAME_COMPRESSED  0x02
+
+
+bool Shape_Expand(const unsigned char *shape, size_t size, std::vector<unsigned char> &expanded);
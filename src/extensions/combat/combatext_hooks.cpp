@@ -45,6 +45,47 @@
 #include "hooker.h"
 #include "hooker_macros.h"
 #include "verses.h"
+#include "damageprofile.h"
+
+
+#ifndef NDEBUG
+/**
+ *  The original damage modification, using the Verses lookup and plain
+ *  divides. Debug builds check the precomputed damage profiles against this,
+ *  as the result must be bit-identical for multiplayer sync.
+ * 
+ *  @note: Only handles positive damage, the other cases do not use the profile.
+ *
+ *  @author: agent
+ */
+static int Modify_Damage_Reference(int damage, WarheadTypeClass* warhead, ArmorType armor, int distance)
+{
+    const auto warhead_ext = Extension::Fetch<WarheadTypeClassExtension>(warhead);
+    const int min_damage = warhead_ext->MinDamage >= 0 ? warhead_ext->MinDamage : Rule->MinDamage;
+
+    damage *= Verses::Get_Modifier(armor, warhead);
+    damage = std::max(min_damage, damage);
+
+    if (damage)
+    {
+        if (!warhead->SpreadFactor)
+            distance /= PIXEL_LEPTON_W / 2;
+        else
+            distance /= warhead->SpreadFactor * (PIXEL_LEPTON_W / 2 + 1);
+
+        distance = std::clamp(distance, 0, 16);
+
+        if (distance)
+            damage /= distance;
+
+        if (distance < 4)
+            damage = std::max(damage, min_damage);
+    }
+
+    damage = std::min(damage, Rule->MaxDamage);
+    return damage;
+}
+#endif
 
 
 /**
@@ -78,13 +119,25 @@ int Vinifera_Modify_Damage(int damage, WarheadTypeClass* warhead, ArmorType armo
         return 0;
     }
 
-    const auto warhead_ext = Extension::Fetch<WarheadTypeClassExtension>(warhead);
-    const int min_damage = warhead_ext->MinDamage >= 0 ? warhead_ext->MinDamage : Rule->MinDamage;
+#ifndef NDEBUG
+    const int original_damage = damage;
+    const int original_distance = distance;
+#endif
+
+    /**
+     *  Fetch the warhead's precomputed damage modifiers.
+     */
+    const WarheadDamageProfileStruct &profile = Warhead_Damage_Profile(warhead);
+    const int min_damage = profile.MinDamage >= 0 ? profile.MinDamage : Rule->MinDamage;
 
     /**
      *  Apply the warhead's modifier to the damage and ensure it's at least MinDamage.
      */
-    damage *= Verses::Get_Modifier(armor, warhead);
+    if (armor >= ARMOR_FIRST && armor < (int)profile.Modifiers.size())
+        damage *= profile.Modifiers[armor];
+    else
+        damage *= Verses::Get_Modifier(armor, warhead);
+
     damage = std::max(min_damage, damage);
 
     /**
@@ -92,15 +145,10 @@ int Vinifera_Modify_Damage(int damage, WarheadTypeClass* warhead, ArmorType armo
      */
     if (damage)
     {
-        if (!warhead->SpreadFactor)
-            distance /= PIXEL_LEPTON_W / 2;
-        else
-            distance /= warhead->SpreadFactor * (PIXEL_LEPTON_W / 2 + 1);
-
-        distance = std::clamp(distance, 0, 16);
+        distance = Warhead_Damage_Falloff_Step(profile, distance);
 
         if (distance)
-            damage /= distance;
+            damage = Warhead_Damage_Falloff(damage, distance);
 
         /**
          *	Allow damage to drop to zero only if the distance would have
@@ -112,6 +160,13 @@ int Vinifera_Modify_Damage(int damage, WarheadTypeClass* warhead, ArmorType armo
     }
 
     damage = std::min(damage, Rule->MaxDamage);
+
+#ifndef NDEBUG
+    ASSERT_PRINT(damage == Modify_Damage_Reference(original_damage, warhead, armor, original_distance),
+        "Damage profile mismatch! Warhead: %s, Armor: %d, Damage: %d, Distance: %d",
+        warhead->Name(), armor, original_damage, original_distance);
+#endif
+
     return damage;
 }
 
@@ -89,6 +89,7 @@
 #include "debughandler.h"
 #include "asserthandler.h"
 #include "bullettype.h"
+#include "profiler.h"
 
 
 /**
@@ -4152,4 +4153,133 @@ bool ReloadRulesCommandClass::Process()
     Vinifera_Developer_IsToReloadRules = true;
 
     return true;
+}
+
+
+/**
+ *  Reloads the Rules and Art INI files, but only re-reads the types
+ *  whose sections have changed since they were last loaded.
+ * 
+ *  @author: agent
+ */
+const char *ReloadChangedRulesCommandClass::Get_Name() const
+{
+    return "ReloadChangedRules";
+}
+
+const char *ReloadChangedRulesCommandClass::Get_UI_Name() const
+{
+    return "Reload Changed Rules";
+}
+
+const char *ReloadChangedRulesCommandClass::Get_Category() const
+{
+    return CATEGORY_DEVELOPER;
+}
+
+const char *ReloadChangedRulesCommandClass::Get_Description() const
+{
+    return "Reloads the Rules and Art INI files, only refreshing the objects whose sections have changed.";
+}
+
+bool ReloadChangedRulesCommandClass::Process()
+{
+    if (!Session.Singleplayer_Game()) {
+        return false;
+    }
+
+    Vinifera_Developer_IsToReloadRulesIncremental = true;
+
+    return true;
+}
+
+
+/**
+ *  Toggles the profiler overlay, showing the frame time graph and the time
+ *  taken by each of the instrumented sections of the main loop.
+ * 
+ *  @author: agent
+ */
+const char *ToggleProfilerCommandClass::Get_Name() const
+{
+    return "ToggleProfiler";
+}
+
+const char *ToggleProfilerCommandClass::Get_UI_Name() const
+{
+    return "Toggle Profiler";
+}
+
+const char *ToggleProfilerCommandClass::Get_Category() const
+{
+    return CATEGORY_DEVELOPER;
+}
+
+const char *ToggleProfilerCommandClass::Get_Description() const
+{
+    return "Toggles the profiler overlay showing the frame time graph and main loop breakdown.";
+}
+
+bool ToggleProfilerCommandClass::Process()
+{
+    /**
+     *  Start each profiling session with a clean history.
+     */
+    if (!Vinifera_Developer_Profiler) {
+        Profiler_Reset();
+    }
+
+    Vinifera_Developer_Profiler = !Vinifera_Developer_Profiler;
+
+    return true;
+}
+
+
+/**
+ *  Writes the recorded profiler events to a Chrome trace format file.
+ * 
+ *  @author: agent
+ */
+const char *DumpProfilerTraceCommandClass::Get_Name() const
+{
+    return "DumpProfilerTrace";
+}
+
+const char *DumpProfilerTraceCommandClass::Get_UI_Name() const
+{
+    return "Dump Profiler Trace";
+}
+
+const char *DumpProfilerTraceCommandClass::Get_Category() const
+{
+    return CATEGORY_DEVELOPER;
+}
+
+const char *DumpProfilerTraceCommandClass::Get_Description() const
+{
+    return "Writes the recorded profiler events to a trace file in the debug directory.";
+}
+
+bool DumpProfilerTraceCommandClass::Process()
+{
+    if (!Vinifera_Developer_Profiler) {
+        DEBUG_WARNING("The profiler is not enabled, nothing to dump!\n");
+        return false;
+    }
+
+    int day = 0;
+    int month = 0;
+    int year = 0;
+    int hour = 0;
+    int min = 0;
+    int sec = 0;
+
+    Get_Full_Time(day, month, year, hour, min, sec);
+
+    char filename_buffer[512];
+    std::snprintf(filename_buffer, sizeof(filename_buffer), "%s\\PROFILE_%02u-%02u-%04u_%02u-%02u-%02u.JSON",
+        Vinifera_DebugDirectory,
+        day, month, year, hour, min, sec);
+
+    return Profiler_Write_Trace(filename_buffer);
 }
\ No newline at end of file
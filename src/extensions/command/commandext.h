@@ -1429,3 +1429,60 @@ public:
 
     virtual KeyNumType Default_Key() const override { return KeyNumType(KN_NONE); }
 };
+
+
+/**
+ *  Reload only the changed Rules and Art sections.
+ */
+class ReloadChangedRulesCommandClass : public ViniferaCommandClass
+{
+public:
+    ReloadChangedRulesCommandClass() : ViniferaCommandClass() { IsDeveloper = true; }
+    virtual ~ReloadChangedRulesCommandClass() {}
+
+    virtual const char *Get_Name() const override;
+    virtual const char *Get_UI_Name() const override;
+    virtual const char *Get_Category() const override;
+    virtual const char *Get_Description() const override;
+    virtual bool Process() override;
+
+    virtual KeyNumType Default_Key() const override { return KeyNumType(KN_NONE); }
+};
+
+
+/**
+ *  Toggle the profiler overlay.
+ */
+class ToggleProfilerCommandClass : public ViniferaCommandClass
+{
+public:
+    ToggleProfilerCommandClass() : ViniferaCommandClass() { IsDeveloper = true; }
+    virtual ~ToggleProfilerCommandClass() {}
+
+    virtual const char *Get_Name() const override;
+    virtual const char *Get_UI_Name() const override;
+    virtual const char *Get_Category() const override;
+    virtual const char *Get_Description() const override;
+    virtual bool Process() override;
+
+    virtual KeyNumType Default_Key() const override { return KeyNumType(KN_NONE); }
+};
+
+
+/**
+ *  Write the recorded profiler events to a trace file.
+ */
+class DumpProfilerTraceCommandClass : public ViniferaCommandClass
+{
+public:
+    DumpProfilerTraceCommandClass() : ViniferaCommandClass() { IsDeveloper = true; }
+    virtual ~DumpProfilerTraceCommandClass() {}
+
+    virtual const char *Get_Name() const override;
+    virtual const char *Get_UI_Name() const override;
+    virtual const char *Get_Category() const override;
+    virtual const char *Get_Description() const override;
+    virtual bool Process() override;
+
+    virtual KeyNumType Default_Key() const override { return KeyNumType(KN_NONE); }
+};
@@ -291,6 +291,9 @@ void Init_Vinifera_Commands()
         Commands.Add(new DumpNetworkCRCCommandClass);
         Commands.Add(new DumpHeapsCommandClass);
         Commands.Add(new ReloadRulesCommandClass);
+        Commands.Add(new ReloadChangedRulesCommandClass);
+        Commands.Add(new ToggleProfilerCommandClass);
+        Commands.Add(new DumpProfilerTraceCommandClass);
     }
 
     /**
@@ -36,6 +36,7 @@
 #include "extension_globals.h"
 #include "factoryext_init.h"
 #include "technotype.h"
+#include "profiler.h"
 
 #include "hooker.h"
 #include "hooker_macros.h"
@@ -156,6 +157,8 @@ bool FactoryClassExt::_Start(bool suspend)
  */
 void FactoryClassExt::_AI()
 {
+    ProfileScopeClass profile(PROFILE_FACTORY_AI);
+
     //_Sanitize_Queue();
 
     if (!IsSuspended && (Object != nullptr || SpecialItem))
@@ -52,12 +52,16 @@
 static BSurface *Read_PCX_File_Intercept(FileClass *file, unsigned char *palette, void *buff, long size)
 {
     char fnamebuffer[32];
-    std::strncpy(fnamebuffer, file->File_Name(), sizeof(fnamebuffer));
+    std::strncpy(fnamebuffer, file->File_Name(), sizeof(fnamebuffer)-1);
+    fnamebuffer[sizeof(fnamebuffer)-1] = '\0';
 
     /**
      *  Find the location of the file extension separator.
      */
     char *file_name = std::strchr((char *)fnamebuffer, '.');
+    if (!file_name) {
+        return (BSurface *)Read_PCX_File(file, palette, buff, size);
+    }
 
     /**
      *  Insert a null-char where the "." was. This will give us the actual
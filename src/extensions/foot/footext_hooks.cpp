@@ -35,6 +35,7 @@
 #include "tactical.h"
 #include "textprint.h"
 #include "clipline.h"
+#include "linebatch.h"
 #include "convert.h"
 #include "house.h"
 #include "iomap.h"
@@ -67,21 +68,22 @@ class FootClassExt final : public FootClass
 {
 public:
     void _Draw_Action_Line() const;
-    void _Draw_NavComQueue_Lines() const;
+    void _Draw_NavComQueue_Lines(LineBatchClass& batch, int time) const;
     void _Death_Announcement(TechnoClass* source) const;
     Cell _Search_For_Tiberium(int rad, bool a2);
 
 private:
-    void _Draw_Line(Coordinate& start_coord, Coordinate& end_coord, bool is_dashed, bool is_thick, bool is_dropshadow, unsigned line_color, unsigned drop_color, int rate) const;
+    void _Draw_Line(LineBatchClass& batch, Coordinate& start_coord, Coordinate& end_coord, bool is_dashed, bool is_thick, bool is_dropshadow, unsigned line_color, unsigned drop_color, int rate, int time) const;
 };
 
 
 /**
- *  Draws an action line with the given parameters.
+ *  Adds an action line with the given parameters to the line batch. The
+ *  time is sampled once by the caller for all of the lines in the batch.
  *
  *  @author: CCHyper, ZivDero
  */
-void FootClassExt::_Draw_Line(Coordinate& start_coord, Coordinate& end_coord, bool is_dashed, bool is_thick, bool is_dropshadow, unsigned line_color, unsigned drop_color, int rate) const
+void FootClassExt::_Draw_Line(LineBatchClass& batch, Coordinate& start_coord, Coordinate& end_coord, bool is_dashed, bool is_thick, bool is_dropshadow, unsigned line_color, unsigned drop_color, int rate, int time) const
 {
     int point_size = 3;
     Point2D point_offset(-1, -1);
@@ -110,90 +112,21 @@ void FootClassExt::_Draw_Line(Coordinate& start_coord, Coordinate& end_coord, bo
      */
     if (Clip_Line(start_point, end_point, TacticalRect)) {
 
-        Point2D drop_start_point = start_point;
-        Point2D drop_end_point = end_point;
-
-        drop_start_point.Y += 1;
-        drop_end_point.Y += 1;
-
-        if (is_dashed) {
-
-            /**
-             *  4 pixels on, 4 off, 4 pixels on, 4 off.
-             */
-            static bool _pattern[] = { true, true, true, true, false, false, false, false, true, true, true, true, false, false, false, false };
-
-            /**
-             *  Adjust the offset of the line pattern.
-             */
-            int time = timeGetTime();
-            int offset = (-time / rate) & (std::size(_pattern) - 1);
-
-            /**
-             *  Draw the drop shadow line.
-             */
-            if (is_dropshadow) {
-
-                if (is_thick) {
-                    drop_start_point.Y += 1;
-                    drop_end_point.Y += 1;
-                }
-
-                CompositeSurface->Draw_Dashed_Line(drop_start_point, drop_end_point, drop_color, _pattern, offset);
-
-                if (is_thick) {
-                    drop_start_point.Y += 1;
-                    drop_end_point.Y += 1;
-                    CompositeSurface->Draw_Dashed_Line(drop_start_point, drop_end_point, drop_color, _pattern, offset);
-                }
-
-            }
-
-            /**
-             *  Draw the dashed queue line.
-             */
-            CompositeSurface->Draw_Dashed_Line(start_point, end_point, line_color, _pattern, offset);
-
-            if (is_thick) {
-                start_point.Y += 1;
-                end_point.Y += 1;
-                CompositeSurface->Draw_Dashed_Line(start_point, end_point, line_color, _pattern, offset);
-            }
-
-        }
-        else {
-
-            /**
-             *  Draw the drop shadow line.
-             */
-            if (is_dropshadow) {
-
-                if (is_thick) {
-                    drop_start_point.Y += 1;
-                    drop_end_point.Y += 1;
-                }
-
-                CompositeSurface->Draw_Line(drop_start_point, drop_end_point, drop_color);
-
-                if (is_thick) {
-                    drop_start_point.Y += 1;
-                    drop_end_point.Y += 1;
-                    CompositeSurface->Draw_Line(drop_start_point, drop_end_point, drop_color);
-                }
-
-            }
+        /**
+         *  4 pixels on, 4 off, 4 pixels on, 4 off.
+         */
+        static bool _pattern[] = { true, true, true, true, false, false, false, false, true, true, true, true, false, false, false, false };
 
-            /**
-             *  Draw the queue line.
-             */
-            CompositeSurface->Draw_Line(start_point, end_point, line_color);
+        /**
+         *  Adjust the offset of the line pattern.
+         */
+        int offset = (-time / rate) & (std::size(_pattern) - 1);
 
-            if (is_thick) {
-                start_point.Y += 1;
-                end_point.Y += 1;
-                CompositeSurface->Draw_Line(start_point, end_point, line_color);
-            }
+        batch.Add_Line(start_point, end_point, line_color, drop_color, is_thick, is_dropshadow, is_dashed ? _pattern : nullptr, offset);
 
+        if (is_thick) {
+            start_point.Y += 1;
+            end_point.Y += 1;
         }
 
     }
@@ -211,17 +144,17 @@ void FootClassExt::_Draw_Line(Coordinate& start_coord, Coordinate& end_coord, bo
         }
 
         Rect drop_start_point_rect = TacticalRect.Intersect_With(Rect(start_point + drop_point_offset, drop_point_size, drop_point_size));
-        CompositeSurface->Fill_Rect(drop_start_point_rect, drop_color);
+        batch.Add_Point(drop_start_point_rect, drop_color, true);
 
         Rect drop_end_point_rect = TacticalRect.Intersect_With(Rect(end_point + drop_point_offset, drop_point_size, drop_point_size));
-        CompositeSurface->Fill_Rect(drop_end_point_rect, drop_color);
+        batch.Add_Point(drop_end_point_rect, drop_color, true);
     }
 
     Rect start_point_rect = TacticalRect.Intersect_With(Rect(start_point + point_offset, point_size, point_size));
-    CompositeSurface->Fill_Rect(start_point_rect, line_color);
+    batch.Add_Point(start_point_rect, line_color);
 
     Rect end_point_rect = TacticalRect.Intersect_With(Rect(end_point + point_offset, point_size, point_size));
-    CompositeSurface->Fill_Rect(end_point_rect, line_color);
+    batch.Add_Point(end_point_rect, line_color);
 }
 
 
@@ -230,7 +163,7 @@ void FootClassExt::_Draw_Line(Coordinate& start_coord, Coordinate& end_coord, bo
  * 
  *  @author: CCHyper, ZivDero
  */
-void FootClassExt::_Draw_NavComQueue_Lines() const
+void FootClassExt::_Draw_NavComQueue_Lines(LineBatchClass& batch, int time) const
 {
     if (!NavCom || !NavQueue.Count()) {
         return;
@@ -276,7 +209,7 @@ void FootClassExt::_Draw_NavComQueue_Lines() const
             end_coord.Z = BRIDGE_HEIGHT + Map.Get_Cell_Height(end_coord);
         }
 
-        _Draw_Line(start_coord, end_coord, is_dashed, is_thick, is_dropshadow, line_color, drop_color, 128);
+        _Draw_Line(batch, start_coord, end_coord, is_dashed, is_thick, is_dropshadow, line_color, drop_color, 128, time);
 
         start = NavQueue[i];
         end = NavQueue[i + 1];
@@ -330,6 +263,13 @@ void FootClassExt::_Draw_Action_Line() const
         UIControls->MovementLineDropShadowColor.G,
         UIControls->MovementLineDropShadowColor.B);
 
+    /**
+     *  All of the lines of this unit are drawn in one batch, with the
+     *  dash pattern offset taken from a single time sample.
+     */
+    LineBatchClass batch(CompositeSurface, TacticalRect);
+    int time = timeGetTime();
+
     /**
      *  Fetch the action line start and end coord.
      */
@@ -341,7 +281,7 @@ void FootClassExt::_Draw_Action_Line() const
         start_coord = entry_28C();
         end_coord = func_638AF0();
 
-        _Draw_Line(start_coord, end_coord, tarcom_is_dashed, tarcom_is_thick, tarcom_is_dropshadow, tarcom_color, tarcom_drop_color, 64);
+        _Draw_Line(batch, start_coord, end_coord, tarcom_is_dashed, tarcom_is_thick, tarcom_is_dropshadow, tarcom_color, tarcom_drop_color, 64, time);
 
     }
 
@@ -357,13 +297,15 @@ void FootClassExt::_Draw_Action_Line() const
             end_coord.Z = BRIDGE_HEIGHT + Map.Get_Cell_Height(end_coord);
         }
 
-        _Draw_Line(start_coord, end_coord, navcom_is_dashed, navcom_is_thick, navcom_is_dropshadow, navcom_color, navcom_drop_color, 128);
+        _Draw_Line(batch, start_coord, end_coord, navcom_is_dashed, navcom_is_thick, navcom_is_dropshadow, navcom_color, navcom_drop_color, 128, time);
 
         if (UIControls->IsShowNavComQueueLines) {
-            _Draw_NavComQueue_Lines();
+            _Draw_NavComQueue_Lines(batch, time);
         }
 
     }
+
+    batch.Flush();
 }
 
 
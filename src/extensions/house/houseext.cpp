@@ -35,6 +35,9 @@
 #include "vinifera_saveload.h"
 #include "storageext.h"
 #include "utracker.h"
+#include "housetype.h"
+#include <cstring>
+#include <vector>
 
 
 /**
@@ -202,6 +205,27 @@ void HouseClassExtension::Put_Storage_Pointers()
 }
 
 
+/**
+ *  The version of the unit tracker block format. Bump this when the layout
+ *  of the block changes.
+ */
+#define UNIT_TRACKERS_VERSION 1
+
+/**
+ *  The number of unit trackers held by each house.
+ */
+#define UNIT_TRACKERS_COUNT 10
+
+/**
+ *  The header written before a house's unit tracker block.
+ */
+struct UnitTrackersHeaderStruct
+{
+    int Version;
+    int Size;
+};
+
+
 /**
  *  A fake class for implementing new member functions which allow
  *  access to the "this" pointer of the intended class.
@@ -212,59 +236,89 @@ void HouseClassExtension::Put_Storage_Pointers()
 static class UnitTrackerClassExt final : public UnitTrackerClass
 {
 public:
-    HRESULT _Load(IStream* pStm);
-    HRESULT _Save(IStream* pStm);
+    int _Block_Size() const;
+    void _Write_Block(unsigned char *&ptr) const;
+    static UnitTrackerClass *_Read_Block(const unsigned char *&ptr, const unsigned char *end);
 };
 
 
 /**
- *  Saves a unit tracker's counts
+ *  Fetches the size of a unit tracker's counts in the save block.
  *
  *  @author: ZivDero
  */
-HRESULT UnitTrackerClassExt::_Load(IStream* pStm)
+int UnitTrackerClassExt::_Block_Size() const
 {
-    int count;
-    HRESULT hr = pStm->Read(&count, sizeof(count), nullptr);
-    if (FAILED(hr)) {
-        return hr;
-    }
+    return sizeof(UnitCount) + (UnitCount * sizeof(UnitTotals[0]));
+}
 
-    new (this) UnitTrackerClass(count);
 
-    for (int i = 0; i < UnitCount; i++) {
-        hr = pStm->Read(&UnitTotals[i], sizeof(UnitTotals[i]), nullptr);
-        if (FAILED(hr)) {
-            return hr;
-        }
+/**
+ *  Writes a unit tracker's counts into the save block.
+ *
+ *  @author: agent
+ */
+void UnitTrackerClassExt::_Write_Block(unsigned char *&ptr) const
+{
+    std::memcpy(ptr, &UnitCount, sizeof(UnitCount));
+    ptr += sizeof(UnitCount);
 
+    if (UnitCount > 0) {
+        std::memcpy(ptr, &UnitTotals[0], UnitCount * sizeof(UnitTotals[0]));
+        ptr += UnitCount * sizeof(UnitTotals[0]);
     }
-
-    return S_OK;
 }
 
 
 /**
- *  Saves a unit tracker's counts.
+ *  Creates a unit tracker from its counts in the save block.
  *
  *  @author: ZivDero
  */
-HRESULT UnitTrackerClassExt::_Save(IStream* pStm)
+UnitTrackerClass *UnitTrackerClassExt::_Read_Block(const unsigned char *&ptr, const unsigned char *end)
 {
-    HRESULT hr = pStm->Write(&UnitCount, sizeof(UnitCount), nullptr);
-    if (FAILED(hr)) {
-        return hr;
+    int count;
+
+    if (end - ptr < (int)sizeof(count)) {
+        return nullptr;
     }
 
-    for (int i = 0; i < UnitCount; i++) {
-        HRESULT hr = pStm->Write(&UnitTotals[i], sizeof(UnitTotals[i]), nullptr);
-        if (FAILED(hr)) {
-            return hr;
-        }
+    std::memcpy(&count, ptr, sizeof(count));
+    ptr += sizeof(count);
 
+    if (count < 0 || (end - ptr) / (int)sizeof(UnitTotals[0]) < count) {
+        return nullptr;
     }
 
-    return S_OK;
+    UnitTrackerClassExt *tracker = reinterpret_cast<UnitTrackerClassExt *>(new UnitTrackerClass(count));
+
+    if (count > 0) {
+        int size = count * sizeof(tracker->UnitTotals[0]);
+        std::memcpy(&tracker->UnitTotals[0], ptr, size);
+        ptr += size;
+    }
+
+    return tracker;
+}
+
+
+/**
+ *  Fetches the unit tracker pointers of a house, in save order.
+ *
+ *  @author: agent
+ */
+static void House_Unit_Trackers(HouseClass *house, UnitTrackerClass **(&trackers)[UNIT_TRACKERS_COUNT])
+{
+    trackers[0] = &house->AircraftTotals;
+    trackers[1] = &house->InfantryTotals;
+    trackers[2] = &house->UnitTotals;
+    trackers[3] = &house->BuildingTotals;
+    trackers[4] = &house->DestroyedAircraft;
+    trackers[5] = &house->DestroyedInfantry;
+    trackers[6] = &house->DestroyedUnits;
+    trackers[7] = &house->DestroyedBuildings;
+    trackers[8] = &house->CapturedBuildings;
+    trackers[9] = &house->TotalCrates;
 }
 
 
@@ -279,29 +333,47 @@ void HouseClassExtension::Load_Unit_Trackers(HouseClass* house, IStream* pStm)
      *  Trackers store their counts in a dynamically allocated array (AARGH WW!).
      *  Thus, we need to save/load them manually.
      *  But we can't do this in the extension because ThisPtr isn't remapped yet.
+     * 
+     *  Each tracker still gets its own count array, as the game frees them
+     *  individually, but all ten are read from the stream as a single block.
      */
+    UnitTrackerClass **trackers[UNIT_TRACKERS_COUNT];
+    House_Unit_Trackers(house, trackers);
 
-    house->AircraftTotals = new UnitTrackerClass(0);
-    house->InfantryTotals = new UnitTrackerClass(0);
-    house->UnitTotals = new UnitTrackerClass(0);
-    house->BuildingTotals = new UnitTrackerClass(0);
-    house->DestroyedAircraft = new UnitTrackerClass(0);
-    house->DestroyedInfantry = new UnitTrackerClass(0);
-    house->DestroyedUnits = new UnitTrackerClass(0);
-    house->DestroyedBuildings = new UnitTrackerClass(0);
-    house->CapturedBuildings = new UnitTrackerClass(0);
-    house->TotalCrates = new UnitTrackerClass(0);
-
-    reinterpret_cast<UnitTrackerClassExt*>(house->AircraftTotals)->_Load(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->InfantryTotals)->_Load(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->UnitTotals)->_Load(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->BuildingTotals)->_Load(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->DestroyedAircraft)->_Load(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->DestroyedInfantry)->_Load(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->DestroyedUnits)->_Load(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->DestroyedBuildings)->_Load(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->CapturedBuildings)->_Load(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->TotalCrates)->_Load(pStm);
+    std::vector<unsigned char> block;
+
+    UnitTrackersHeaderStruct header;
+    HRESULT hr = pStm->Read(&header, sizeof(header), nullptr);
+    if (SUCCEEDED(hr) && header.Version == UNIT_TRACKERS_VERSION && header.Size >= 0) {
+        block.resize(header.Size);
+        if (header.Size > 0) {
+            hr = pStm->Read(&block[0], header.Size, nullptr);
+        }
+    } else {
+        DEBUG_ERROR("Failed to read the unit tracker header for house %s!\n", house->Class->Name());
+        hr = E_UNEXPECTED;
+    }
+
+    const unsigned char *ptr = block.empty() ? nullptr : &block[0];
+    const unsigned char *end = ptr + block.size();
+
+    for (int i = 0; i < UNIT_TRACKERS_COUNT; ++i) {
+
+        UnitTrackerClass *tracker = SUCCEEDED(hr) ? UnitTrackerClassExt::_Read_Block(ptr, end) : nullptr;
+
+        /**
+         *  Fall back to an empty tracker so the game never sees a stale pointer.
+         */
+        if (!tracker) {
+            if (SUCCEEDED(hr)) {
+                DEBUG_ERROR("Unit tracker block for house %s is malformed!\n", house->Class->Name());
+                hr = E_UNEXPECTED;
+            }
+            tracker = new UnitTrackerClass(0);
+        }
+
+        *trackers[i] = tracker;
+    }
 }
 
 
@@ -312,14 +384,33 @@ void HouseClassExtension::Load_Unit_Trackers(HouseClass* house, IStream* pStm)
  */
 void HouseClassExtension::Save_Unit_Trackers(HouseClass* house, IStream* pStm)
 {
-    reinterpret_cast<UnitTrackerClassExt*>(house->AircraftTotals)->_Save(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->InfantryTotals)->_Save(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->UnitTotals)->_Save(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->BuildingTotals)->_Save(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->DestroyedAircraft)->_Save(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->DestroyedInfantry)->_Save(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->DestroyedUnits)->_Save(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->DestroyedBuildings)->_Save(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->CapturedBuildings)->_Save(pStm);
-    reinterpret_cast<UnitTrackerClassExt*>(house->TotalCrates)->_Save(pStm);
+    UnitTrackerClass **trackers[UNIT_TRACKERS_COUNT];
+    House_Unit_Trackers(house, trackers);
+
+    UnitTrackersHeaderStruct header;
+    header.Version = UNIT_TRACKERS_VERSION;
+    header.Size = 0;
+
+    for (int i = 0; i < UNIT_TRACKERS_COUNT; ++i) {
+        header.Size += reinterpret_cast<UnitTrackerClassExt *>(*trackers[i])->_Block_Size();
+    }
+
+    /**
+     *  Gather the counts of all the trackers and write them as a single block.
+     */
+    std::vector<unsigned char> block(header.Size);
+    unsigned char *ptr = &block[0];
+
+    for (int i = 0; i < UNIT_TRACKERS_COUNT; ++i) {
+        reinterpret_cast<UnitTrackerClassExt *>(*trackers[i])->_Write_Block(ptr);
+    }
+
+    HRESULT hr = pStm->Write(&header, sizeof(header), nullptr);
+    if (SUCCEEDED(hr)) {
+        hr = pStm->Write(&block[0], header.Size, nullptr);
+    }
+
+    if (FAILED(hr)) {
+        DEBUG_ERROR("Failed to write the unit trackers for house %s!\n", house->Class->Name());
+    }
 }
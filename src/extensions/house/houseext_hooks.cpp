@@ -48,6 +48,8 @@
 #include "session.h"
 #include "ccini.h"
 #include "sideext.h"
+#include "spawner_settings.h"
+#include "profiler.h"
 
 #include "hooker.h"
 #include "hooker_macros.h"
@@ -254,6 +256,25 @@ ProdFailType HouseClassExt::_Abandon_Production(RTTIType type, int id)
 }
 
 
+/**
+ *  Fetches the building types the house currently owns.
+ * 
+ *  This uses the house's building counters, which the game keeps up to date
+ *  as buildings are placed, captured, sold or destroyed, instead of scanning
+ *  every building on the map. Each type is only listed once.
+ *
+ *  @author: agent
+ */
+static void Fetch_Owned_Building_Types(HouseClass* house, DynamicVectorClass<BuildingTypeClass*>& owned_buildings)
+{
+    for (int i = 0; i < BuildingTypes.Count(); i++) {
+        if (house->BQuantity.Count_Of((BuildingType)i) > 0) {
+            owned_buildings.Add(BuildingTypes[i]);
+        }
+    }
+}
+
+
 /**
  *  Determines what building to build.
  *
@@ -272,22 +293,7 @@ int HouseClassExt::_AI_Building()
      *  Unfortunately, ts-patches spawner has a hack here.
      *  Until we reimplement the spawner in Vinifera, this will have to do.
      */
-    static bool spawner_hack_init = false;
-    static bool spawner_hack_mpnodes = false;
-
-    if (!spawner_hack_init)
-    {
-        RawFileClass file("SPAWN.INI");
-        CCINIClass spawn_ini;
-
-        if (file.Is_Available()) {
-
-            spawn_ini.Load(file, false);
-            spawner_hack_mpnodes = spawn_ini.Get_Bool("Settings", "UseMPAIBaseNodes", spawner_hack_mpnodes);
-        }
-
-        spawner_hack_init = true;
-    }
+    const bool spawner_hack_mpnodes = Spawner::Settings.UseMPAIBaseNodes;
 
 
     if (BuildStructure != BUILDING_NONE) return TICKS_PER_SECOND;
@@ -376,14 +382,23 @@ int HouseClassExt::_AI_Building()
     if (side_ext->PowerTurbine) {
 
         bool can_build_turbine = false;
-        for (int i = 0; i < Buildings.Count(); i++) {
+
+        /**
+         *  Only look for an upgradable power plant if we actually own any, and stop
+         *  looking once all of them have been checked.
+         */
+        int plants_left = side_ext->RegularPowerPlant
+                        ? BQuantity.Count_Of((BuildingType)side_ext->RegularPowerPlant->Get_Heap_ID())
+                        : 0;
+        for (int i = 0; plants_left > 0 && i < Buildings.Count(); i++) {
 
             BuildingClass* owned_b = Buildings[i];
-            if (owned_b->Owning_House() == this) {
-                if (owned_b->Class == side_ext->RegularPowerPlant && owned_b->UpgradeLevel < owned_b->Class->Upgrades) {
+            if (owned_b->Class == side_ext->RegularPowerPlant && owned_b->Owning_House() == this) {
+                if (owned_b->UpgradeLevel < owned_b->Class->Upgrades) {
                     can_build_turbine = true;
                     break;
                 }
+                --plants_left;
             }
         }
 
@@ -397,13 +412,7 @@ int HouseClassExt::_AI_Building()
      */
     if (!choice && side_ext->AdvancedPowerPlant) {
         DynamicVectorClass<BuildingTypeClass*> owned_buildings;
-
-        for (int i = 0; i < Buildings.Count(); i++) {
-            BuildingClass* b2 = Buildings[i];
-            if (b2->Owning_House() == this) {
-                owned_buildings.Add(b2->Class);
-            }
-        }
+        Fetch_Owned_Building_Types(this, owned_buildings);
 
         if (Has_Prerequisites(side_ext->AdvancedPowerPlant, owned_buildings, owned_buildings.Count())) {
             choice = side_ext->AdvancedPowerPlant;
@@ -434,26 +443,13 @@ int HouseClassExt::_AI_Building()
  */
 int HouseClassExt::_Expert_AI()
 {
+    ProfileScopeClass profile(PROFILE_HOUSE_AI);
+
     /**
      *  Unfortunately, ts-patches spawner has a hack here.
      *  Until we reimplement the spawner in Vinifera, this will have to do.
      */
-    static bool spawner_hack_init = false;
-    static bool spawner_hack_mpnodes = false;
-
-    if (!spawner_hack_init)
-    {
-        RawFileClass file("SPAWN.INI");
-        CCINIClass spawn_ini;
-
-        if (file.Is_Available()) {
-
-            spawn_ini.Load(file, false);
-            spawner_hack_mpnodes = spawn_ini.Get_Bool("Settings", "UseMPAIBaseNodes", spawner_hack_mpnodes);
-        }
-
-        spawner_hack_init = true;
-    }
+    const bool spawner_hack_mpnodes = Spawner::Settings.UseMPAIBaseNodes;
 
     /**
      *  If there is no enemy assigned to this house, then assign one now. The
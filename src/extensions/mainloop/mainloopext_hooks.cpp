@@ -35,9 +35,16 @@
 #include "iomap.h"
 #include "tactical.h"
 #include "house.h"
+#include "session.h"
 #include "ccfile.h"
 #include "addon.h"
 #include "ccini.h"
+#include "rulesext.h"
+#include "rulesext_reload.h"
+#include "extension_globals.h"
+#include "buildingext_hooks.h"
+#include "profiler.h"
+#include "framepacer.h"
 #include "fatal.h"
 #include "debughandler.h"
 #include "asserthandler.h"6
@@ -80,102 +87,210 @@ static void Before_Main_Loop()
 }
 
 
-static void After_Main_Loop()
+/**
+ *  Clears and reloads the rule and art databases from disk.
+ * 
+ *  @author: agent
+ */
+static void Reload_Rule_Databases()
 {
     /**
-     *  Has we been flagged to reload the rules data?
+     *  Clear the current ini databases.
      */
-    if (Vinifera_Developer_IsToReloadRules) {
-
-        /**
-         *  Reinitalise the Rule instance to the defaults.
-         */
-        Rule->~RulesClass();
-        new (Rule) RulesClass();
+    ArtINI.Clear();
+    RuleINI->Clear();
+    FSRuleINI.Clear();
 
-        /**
-         *  Clear the current ini databases.
-         */
-        ArtINI.Clear();
-        RuleINI->Clear();
-        FSRuleINI.Clear();
+    /**
+     *  Reload RULES.INI and FIRESTRM.INI.
+     */
+    {
+        CCFileClass rulefile("RULES.INI");
+        RuleINI->Load(rulefile, false);
+        ASSERT_FATAL(rulefile.Is_Available());
 
-        /**
-         *  Reload RULES.INI and FIRESTRM.INI.
-         */
-        {
-            CCFileClass rulefile("RULES.INI");
-            RuleINI->Load(rulefile, false);
+        if (Is_Addon_Available(ADDON_FIRESTORM) && Is_Addon_Enabled(ADDON_FIRESTORM)) {
+            rulefile.Set_Name("FIRESTRM.INI");
             ASSERT_FATAL(rulefile.Is_Available());
-
-            if (Is_Addon_Available(ADDON_FIRESTORM) && Is_Addon_Enabled(ADDON_FIRESTORM)) {
-                rulefile.Set_Name("FIRESTRM.INI");
-                ASSERT_FATAL(rulefile.Is_Available());
-                FSRuleINI.Load(rulefile, false);
-            }
+            FSRuleINI.Load(rulefile, false);
         }
+    }
 
-        /**
-         *  Reload ART.INI and ARTFS.INI.
-         */
-        {
-            CCFileClass artfile("ART.INI");
+    /**
+     *  Reload ART.INI and ARTFS.INI.
+     */
+    {
+        CCFileClass artfile("ART.INI");
 
-            DEBUG_INFO("Loading ART.INI.\n");
-            ArtINI.Load(artfile, false);
+        DEBUG_INFO("Loading ART.INI.\n");
+        ArtINI.Load(artfile, false);
+        ASSERT_FATAL(artfile.Is_Available());
+        DEBUG_INFO("Finished loading ART.INI.\n");
+
+        if (Is_Addon_Available(ADDON_FIRESTORM) && Is_Addon_Enabled(ADDON_FIRESTORM)) {
+            DEBUG_INFO("Loading ARTFS.INI.\n");
+            artfile.Set_Name("ARTFS.INI");
             ASSERT_FATAL(artfile.Is_Available());
-            DEBUG_INFO("Finished loading ART.INI.\n");
-
-            if (Is_Addon_Available(ADDON_FIRESTORM) && Is_Addon_Enabled(ADDON_FIRESTORM)) {
-                DEBUG_INFO("Loading ARTFS.INI.\n");
-                artfile.Set_Name("ARTFS.INI");
-                ASSERT_FATAL(artfile.Is_Available());
-                ArtINI.Load(artfile, false);
-                DEBUG_INFO("Finished loading ARTFS.INI.\n");
-            }
+            ArtINI.Load(artfile, false);
+            DEBUG_INFO("Finished loading ARTFS.INI.\n");
         }
+    }
+}
+
+
+/**
+ *  Loads the scenario file so its rule overrides can be applied.
+ * 
+ *  @author: agent
+ */
+static void Load_Scenario_Overrides(CCINIClass &scenini)
+{
+    CCFileClass scenfile(Scen->ScenarioName);
+    ASSERT_FATAL(scenfile.Is_Available());
+
+    scenini.Load(scenfile, false);
+}
+
+
+/**
+ *  Reloads the miscellaneous classes that are read alongside the rules.
+ * 
+ *  @author: agent
+ */
+static void Reload_Miscellaneous()
+{
+    CCFileClass workingfile;
+    CCINIClass workingini;
+
+    DEBUG_INFO("Calling UIControls->Read_INI().\n");
+    workingfile.Set_Name("UI.INI");
+    workingini.Clear();
+    workingini.Load(workingfile, false);
+    UIControls->Read_INI(workingini);
+    DEBUG_INFO("Finished UIControls->Read_INI().\n");
+}
+
+
+/**
+ *  Rebuilds the rules data from the currently loaded databases.
+ * 
+ *  @author: agent
+ */
+static void Process_Rules_Full()
+{
+    /**
+     *  Reinitalise the Rule instance to the defaults.
+     */
+    Rule->~RulesClass();
+    new (Rule) RulesClass();
+
+    /**
+     *  Process rule INIs.
+     */
+    DEBUG_INFO("Calling Rule->Process(*RuleINI).\n");
+    Rule->Process(*RuleINI);
+    DEBUG_INFO("Finished Rule->Process(*RuleINI).\n");
+
+    DEBUG_INFO("Calling Rule->Addition(FSRuleINI).\n");
+    Rule->Addition(FSRuleINI);
+    DEBUG_INFO("Finished Rule->Addition(FSRuleINI).\n");
+
+    RuleExtension->Preload_Cameo_Images();
+
+    /**
+     *  Process scenario rule overrides.
+     */
+    {
+        CCINIClass scenini;
+        Load_Scenario_Overrides(scenini);
+
+        DEBUG_INFO("Calling Rule->Addition() with scenario overrides.\n");
+        Rule->Addition(scenini);
+        DEBUG_INFO("Finished Rule->Addition() with scenario overrides.\n");
+    }
+
+    /**
+     *  Finally, reload miscellaneous classes.
+     */
+    Reload_Miscellaneous();
+}
+
+
+/**
+ *  Reloads the rule databases and only re-reads the types whose sections
+ *  have changed since they were last loaded. Falls back to a full rebuild
+ *  if any of the type lists have changed.
+ * 
+ *  @author: agent
+ */
+static void Reload_Rules_Incremental()
+{
+    DWORD start_time = timeGetTime();
+
+    DEBUG_INFO("Rules: Incremental reload started.\n");
+
+    RulesSnapshotStruct before;
+    Rules_Take_Snapshot(before);
+
+    Reload_Rule_Databases();
+
+    RulesSnapshotStruct after;
+    Rules_Take_Snapshot(after);
+
+    if (Rules_Is_Type_List_Changed(before, after)) {
+        DEBUG_WARNING("Rules: Type lists have changed, performing a full reload.\n");
+        Process_Rules_Full();
+        DEBUG_INFO("Rules: Full reload finished in %d ms.\n", timeGetTime() - start_time);
+        return;
+    }
+
+    CCINIClass scenini;
+    Load_Scenario_Overrides(scenini);
+
+    int refreshed = Rules_Reload_Changed(before, after, scenini);
+
+    Reload_Miscellaneous();
+
+    DEBUG_INFO("Rules: Incremental reload refreshed %d objects in %d ms.\n", refreshed, timeGetTime() - start_time);
+}
+
+
+static void After_Main_Loop()
+{
+    /**
+     *  Has we been flagged to reload only the changed rules data?
+     */
+    if (Vinifera_Developer_IsToReloadRulesIncremental) {
+
+        ProfileScopeClass profile(PROFILE_RULES_RELOAD);
+
+        Reload_Rules_Incremental();
 
         /**
-         *  Process rule INIs.
+         *  The prerequisites may have changed, so recalculate the buildables.
          */
-        DEBUG_INFO("Calling Rule->Process(*RuleINI).\n");
-        Rule->Process(*RuleINI);
-        DEBUG_INFO("Finished Rule->Process(*RuleINI).\n");
-
-        DEBUG_INFO("Calling Rule->Addition(FSRuleINI).\n");
-        Rule->Addition(FSRuleINI);
-        DEBUG_INFO("Finished Rule->Addition(FSRuleINI).\n");
+        Buildables_Cache_Invalidate();
 
         /**
-         *  Process scenario rule overrides.
+         *  All done!
          */
-        {
-            CCFileClass scenfile(Scen->ScenarioName);
-            ASSERT_FATAL(scenfile.Is_Available());
+        Vinifera_Developer_IsToReloadRulesIncremental = false;
+    }
 
-            CCINIClass scenini;
+    /**
+     *  Has we been flagged to reload the rules data?
+     */
+    if (Vinifera_Developer_IsToReloadRules) {
 
-            scenini.Load(scenfile, false);
+        ProfileScopeClass profile(PROFILE_RULES_RELOAD);
 
-            DEBUG_INFO("Calling Rule->Addition() with scenario overrides.\n");
-            Rule->Addition(scenini);
-            DEBUG_INFO("Finished Rule->Addition() with scenario overrides.\n");
-        }
+        Reload_Rule_Databases();
+        Process_Rules_Full();
 
         /**
-         *  Finally, reload miscellaneous classes.
+         *  The prerequisites may have changed, so recalculate the buildables.
          */
-        {
-            CCFileClass workingfile;
-            CCINIClass workingini;
-
-            DEBUG_INFO("Calling UIControls->Read_INI().\n");
-            workingfile.Set_Name("UI.INI");
-            workingini.Clear();
-            workingini.Load(workingfile, false);
-            UIControls->Read_INI(workingini);
-            DEBUG_INFO("Finished UIControls->Read_INI().\n");
-        }
+        Buildables_Cache_Invalidate();
 
         /**
          *  All done!
@@ -223,13 +338,21 @@ static bool FrameStep_Main_Loop()
 
             }
 
-            Map.Render();
+            {
+                ProfileScopeClass profile(PROFILE_MAP_RENDER);
+                Map.Render();
+            }
+
             TacticalMap->AI();
         }
 
     }
 
-    Sleep(1);
+    /**
+     *  Pace the redraw to the desired frame rate. Sleep(1) was at the mercy of
+     *  the system timer resolution, which made the idle frames jittery.
+     */
+    Frame_Pacer_Wait(Session.DesiredFrameRate > 0 ? Session.DesiredFrameRate : 60);
 
     //DEV_DEBUG_INFO("FrameStep_Main_Loop(exit)\n");
 
@@ -237,7 +360,7 @@ static bool FrameStep_Main_Loop()
 }
 
 
-static bool Main_Loop_Intercept()
+static bool Main_Loop_Frame()
 {
     bool ret = false;
 
@@ -256,8 +379,6 @@ static bool Main_Loop_Intercept()
     } else if ((Vinifera_Developer_FrameStep && Vinifera_Developer_FrameStepCount > 0)
            || (!Vinifera_Developer_FrameStep && !Vinifera_Developer_FrameStepCount)) {
 
-        //DEV_DEBUG_INFO("Before Main_Loop()\n");
-
         Before_Main_Loop();
 
         /**
@@ -267,8 +388,6 @@ static bool Main_Loop_Intercept()
 
         After_Main_Loop();
 
-        //DEV_DEBUG_INFO("After Main_Loop()\n");
-
         /**
          *  Decrement the frame step count.
          */
@@ -282,6 +401,30 @@ static bool Main_Loop_Intercept()
 }
 
 
+static bool Main_Loop_Intercept()
+{
+    bool ret = false;
+
+    {
+        ProfileScopeClass profile(PROFILE_FRAME);
+
+        ret = Main_Loop_Frame();
+    }
+
+    /**
+     *  Push the section times of this frame into the profiler history.
+     */
+    Profiler_End_Frame();
+
+    /**
+     *  Record the achieved frame interval for the frame time percentiles.
+     */
+    Frame_Pacer_Mark_Frame();
+
+    return ret;
+}
+
+
 void Process_Command_If_Allowed(CommandClass* command)
 {
     if (!Scen->UserInputLocked || (CommandClass::From_Type(COMMAND_OPTIONS) == command)) {
@@ -27,9 +27,12 @@
  ******************************************************************************/
 #include "particlesysext_hooks.h"
 #include "particlesys.h"
+#include "particle.h"
+#include "tibsun_globals.h"
 #include "fatal.h"
 #include "debughandler.h"
 #include "asserthandler.h"
+#include <algorithm>
 
 #include "hooker.h"
 #include "hooker_macros.h"
@@ -57,6 +60,37 @@ DECLARE_PATCH(_ParticleSystemClass_Spawn_Particle_Particle_System_Patch)
 }
 
 
+/**
+ *  Pre-sizes the particle tracker for a batch of new particles.
+ * 
+ *  Each particle adds itself to the Particles tracker when it is created, so
+ *  a large batch would otherwise trip the vector growth step (and its
+ *  reallocation and copy) many times over. The tracker is grown once for the
+ *  whole batch, geometrically so the following batches usually fit without
+ *  another reallocation.
+ * 
+ *  The tracker is owned by the game, but resizing it from here is safe. The
+ *  resize allocates the new storage with operator new[] and frees the old
+ *  with operator delete[], which in the DLL are the vinifera_newdel.cpp
+ *  overloads. The game's own allocator and free are hooked to the same
+ *  vinifera_allocate and vinifera_free (see crt_hooks.cpp), so every block
+ *  on either side comes from, and goes back to, the one process heap.
+ * 
+ *  @author: agent
+ */
+void Particle_Tracker_Presize(int count)
+{
+	if (count <= 0) {
+		return;
+	}
+
+	int needed = Particles.Count() + count;
+	if (needed > Particles.Length()) {
+		Particles.Resize(std::max(needed, Particles.Length() * 2));
+	}
+}
+
+
 /**
  *  Main function for patching the hooks.
  */
@@ -29,3 +29,5 @@
 
 
 void ParticleSystemClassExtension_Hooks();
+
+void Particle_Tracker_Presize(int count);
@@ -67,6 +67,13 @@
 #include "extension_globals.h"
 #include "mission.h"
 #include "verses.h"
+#include "imagecache.h"
+#include "unittype.h"
+#include "infantrytype.h"
+#include "aircrafttype.h"
+#include "supertype.h"
+#include <string>
+#include <vector>
 
 
 /**
@@ -315,6 +322,14 @@ void RulesClassExtension::Process(CCINIClass &ini)
      */
     Verses::Resize();
 
+    /**
+     *  The cameo images are loaded in one batch once the Firestorm rules have
+     *  also been processed, see Preload_Cameo_Images.
+     */
+    if (&ini == RuleINI) {
+        Image_Cache_Defer_Loads(true);
+    }
+
     /**
      *  Process the objects (extension classes).
      *  This includes all vanilla objects.
@@ -365,118 +380,166 @@ void RulesClassExtension::Initialize(CCINIClass &ini)
 
 
 /**
- *  Fetch all the object characteristic values.
- *  
- *  @author: CCHyper, ZivDero
+ *  Adds the cameo image name of a techno type to the list of images to preload.
  */
-bool RulesClassExtension::Objects(CCINIClass &ini)
+static void Add_Cameo_Name(TechnoTypeClassExtension *ext, std::vector<const char *> &names)
 {
-    //EXT_DEBUG_TRACE("RulesClassExtension::Objects - 0x%08X\n", (uintptr_t)(This()));
+    const char *cameo_name = ext->This()->CameoFilename;
 
-    /**
-     *  Fetch the game object and extension values from the rules file.
-     */
-
-    DEBUG_INFO("Rules: Processing HouseTypes (Count: %d)...\n", HouseTypes.Count());
-    for (int index = 0; index < HouseTypes.Count(); ++index) {
-        HouseTypes[index]->Read_INI(ini);
+    if (cameo_name[0] != '\0' && std::strcmp(cameo_name, "XXICON") != 0) {
+        names.push_back(cameo_name);
     }
+}
+
 
-    DEBUG_INFO("Rules: Processing HouseTypeExtensions (Count: %d)...\n", HouseTypeExtensions.Count());
-    for (int index = 0; index < HouseTypeExtensions.Count(); ++index) {
-        HouseTypeExtensions[index]->Read_INI(ini);
+/**
+ *  Assigns the cameo image surface to a type that does not have one yet.
+ */
+static void Fetch_Cameo_Surface(BSurface *&surface, const char *name)
+{
+    if (!surface) {
+        surface = Image_Cache_Fetch(name);
     }
+}
+
+
+/**
+ *  Loads the cameo images of all the types into the image cache in one batch.
+ * 
+ *  The image loads are deferred while the main rules and the Firestorm rules
+ *  are processed, this then gathers the names from the merged type data, loads
+ *  them in one batch and assigns the surfaces to the types. Later additions
+ *  (scenario and multiplayer rules) fetch any changed images directly.
+ *  
+ *  @author: agent
+ */
+void RulesClassExtension::Preload_Cameo_Images()
+{
+    Image_Cache_Defer_Loads(false);
+
+    std::vector<const char *> names;
 
-    DEBUG_INFO("Rules: Processing SuperWeaponTypes (Count: %d)...\n", SuperWeaponTypes.Count());
-    for (int index = 0; index < SuperWeaponTypes.Count(); ++index) {
-        SuperWeaponTypes[index]->Read_INI(ini);
+    for (int index = 0; index < BuildingTypeExtensions.Count(); ++index) {
+        Add_Cameo_Name(BuildingTypeExtensions[index], names);
     }
 
-    DEBUG_INFO("Rules: Processing SuperWeaponTypeExtensions (Count: %d)...\n", SuperWeaponTypeExtensions.Count());
-    for (int index = 0; index < SuperWeaponTypeExtensions.Count(); ++index) {
-        SuperWeaponTypeExtensions[index]->Read_INI(ini);
+    for (int index = 0; index < AircraftTypeExtensions.Count(); ++index) {
+        Add_Cameo_Name(AircraftTypeExtensions[index], names);
     }
-    
-    DEBUG_INFO("Rules: Processing AnimTypes (Count: %d)...\n", AnimTypes.Count());
-    for (int index = 0; index < AnimTypes.Count(); ++index) {
-        AnimTypes[index]->Read_INI(ArtINI); // Animations are loaded explicitly from ArtINI.
+
+    for (int index = 0; index < UnitTypeExtensions.Count(); ++index) {
+        Add_Cameo_Name(UnitTypeExtensions[index], names);
     }
-    
-    DEBUG_INFO("Rules: Processing AnimTypeExtensions (Count: %d)...\n", AnimTypeExtensions.Count());
-    for (int index = 0; index < AnimTypeExtensions.Count(); ++index) {
-        AnimTypeExtensions[index]->Read_INI(ArtINI); // Animations are loaded explicitly from ArtINI.
+
+    for (int index = 0; index < InfantryTypeExtensions.Count(); ++index) {
+        Add_Cameo_Name(InfantryTypeExtensions[index], names);
     }
-    
-    DEBUG_INFO("Rules: Processing BuildingTypes (Count: %d)...\n", BuildingTypes.Count());
-    for (int index = 0; index < BuildingTypes.Count(); ++index) {
-        BuildingTypes[index]->Read_INI(ini);
+
+    for (int index = 0; index < SuperWeaponTypeExtensions.Count(); ++index) {
+        const char *sidebar_image = SuperWeaponTypeExtensions[index]->This()->SidebarImage;
+        if (sidebar_image[0] != '\0') {
+            names.push_back(sidebar_image);
+        }
     }
-    
-    DEBUG_INFO("Rules: Processing BuildingTypeExtensions (Count: %d)...\n", BuildingTypeExtensions.Count());
+
+    Image_Cache_Preload(names.data(), (int)names.size());
+
+    /**
+     *  Hand out the surfaces, these are all cache hits now.
+     */
     for (int index = 0; index < BuildingTypeExtensions.Count(); ++index) {
-        BuildingTypeExtensions[index]->Read_INI(ini);
+        Fetch_Cameo_Surface(BuildingTypeExtensions[index]->CameoImageSurface, BuildingTypeExtensions[index]->This()->CameoFilename);
     }
-    
-    DEBUG_INFO("Rules: Processing AircraftTypes (Count: %d)...\n", AircraftTypes.Count());
-    for (int index = 0; index < AircraftTypes.Count(); ++index) {
-        AircraftTypes[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing AircraftTypeExtensions (Count: %d)...\n", AircraftTypeExtensions.Count());
+
     for (int index = 0; index < AircraftTypeExtensions.Count(); ++index) {
-        AircraftTypeExtensions[index]->Read_INI(ini);
+        Fetch_Cameo_Surface(AircraftTypeExtensions[index]->CameoImageSurface, AircraftTypeExtensions[index]->This()->CameoFilename);
     }
-    
-    DEBUG_INFO("Rules: Processing UnitTypes (Count: %d)...\n", UnitTypes.Count());
-    for (int index = 0; index < UnitTypes.Count(); ++index) {
-        UnitTypes[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing UnitTypeExtensions (Count: %d)...\n", UnitTypeExtensions.Count());
+
     for (int index = 0; index < UnitTypeExtensions.Count(); ++index) {
-        UnitTypeExtensions[index]->Read_INI(ini);
+        Fetch_Cameo_Surface(UnitTypeExtensions[index]->CameoImageSurface, UnitTypeExtensions[index]->This()->CameoFilename);
     }
-    
-    DEBUG_INFO("Rules: Processing InfantryTypes (Count: %d)...\n", InfantryTypes.Count());
-    for (int index = 0; index < InfantryTypes.Count(); ++index) {
-        InfantryTypes[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing InfantryTypeExtensions (Count: %d)...\n", InfantryTypeExtensions.Count());
+
     for (int index = 0; index < InfantryTypeExtensions.Count(); ++index) {
-        InfantryTypeExtensions[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing WeaponTypes (Count: %d)...\n", WeaponTypes.Count());
-    for (int index = 0; index < WeaponTypes.Count(); ++index) {
-        WeaponTypes[index]->Read_INI(ini);
+        Fetch_Cameo_Surface(InfantryTypeExtensions[index]->CameoImageSurface, InfantryTypeExtensions[index]->This()->CameoFilename);
     }
 
-    DEBUG_INFO("Rules: Processing WeaponTypeExtensions (Count: %d)...\n", WeaponTypeExtensions.Count());
-    for (int index = 0; index < WeaponTypeExtensions.Count(); ++index) {
-        WeaponTypeExtensions[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing BulletTypes (Count: %d)...\n", BulletTypes.Count());
-    for (int index = 0; index < BulletTypes.Count(); ++index) {
-        BulletTypes[index]->Read_INI(ini);
+    for (int index = 0; index < SuperWeaponTypeExtensions.Count(); ++index) {
+        Fetch_Cameo_Surface(SuperWeaponTypeExtensions[index]->CameoImageSurface, SuperWeaponTypeExtensions[index]->This()->SidebarImage);
     }
 
-    DEBUG_INFO("Rules: Processing BulletTypeExtensions (Count: %d)...\n", BulletTypeExtensions.Count());
-    for (int index = 0; index < BulletTypeExtensions.Count(); ++index) {
-        BulletTypeExtensions[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing WarheadTypes (Count: %d)...\n", WarheadTypes.Count());
-    for (int index = 0; index < WarheadTypes.Count(); ++index) {
-        WarheadTypes[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing WarheadTypeExtensions (Count: %d)...\n", WarheadTypeExtensions.Count());
-    for (int index = 0; index < WarheadTypeExtensions.Count(); ++index) {
-        WarheadTypeExtensions[index]->Read_INI(ini);
+    Image_Cache_Print_Stats();
+}
+
+
+/**
+ *  Reads the INI values for every object in a heap, logging the time taken.
+ * 
+ *  #TODO: The heaps are read serially. A parallel pass over the extension
+ *         heaps is not possible yet: the type getters (Get_Aircraft, the
+ *         weapon and warhead getters) use Find_Or_Make and can add to the
+ *         global heaps, and the INI section index keeps a shared lookup cache,
+ *         so the INI database is not read-only while it is queried.
+ *  
+ *  @author: agent
+ */
+template<class T>
+static void Read_Heap_INI(const char *name, const T &heap, CCINIClass &ini)
+{
+    DWORD start_time = timeGetTime();
+
+    DEBUG_INFO("Rules: Processing %s (Count: %d)...\n", name, heap.Count());
+    for (int index = 0; index < heap.Count(); ++index) {
+        heap[index]->Read_INI(ini);
     }
 
+    DEBUG_INFO("Rules: Processed %s in %d ms.\n", name, timeGetTime() - start_time);
+}
+
+
+/**
+ *  Fetch all the object characteristic values.
+ *  
+ *  @author: CCHyper, ZivDero
+ */
+bool RulesClassExtension::Objects(CCINIClass &ini)
+{
+    //EXT_DEBUG_TRACE("RulesClassExtension::Objects - 0x%08X\n", (uintptr_t)(This()));
+
+    DWORD start_time = timeGetTime();
+
+    /**
+     *  Fetch the game object and extension values from the rules file.
+     */
+    Read_Heap_INI("HouseTypes", HouseTypes, ini);
+    Read_Heap_INI("HouseTypeExtensions", HouseTypeExtensions, ini);
+
+    Read_Heap_INI("SuperWeaponTypes", SuperWeaponTypes, ini);
+    Read_Heap_INI("SuperWeaponTypeExtensions", SuperWeaponTypeExtensions, ini);
+
+    Read_Heap_INI("AnimTypes", AnimTypes, ArtINI); // Animations are loaded explicitly from ArtINI.
+    Read_Heap_INI("AnimTypeExtensions", AnimTypeExtensions, ArtINI);
+
+    Read_Heap_INI("BuildingTypes", BuildingTypes, ini);
+    Read_Heap_INI("BuildingTypeExtensions", BuildingTypeExtensions, ini);
+
+    Read_Heap_INI("AircraftTypes", AircraftTypes, ini);
+    Read_Heap_INI("AircraftTypeExtensions", AircraftTypeExtensions, ini);
+
+    Read_Heap_INI("UnitTypes", UnitTypes, ini);
+    Read_Heap_INI("UnitTypeExtensions", UnitTypeExtensions, ini);
+
+    Read_Heap_INI("InfantryTypes", InfantryTypes, ini);
+    Read_Heap_INI("InfantryTypeExtensions", InfantryTypeExtensions, ini);
+
+    Read_Heap_INI("WeaponTypes", WeaponTypes, ini);
+    Read_Heap_INI("WeaponTypeExtensions", WeaponTypeExtensions, ini);
+
+    Read_Heap_INI("BulletTypes", BulletTypes, ini);
+    Read_Heap_INI("BulletTypeExtensions", BulletTypeExtensions, ini);
+
+    Read_Heap_INI("WarheadTypes", WarheadTypes, ini);
+    Read_Heap_INI("WarheadTypeExtensions", WarheadTypeExtensions, ini);
+
     DEBUG_INFO("Rules: Calling WeaponTypeClass::Set_Speed (Count: %d)...\n", WeaponTypes.Count());
     for (int index = 0; index < WeaponTypes.Count(); ++index) {
         WeaponTypes[index]->Set_Speed();
@@ -486,76 +549,27 @@ bool RulesClassExtension::Objects(CCINIClass &ini)
     for (int index = 0; index < BuildingTypes.Count(); ++index) {
         BuildingTypes[index]->Set_Base_Defense_Values();
     }
-    
-    DEBUG_INFO("Rules: Processing TerrainTypes (Count: %d)...\n", TerrainTypes.Count());
-    for (int index = 0; index < TerrainTypes.Count(); ++index) {
-        TerrainTypes[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing TerrainTypeExtensions (Count: %d)...\n", TerrainTypeExtensions.Count());
-    for (int index = 0; index < TerrainTypeExtensions.Count(); ++index) {
-        TerrainTypeExtensions[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing SmudgeTypes (Count: %d)...\n", SmudgeTypes.Count());
-    for (int index = 0; index < SmudgeTypes.Count(); ++index) {
-        SmudgeTypes[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing SmudgeTypeExtensions (Count: %d)...\n", SmudgeTypeExtensions.Count());
-    for (int index = 0; index < SmudgeTypeExtensions.Count(); ++index) {
-        SmudgeTypeExtensions[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing OverlayTypes (Count: %d)...\n", OverlayTypes.Count());
-    for (int index = 0; index < OverlayTypes.Count(); ++index) {
-        OverlayTypes[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing OverlayTypeExtensions (Count: %d)...\n", OverlayTypeExtensions.Count());
-    for (int index = 0; index < OverlayTypeExtensions.Count(); ++index) {
-        OverlayTypeExtensions[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing ParticleTypes (Count: %d)...\n", ParticleTypes.Count());
-    for (int index = 0; index < ParticleTypes.Count(); ++index) {
-        ParticleTypes[index]->Read_INI(ini);
-    }
 
-    DEBUG_INFO("Rules: Processing ParticleTypeExtensions (Count: %d)...\n", ParticleTypeExtensions.Count());
-    for (int index = 0; index < ParticleTypeExtensions.Count(); ++index) {
-        ParticleTypeExtensions[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing ParticleSystemTypes (Count: %d)...\n", ParticleSystemTypes.Count());
-    for (int index = 0; index < ParticleSystemTypes.Count(); ++index) {
-        ParticleSystemTypes[index]->Read_INI(ini);
-    }
+    Read_Heap_INI("TerrainTypes", TerrainTypes, ini);
+    Read_Heap_INI("TerrainTypeExtensions", TerrainTypeExtensions, ini);
 
-    DEBUG_INFO("Rules: Processing ParticleSystemTypeExtensions (Count: %d)...\n", ParticleSystemTypeExtensions.Count());
-    for (int index = 0; index < ParticleSystemTypeExtensions.Count(); ++index) {
-        ParticleSystemTypeExtensions[index]->Read_INI(ini);
-    }
+    Read_Heap_INI("SmudgeTypes", SmudgeTypes, ini);
+    Read_Heap_INI("SmudgeTypeExtensions", SmudgeTypeExtensions, ini);
 
-    DEBUG_INFO("Rules: Processing Tiberiums (Count: %d)...\n", ::Tiberiums.Count());
-    for (int index = 0; index < ::Tiberiums.Count(); ++index) {
-        ::Tiberiums[index]->Read_INI(ini);
-    }
+    Read_Heap_INI("OverlayTypes", OverlayTypes, ini);
+    Read_Heap_INI("OverlayTypeExtensions", OverlayTypeExtensions, ini);
 
-    DEBUG_INFO("Rules: Processing TiberiumExtensions (Count: %d)...\n", TiberiumExtensions.Count());
-    for (int index = 0; index < TiberiumExtensions.Count(); ++index) {
-        TiberiumExtensions[index]->Read_INI(ini);
-    }
-    
-    DEBUG_INFO("Rules: Processing VoxelAnimTypes (Count: %d)...\n", VoxelAnimTypes.Count());
-    for (int index = 0; index < VoxelAnimTypes.Count(); ++index) {
-        VoxelAnimTypes[index]->Read_INI(ini);
-    }
+    Read_Heap_INI("ParticleTypes", ParticleTypes, ini);
+    Read_Heap_INI("ParticleTypeExtensions", ParticleTypeExtensions, ini);
 
-    DEBUG_INFO("Rules: Processing VoxelAnimTypeExtensions (Count: %d)...\n", VoxelAnimTypeExtensions.Count());
-    for (int index = 0; index < VoxelAnimTypeExtensions.Count(); ++index) {
-        VoxelAnimTypeExtensions[index]->Read_INI(ini);
-    }
+    Read_Heap_INI("ParticleSystemTypes", ParticleSystemTypes, ini);
+    Read_Heap_INI("ParticleSystemTypeExtensions", ParticleSystemTypeExtensions, ini);
+
+    Read_Heap_INI("Tiberiums", ::Tiberiums, ini);
+    Read_Heap_INI("TiberiumExtensions", TiberiumExtensions, ini);
+
+    Read_Heap_INI("VoxelAnimTypes", VoxelAnimTypes, ini);
+    Read_Heap_INI("VoxelAnimTypeExtensions", VoxelAnimTypeExtensions, ini);
 
     DEBUG_INFO("Rules: Processing MissionControlClasses (Count: %d)...\n", MISSION_COUNT);
     for (int mission = 0; mission < MISSION_COUNT; mission++) {
@@ -563,24 +577,16 @@ bool RulesClassExtension::Objects(CCINIClass &ini)
         MissionControl[mission].Read_INI(ini);
     }
 
-    DEBUG_INFO("Rules: Processing SideExtensions (Count: %d)...\n", SideExtensions.Count());
-    for (int index = 0; index < SideExtensions.Count(); ++index) {
-        SideExtensions[index]->Read_INI(ini);
-    }
+    Read_Heap_INI("SideExtensions", SideExtensions, ini);
 
     /**
      *  Fetch new Vinifera object values from the rules file.
      */
+    Read_Heap_INI("ArmorTypes", ArmorTypes, ini);
 
-    DEBUG_INFO("Rules: Processing ArmorTypes (Count: %d)...\n", ArmorTypes.Count());
-    for (int index = 0; index < ArmorTypes.Count(); ++index) {
-        ArmorTypes[index]->Read_INI(ini);
-    }
+    Read_Heap_INI("RocketTypes", RocketTypes, ini);
 
-    DEBUG_INFO("Rules: Processing RocketTypes (Count: %d)...\n", RocketTypes.Count());
-    for (int index = 0; index < RocketTypes.Count(); ++index) {
-        RocketTypes[index]->Read_INI(ini);
-    }
+    DEBUG_INFO("Rules: Processed all objects in %d ms.\n", timeGetTime() - start_time);
 
     return true;
 }
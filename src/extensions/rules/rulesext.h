@@ -60,6 +60,8 @@ class RulesClassExtension final : public GlobalExtensionClass<RulesClass>
 
         bool Objects(CCINIClass &ini);
 
+        void Preload_Cameo_Images();
+
         bool General(CCINIClass &ini);
         bool MPlayer(CCINIClass &ini);
         bool AudioVisual(CCINIClass &ini);
@@ -173,6 +173,11 @@ LRESULT CALLBACK Rules_Dialog_Procedure(HWND hWnd, UINT uMsg, UINT wParam, LONG
  */
 DECLARE_PATCH(_Init_Rules_Extended_Class_Patch)
 {
+    /**
+     *  The main and Firestorm rules have been processed, load the cameo images.
+     */
+    RuleExtension->Preload_Cameo_Images();
+
     /**
      *  #issue-583
      * 
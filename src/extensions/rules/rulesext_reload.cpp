@@ -0,0 +1,485 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          RULESEXT_RELOAD.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Incremental (section diff based) reloading of the rules data.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "rulesext_reload.h"
+#include "rulesext.h"
+#include "rules.h"
+#include "ccini.h"
+#include "addon.h"
+#include "tibsun_globals.h"
+#include "vinifera_globals.h"
+#include "housetype.h"
+#include "supertype.h"
+#include "animtype.h"
+#include "buildingtype.h"
+#include "aircrafttype.h"
+#include "unittype.h"
+#include "infantrytype.h"
+#include "weapontype.h"
+#include "bullettype.h"
+#include "warheadtype.h"
+#include "terraintype.h"
+#include "smudgetype.h"
+#include "overlaytype.h"
+#include "particletype.h"
+#include "particlesystype.h"
+#include "tiberium.h"
+#include "voxelanimtype.h"
+#include "side.h"
+#include "mission.h"
+#include "armortype.h"
+#include "rockettype.h"
+#include "verses.h"
+#include "abstracttypeext.h"
+#include "extension.h"
+#include "extension_globals.h"
+#include "debughandler.h"
+#include "asserthandler.h"
+
+
+/**
+ *  The sections that list the type heaps. If any of these change, types
+ *  may have been added or reordered and only a full reload is safe.
+ */
+static const char * const TypeListSections[] = {
+    "Houses",
+    "Sides",
+    "Colors",
+    "SuperWeaponTypes",
+    "Animations",
+    "BuildingTypes",
+    "AircraftTypes",
+    "VehicleTypes",
+    "InfantryTypes",
+    "Weapons",
+    "Warheads",
+    "TerrainTypes",
+    "SmudgeTypes",
+    "OverlayTypes",
+    "Particles",
+    "ParticleSystems",
+    "Tiberiums",
+    "VoxelAnims",
+    "ArmorTypes",
+    "RocketTypes",
+};
+
+
+/**
+ *  FNV-1a, used to hash the section contents.
+ */
+static const uint32_t HashBasis = 2166136261U;
+static const uint32_t HashPrime = 16777619U;
+
+static uint32_t Hash_String(uint32_t hash, const char *string)
+{
+    while (*string) {
+        hash ^= (unsigned char)*string++;
+        hash *= HashPrime;
+    }
+
+    /**
+     *  Terminate each string so "A=BC" and "AB=C" hash differently.
+     */
+    hash ^= 0xFF;
+    hash *= HashPrime;
+
+    return hash;
+}
+
+
+/**
+ *  Computes a hash of all the entries and values of an INI section.
+ *
+ *  @author: agent
+ */
+uint32_t INI_Section_Hash(CCINIClass &ini, const char *section)
+{
+    if (!section || !ini.Is_Present(section)) {
+        return 0;
+    }
+
+    char buffer[1024];
+    uint32_t hash = HashBasis;
+
+    int count = ini.Entry_Count(section);
+    for (int index = 0; index < count; ++index) {
+        const char *entry = ini.Get_Entry(section, index);
+        if (!entry) {
+            continue;
+        }
+        ini.Get_String(section, entry, "", buffer, sizeof(buffer));
+        hash = Hash_String(hash, entry);
+        hash = Hash_String(hash, buffer);
+    }
+
+    return hash;
+}
+
+
+/**
+ *  Helpers for fetching the optional art section and extension of a type. Types that
+ *  do not derive from ObjectTypeClass or AbstractTypeClass fall through to the void versions.
+ */
+static const char *Art_Name(const ObjectTypeClass *type) { return type->Graphic_Name(); }
+static const char *Art_Name(const void *) { return nullptr; }
+
+static void Read_Extension_INI(const AbstractTypeClass *type, CCINIClass &ini)
+{
+    AbstractTypeClassExtension *ext = Extension::Fetch<AbstractTypeClassExtension>(type);
+    if (ext) {
+        ext->Read_INI(ini);
+    }
+}
+static void Read_Extension_INI(const void *, CCINIClass &) {}
+
+
+/**
+ *  How a heap is read from the rule databases.
+ */
+typedef enum ReloadHeapFlags
+{
+    HEAP_READ_BASE = 1 << 0,     // Call Read_INI on the type itself.
+    HEAP_READ_EXT = 1 << 1,      // Call Read_INI on the types extension.
+    HEAP_ART_ONLY = 1 << 2,      // The type is only read from ArtINI (AnimTypes).
+
+    HEAP_READ_ALL = HEAP_READ_BASE|HEAP_READ_EXT,
+} ReloadHeapFlags;
+
+
+/**
+ *  Walks all type heaps in the same order as RulesClassExtension::Objects, either
+ *  recording the section hashes or re-reading the types whose sections changed.
+ */
+class RulesReloadWalker
+{
+    public:
+        RulesReloadWalker(RulesSnapshotStruct &snapshot) :
+            Snapshot(&snapshot),
+            Before(nullptr),
+            After(nullptr),
+            ScenINI(nullptr),
+            HeapIndex(0),
+            Refreshed(0)
+        {
+        }
+
+        RulesReloadWalker(const RulesSnapshotStruct &before, const RulesSnapshotStruct &after, CCINIClass &scenini) :
+            Snapshot(nullptr),
+            Before(&before),
+            After(&after),
+            ScenINI(&scenini),
+            HeapIndex(0),
+            Refreshed(0)
+        {
+        }
+
+        void Walk();
+
+        int Refreshed_Count() const { return Refreshed; }
+
+    private:
+        template<class T>
+        void Heap(DynamicVectorClass<T *> &heap, const char *heap_name, unsigned flags);
+
+        template<class T>
+        uint32_t Type_Hash(const T *type, unsigned flags) const;
+
+        template<class T>
+        void Refresh_Type(T *type, const char *heap_name, unsigned flags);
+
+    private:
+        RulesSnapshotStruct *Snapshot;
+        const RulesSnapshotStruct *Before;
+        const RulesSnapshotStruct *After;
+        CCINIClass *ScenINI;
+
+        /**
+         *  The heap currently being walked and how many of its entries have been
+         *  processed so far. Types created on demand while refreshing another
+         *  heap (e.g. a new BulletType referenced by a weapon) are picked up by
+         *  a second walk.
+         */
+        int HeapIndex;
+        std::vector<int> Processed;
+
+        int Refreshed;
+};
+
+
+template<class T>
+uint32_t RulesReloadWalker::Type_Hash(const T *type, unsigned flags) const
+{
+    uint32_t hash = HashBasis;
+
+    if (flags & HEAP_ART_ONLY) {
+        hash ^= INI_Section_Hash(ArtINI, type->Name());
+        return hash * HashPrime;
+    }
+
+    hash ^= INI_Section_Hash(*RuleINI, type->Name());
+    hash *= HashPrime;
+
+    if (Is_Addon_Available(ADDON_FIRESTORM) && Is_Addon_Enabled(ADDON_FIRESTORM)) {
+        hash ^= INI_Section_Hash(FSRuleINI, type->Name());
+        hash *= HashPrime;
+    }
+
+    const char *art_name = Art_Name(type);
+    if (art_name) {
+        hash ^= INI_Section_Hash(ArtINI, art_name);
+        hash *= HashPrime;
+    }
+
+    return hash;
+}
+
+
+template<class T>
+void RulesReloadWalker::Refresh_Type(T *type, const char *heap_name, unsigned flags)
+{
+    if (flags & HEAP_ART_ONLY) {
+        if (flags & HEAP_READ_BASE) type->Read_INI(ArtINI);
+        if (flags & HEAP_READ_EXT) Read_Extension_INI(type, ArtINI);
+
+    } else {
+
+        /**
+         *  Apply the databases in the same order as the full load does.
+         */
+        CCINIClass *inis[3] = { RuleINI, nullptr, ScenINI };
+        if (Is_Addon_Available(ADDON_FIRESTORM) && Is_Addon_Enabled(ADDON_FIRESTORM)) {
+            inis[1] = &FSRuleINI;
+        }
+
+        for (size_t i = 0; i < std::size(inis); ++i) {
+            if (!inis[i]) {
+                continue;
+            }
+            if (flags & HEAP_READ_BASE) type->Read_INI(*inis[i]);
+            if (flags & HEAP_READ_EXT) Read_Extension_INI(type, *inis[i]);
+        }
+    }
+
+    DEBUG_INFO("Rules:   Refreshed %s \"%s\".\n", heap_name, type->Name());
+
+    ++Refreshed;
+}
+
+
+template<class T>
+void RulesReloadWalker::Heap(DynamicVectorClass<T *> &heap, const char *heap_name, unsigned flags)
+{
+    /**
+     *  Recording a snapshot.
+     */
+    if (Snapshot) {
+        std::vector<uint32_t> hashes;
+        hashes.reserve(heap.Count());
+        for (int index = 0; index < heap.Count(); ++index) {
+            hashes.push_back(Type_Hash(heap[index], flags));
+        }
+        Snapshot->HeapHashes.push_back(hashes);
+        ++HeapIndex;
+        return;
+    }
+
+    /**
+     *  Refreshing changed types.
+     */
+    if (HeapIndex >= (int)Processed.size()) {
+        Processed.push_back(0);
+    }
+
+    const std::vector<uint32_t> &before = Before->HeapHashes[HeapIndex];
+    const std::vector<uint32_t> &after = After->HeapHashes[HeapIndex];
+
+    for (int index = Processed[HeapIndex]; index < heap.Count(); ++index) {
+
+        /**
+         *  Types beyond the snapshot were created during this reload, so always read them.
+         */
+        bool changed = true;
+        if ((size_t)index < after.size()) {
+            changed = before[index] != after[index];
+        }
+
+        if (changed) {
+            Refresh_Type(heap[index], heap_name, flags);
+        }
+    }
+
+    Processed[HeapIndex] = heap.Count();
+    ++HeapIndex;
+}
+
+
+void RulesReloadWalker::Walk()
+{
+    HeapIndex = 0;
+
+    Heap(HouseTypes, "HouseType", HEAP_READ_ALL);
+    Heap(SuperWeaponTypes, "SuperWeaponType", HEAP_READ_ALL);
+    Heap(AnimTypes, "AnimType", HEAP_READ_ALL|HEAP_ART_ONLY);
+    Heap(BuildingTypes, "BuildingType", HEAP_READ_ALL);
+    Heap(AircraftTypes, "AircraftType", HEAP_READ_ALL);
+    Heap(UnitTypes, "UnitType", HEAP_READ_ALL);
+    Heap(InfantryTypes, "InfantryType", HEAP_READ_ALL);
+    Heap(WeaponTypes, "WeaponType", HEAP_READ_ALL);
+    Heap(BulletTypes, "BulletType", HEAP_READ_ALL);
+
+    /**
+     *  Warheads created on demand by a refreshed weapon need their Verses entries.
+     */
+    if (!Snapshot) {
+        Verses::Resize();
+    }
+
+    Heap(WarheadTypes, "WarheadType", HEAP_READ_ALL);
+    Heap(TerrainTypes, "TerrainType", HEAP_READ_ALL);
+    Heap(SmudgeTypes, "SmudgeType", HEAP_READ_ALL);
+    Heap(OverlayTypes, "OverlayType", HEAP_READ_ALL);
+    Heap(ParticleTypes, "ParticleType", HEAP_READ_ALL);
+    Heap(ParticleSystemTypes, "ParticleSystemType", HEAP_READ_ALL);
+    Heap(::Tiberiums, "Tiberium", HEAP_READ_ALL);
+    Heap(VoxelAnimTypes, "VoxelAnimType", HEAP_READ_ALL);
+    Heap(Sides, "Side", HEAP_READ_EXT);
+    Heap(ArmorTypes, "ArmorType", HEAP_READ_BASE);
+    Heap(RocketTypes, "RocketType", HEAP_READ_BASE);
+}
+
+
+/**
+ *  Record the section hashes of the currently loaded rule databases.
+ *
+ *  @author: agent
+ */
+void Rules_Take_Snapshot(RulesSnapshotStruct &snapshot)
+{
+    snapshot.ListHashes.clear();
+    snapshot.HeapHashes.clear();
+
+    for (size_t i = 0; i < std::size(TypeListSections); ++i) {
+        uint32_t hash = INI_Section_Hash(*RuleINI, TypeListSections[i]);
+        hash ^= INI_Section_Hash(FSRuleINI, TypeListSections[i]) * HashPrime;
+        snapshot.ListHashes.push_back(hash);
+    }
+
+    RulesReloadWalker walker(snapshot);
+    walker.Walk();
+}
+
+
+/**
+ *  Have any of the type list sections changed between the two snapshots?
+ *
+ *  @author: agent
+ */
+bool Rules_Is_Type_List_Changed(const RulesSnapshotStruct &before, const RulesSnapshotStruct &after)
+{
+    if (before.ListHashes != after.ListHashes || before.HeapHashes.size() != after.HeapHashes.size()) {
+        return true;
+    }
+
+    for (size_t i = 0; i < before.HeapHashes.size(); ++i) {
+        if (before.HeapHashes[i].size() != after.HeapHashes[i].size()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ *  Re-reads only the types whose rule or art sections differ between the
+ *  two snapshots, followed by the (inexpensive) global rule sections.
+ *
+ *  @warning: Both snapshots must have been taken with identical type lists!
+ *
+ *  @author: agent
+ */
+int Rules_Reload_Changed(const RulesSnapshotStruct &before, const RulesSnapshotStruct &after, CCINIClass &scenini)
+{
+    ASSERT(!Rules_Is_Type_List_Changed(before, after));
+
+    RulesReloadWalker walker(before, after, scenini);
+
+    /**
+     *  The second walk picks up any types that were created on demand by types
+     *  refreshed in a later heap than their own.
+     */
+    walker.Walk();
+    walker.Walk();
+
+    for (int index = 0; index < WeaponTypes.Count(); ++index) {
+        WeaponTypes[index]->Set_Speed();
+    }
+
+    for (int index = 0; index < BuildingTypes.Count(); ++index) {
+        BuildingTypes[index]->Set_Base_Defense_Values();
+    }
+
+    /**
+     *  The global sections are cheap to read, so re-read them unconditionally.
+     */
+    CCINIClass *inis[3] = { RuleINI, nullptr, &scenini };
+    if (Is_Addon_Available(ADDON_FIRESTORM) && Is_Addon_Enabled(ADDON_FIRESTORM)) {
+        inis[1] = &FSRuleINI;
+    }
+
+    for (size_t i = 0; i < std::size(inis); ++i) {
+        if (!inis[i]) {
+            continue;
+        }
+        CCINIClass &ini = *inis[i];
+
+        Rule->JumpjetControls(ini);
+        Rule->MPlayer(ini);
+        Rule->AI(ini);
+        Rule->Powerups(ini);
+        Rule->Land_Types(ini);
+        Rule->IQ(ini);
+        Rule->General(ini);
+        Rule->Difficulty(ini);
+        Rule->CrateRules(ini);
+        Rule->CombatDamage(ini);
+        Rule->AudioVisual(ini);
+        Rule->SpecialWeapons(ini);
+
+        for (int mission = 0; mission < MISSION_COUNT; mission++) {
+            MissionControl[mission].Read_INI(ini);
+        }
+
+        RuleExtension->General(ini);
+        RuleExtension->MPlayer(ini);
+        RuleExtension->AudioVisual(ini);
+        RuleExtension->CombatDamage(ini);
+    }
+
+    return walker.Refreshed_Count();
+}
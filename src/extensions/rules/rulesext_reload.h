@@ -0,0 +1,55 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          RULESEXT_RELOAD.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Incremental (section diff based) reloading of the rules data.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+#include <vector>
+
+
+class CCINIClass;
+
+
+/**
+ *  A snapshot of the section hashes of the currently loaded rule databases.
+ *
+ *  The type hashes are stored per heap in the order the heaps are walked, so
+ *  two snapshots can only be compared entry by entry if the type list sections
+ *  (and therefore the heaps) have not changed between them.
+ */
+struct RulesSnapshotStruct
+{
+    std::vector<uint32_t> ListHashes;
+    std::vector<std::vector<uint32_t>> HeapHashes;
+};
+
+
+uint32_t INI_Section_Hash(CCINIClass &ini, const char *section);
+
+void Rules_Take_Snapshot(RulesSnapshotStruct &snapshot);
+bool Rules_Is_Type_List_Changed(const RulesSnapshotStruct &before, const RulesSnapshotStruct &after);
+int Rules_Reload_Changed(const RulesSnapshotStruct &before, const RulesSnapshotStruct &after, CCINIClass &scenini);
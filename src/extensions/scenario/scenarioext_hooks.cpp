@@ -45,6 +45,8 @@
 #include "hooker.h"
 #include "hooker_macros.h"
 #include "kamikazetracker.h"
+#include "buildingext_hooks.h"
+#include "imagecache.h"
 #include "mouse.h"
 #include "vinifera_globals.h"
 
@@ -98,6 +100,10 @@ DECLARE_PATCH(_Clear_Scenario_Patch)
 
     KamikazeTracker->Clear();
 
+    Buildables_Cache_Invalidate();
+
+    Image_Cache_Purge();
+
     JMP(0x005DC872);
 }
 
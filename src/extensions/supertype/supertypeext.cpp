@@ -28,6 +28,7 @@
 #include "supertypeext.h"
 #include "supertype.h"
 #include "vinifera_util.h"
+#include "imagecache.h"
 #include "bsurface.h"
 #include "ccini.h"
 #include "extension.h"
@@ -74,7 +75,7 @@ SuperWeaponTypeClassExtension::~SuperWeaponTypeClassExtension()
 {
     //EXT_DEBUG_TRACE("SuperWeaponTypeClassExtension::~SuperWeaponTypeClassExtension - Name: %s (0x%08X)\n", Name(), (uintptr_t)(This()));
 
-    delete CameoImageSurface;
+    Image_Cache_Release(CameoImageSurface);
     CameoImageSurface = nullptr;
 
     SuperWeaponTypeExtensions.Delete(this);
@@ -119,10 +120,7 @@ HRESULT SuperWeaponTypeClassExtension::Load(IStream *pStm)
     /**
      *  Fetch the cameo image surface if it exists.
      */
-    BSurface *imagesurface = Vinifera_Get_Image_Surface(SidebarImage);
-    if (imagesurface) {
-        CameoImageSurface = imagesurface;
-    }
+    CameoImageSurface = Image_Cache_Fetch(SidebarImage);
     
     return hr;
 }
@@ -206,8 +204,9 @@ bool SuperWeaponTypeClassExtension::Read_INI(CCINIClass &ini)
     /**
      *  Fetch the cameo image surface if it exists.
      */
-    BSurface *imagesurface = Vinifera_Get_Image_Surface(This()->SidebarImage);
+    BSurface *imagesurface = Image_Cache_Fetch(This()->SidebarImage);
     if (imagesurface) {
+        Image_Cache_Release(CameoImageSurface);
         CameoImageSurface = imagesurface;
     }
 
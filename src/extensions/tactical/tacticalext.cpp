@@ -54,6 +54,10 @@
 #include "extension.h"
 #include "asserthandler.h"
 #include "debughandler.h"
+#include "profiler.h"
+#include "textcache.h"
+#include "framepacer.h"
+#include <algorithm>
 
 
 /**
@@ -96,6 +100,11 @@ TacticalExtension::TacticalExtension(const NoInitClass &noinit) :
 TacticalExtension::~TacticalExtension()
 {
     //EXT_DEBUG_TRACE("TacticalExtension::~TacticalExtension - Name: %s (0x%08X)\n", Name(), (uintptr_t)(This()));
+
+    /**
+     *  Release the cached overlay text along with the tactical map.
+     */
+    Text_Run_Cache_Clear();
 }
 
 
@@ -376,11 +385,98 @@ void TacticalExtension::Draw_FrameStep_Overlay()
     /**
      *  Draw the overlay text.
      */
-    Fancy_Text_Print(text, CompositeSurface, &CompositeSurface->Get_Rect(),
+    Text_Run_Print(text, CompositeSurface, &CompositeSurface->Get_Rect(),
         &Point2D(text_rect.X, text_rect.Y), text_color, COLOR_TBLACK, TextPrintType(TPF_RIGHT|TPF_6PT_GRAD|TPF_NOSHADOW));
 }
 
 
+/**
+ *  Draws the profiler frame time graph and the per section breakdown.
+ * 
+ *  @author: agent
+ */
+void TacticalExtension::Draw_Profiler_Overlay()
+{
+    RGBClass rgb_black(0,0,0);
+    unsigned color_good = DSurface::RGB_To_Pixel(0, 200, 0);
+    unsigned color_bad = DSurface::RGB_To_Pixel(200, 0, 0);
+    unsigned color_budget = DSurface::RGB_To_Pixel(255, 255, 0);
+    ColorScheme *text_color = ColorScheme::As_Pointer("White");
+
+    int padding = 2;
+    int graph_height = 48;
+    int line_height = 10;
+    int panel_width = 200;
+
+    /**
+     *  The graph covers twice the frame time budget of the desired frame rate.
+     */
+    int frame_rate = Session.DesiredFrameRate > 0 ? Session.DesiredFrameRate : 60;
+    float budget = 1000.0f / frame_rate;
+    float scale = graph_height / (budget * 2.0f);
+
+    /**
+     *  Fill the background area.
+     */
+    Rect fill_rect;
+    fill_rect.X = TacticalRect.X;
+    fill_rect.Y = TacticalRect.Y;
+    fill_rect.Width = std::max(PROFILE_HISTORY_MAX+(padding*2), panel_width);
+    fill_rect.Height = graph_height+(padding*2)+((PROFILE_COUNT+1)*line_height)+padding;
+    CompositeSurface->Fill_Rect_Trans(fill_rect, rgb_black, 50);
+
+    /**
+     *  Draw the frame time graph, newest frame on the right.
+     */
+    int graph_x = fill_rect.X+padding;
+    int graph_bottom = fill_rect.Y+padding+graph_height;
+
+    for (int i = 0; i < Profiler_History_Count(); ++i) {
+        float time = Profiler_Frame_Time(PROFILE_FRAME, i);
+        int height = std::min(int(time * scale), graph_height);
+        if (height <= 0) {
+            continue;
+        }
+
+        Rect bar_rect(graph_x+PROFILE_HISTORY_MAX-1-i, graph_bottom-height, 1, height);
+        CompositeSurface->Fill_Rect(bar_rect, time > budget ? color_bad : color_good);
+    }
+
+    Rect budget_rect(graph_x, graph_bottom-(graph_height/2), PROFILE_HISTORY_MAX, 1);
+    CompositeSurface->Fill_Rect(budget_rect, color_budget);
+
+    /**
+     *  Draw the per section breakdown.
+     */
+    char buffer[128];
+    int text_y = graph_bottom+padding;
+
+    for (int section = PROFILE_FIRST; section < PROFILE_COUNT; ++section) {
+
+        std::snprintf(buffer, sizeof(buffer), "%s: %.2f ms (peak %.2f ms)",
+            Profiler_Section_Name(ProfileSectionType(section)),
+            Profiler_Average_Time(ProfileSectionType(section)),
+            Profiler_Peak_Time(ProfileSectionType(section)));
+
+        Fancy_Text_Print(buffer, CompositeSurface, &CompositeSurface->Get_Rect(),
+            &Point2D(graph_x, text_y), text_color, COLOR_TBLACK, TextPrintType(TPF_6PT_GRAD|TPF_NOSHADOW));
+
+        text_y += line_height;
+    }
+
+    /**
+     *  Draw the achieved frame interval percentiles from the frame pacer.
+     */
+    std::snprintf(buffer, sizeof(buffer), "Frame pacing: p50 %.2f p95 %.2f p99 %.2f ms",
+        Frame_Pacer_Percentile(50.0f),
+        Frame_Pacer_Percentile(95.0f),
+        Frame_Pacer_Percentile(99.0f));
+
+    Fancy_Text_Print(buffer, CompositeSurface, &CompositeSurface->Get_Rect(),
+        &Point2D(graph_x, text_y), text_color, COLOR_TBLACK, TextPrintType(TPF_6PT_GRAD|TPF_NOSHADOW));
+}
+
+
 /**
  *  Draw the overlay information text if set.
  * 
@@ -504,7 +600,7 @@ void TacticalExtension::Draw_Information_Text()
     /**
      *  Draw the overlay text.
      */
-    Fancy_Text_Print(text, CompositeSurface, &CompositeSurface->Get_Rect(),
+    Text_Run_Print(text, CompositeSurface, &CompositeSurface->Get_Rect(),
         &Point2D(text_rect.X, text_rect.Y), text_color, COLOR_TBLACK, style);
 }
 
@@ -518,12 +614,15 @@ void TacticalExtension::Render_Post()
 {
     //EXT_DEBUG_TRACE("TacticalExtension::Render_Post - 0x%08X\n", (uintptr_t)(This()));
 
+    ProfileScopeClass profile(PROFILE_RENDER_POST);
+
     /**
      *  Draw any new post effects here.
      */
-    //DEV_DEBUG_INFO("Before EBoltClass::Draw_All\n");
-    EBoltClass::Draw_All();
-    //DEV_DEBUG_INFO("After EBoltClass::Draw_All\n");
+    {
+        ProfileScopeClass profile_ebolts(PROFILE_EBOLTS);
+        EBoltClass::Draw_All();
+    }
 
     /**
      *  Draw any overlay text.
@@ -615,10 +714,10 @@ void TacticalExtension::Super_Draw_Timer(int row_index, ColorScheme *color, int
     //CompositeSurface->Fill_Rect(CompositeSurface->Get_Rect(), fill_rect, color_black);
     CompositeSurface->Fill_Rect_Trans(fill_rect, rgb_black, background_tint);
 
-    Fancy_Text_Print(timerbuff, CompositeSurface, &CompositeSurface->Get_Rect(), 
+    Text_Run_Print(timerbuff, CompositeSurface, &CompositeSurface->Get_Rect(), 
         &timer_point, to_flash ? white_color : color, COLOR_TBLACK, style);
 
-    Fancy_Text_Print(namebuff, CompositeSurface, &CompositeSurface->Get_Rect(), 
+    Text_Run_Print(namebuff, CompositeSurface, &CompositeSurface->Get_Rect(), 
         &name_point, color, COLOR_TBLACK, style);
 }
 
@@ -632,6 +731,8 @@ void TacticalExtension::Draw_Super_Timers()
 {
     //EXT_DEBUG_TRACE("TacticalExtension::Draw_Super_Timers - 0x%08X\n", (uintptr_t)(This()));
 
+    ProfileScopeClass profile(PROFILE_SUPER_TIMERS);
+
     /**
      *  Super weapon timers are for multiplayer only.
      */
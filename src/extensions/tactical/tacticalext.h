@@ -74,6 +74,7 @@ class TacticalExtension final : public GlobalExtensionClass<Tactical>
 
         void Draw_Debug_Overlay();
         void Draw_FrameStep_Overlay();
+        void Draw_Profiler_Overlay();
 
         void Draw_Information_Text();
         void Draw_Super_Timers();
@@ -221,7 +221,8 @@ static bool Should_Exclude_From_Selection(ObjectClass* obj)
     /**
      *  Don't exclude objects that we don't own.
      */
-    if (obj->Owning_House() != nullptr && !obj->Owning_House()->IsPlayerControl) {
+    HouseClass* owner = obj->Owning_House();
+    if (owner != nullptr && !owner->IsPlayerControl) {
         return false;
     }
 
@@ -247,27 +248,29 @@ static void Filter_Selection()
         return;
     }
 
-    bool any_to_exclude = false;
-    bool all_to_exclude = true;
+    /**
+     *  Evaluate every selected object only once, the result is reused
+     *  when removing the excluded objects below.
+     */
+    DynamicVectorClass<ObjectClass*> to_exclude;
 
     for (int i = 0; i < CurrentObjects.Count(); i++) {
-        const bool exclude = Should_Exclude_From_Selection(CurrentObjects[i]);
-        any_to_exclude |= exclude;
-        all_to_exclude &= exclude;
+        if (Should_Exclude_From_Selection(CurrentObjects[i])) {
+            to_exclude.Add(CurrentObjects[i]);
+        }
     }
 
-    if (any_to_exclude && !all_to_exclude) {
-        for (int i = 0; i < CurrentObjects.Count(); i++) {
-            if (Should_Exclude_From_Selection(CurrentObjects[i])) {
+    if (to_exclude.Count() == 0 || to_exclude.Count() == CurrentObjects.Count()) {
+        return;
+    }
 
-                const int count_before = CurrentObjects.Count();
-                CurrentObjects[i]->Unselect();
-                const int count_after = CurrentObjects.Count();
-                if (count_after < count_before) {
-                    i--;
-                }
-            }
-        }
+    /**
+     *  Unselect in reverse order, the excluded objects are stored in selection
+     *  order, so this keeps the amount of entries CurrentObjects has to shift
+     *  down on each removal to a minimum.
+     */
+    for (int i = to_exclude.Count() - 1; i >= 0; i--) {
+        to_exclude[i]->Unselect();
     }
 }
 
@@ -279,10 +282,25 @@ static void Filter_Selection()
  */
 static bool Has_NonCombatants_Selected()
 {
+    /**
+     *  Selections are usually made up of only a handful of different types,
+     *  so remember the last type checked to avoid fetching its extension again.
+     */
+    const TechnoTypeClass* last_type = nullptr;
+
     for (int i = 0; i < CurrentObjects.Count(); i++)
     {
-        if (CurrentObjects[i]->Is_Techno() && Extension::Fetch<TechnoTypeClassExtension>(CurrentObjects[i]->Techno_Type_Class())->IsFilterFromBandBoxSelection)
+        if (!CurrentObjects[i]->Is_Techno())
+            continue;
+
+        const TechnoTypeClass* type = CurrentObjects[i]->Techno_Type_Class();
+        if (type == last_type)
+            continue;
+
+        if (Extension::Fetch<TechnoTypeClassExtension>(type)->IsFilterFromBandBoxSelection)
             return true;
+
+        last_type = type;
     }
 
     return false;
@@ -304,13 +322,20 @@ void TacticalExt::_Select_These(Rect& rect, void (*selection_func)(ObjectClass*
 
     if (rect.Width > 0 && rect.Height > 0 && DirtyObjectCount > 0)
     {
+        /**
+         *  Translate the band box into the dirty object space once, rather
+         *  than offsetting the position of every dirty object we test.
+         */
+        Rect dirty_rect = rect;
+        dirty_rect.X += field_5C.X;
+        dirty_rect.Y += field_5C.Y;
+
         for (int i = 0; i < DirtyObjectCount; i++)
         {
-            const auto dirty = DirtyObjects[i];
+            const auto& dirty = DirtyObjects[i];
             if (dirty.Object && dirty.Object->IsActive)
             {
-                Point2D position = dirty.Position - field_5C;
-                if (rect.Is_Within(position))
+                if (dirty_rect.Is_Within(dirty.Position))
                 {
                     if (selection_func)
                     {
@@ -719,6 +744,10 @@ DECLARE_PATCH(_Tactical_Render_Overlay_Patch)
         if (Vinifera_Developer_FrameStep) {
             TacticalMapExtension->Draw_FrameStep_Overlay();
         }
+
+        if (Vinifera_Developer_Profiler) {
+            TacticalMapExtension->Draw_Profiler_Overlay();
+        }
     }
 
 #ifndef NDEBUG
@@ -57,12 +57,14 @@
 #include "voc.h"
 #include "tactical.h"
 #include "clipline.h"
+#include "linebatch.h"
 #include "mouse.h"
 #include "vinifera_util.h"
 #include "extension.h"
 #include "fatal.h"
 #include "asserthandler.h"
 #include "buildingext.h"
+#include "buildingext_hooks.h"
 #include "debughandler.h"
 #include "drawshape.h"
 #include "cell.h"
@@ -1401,91 +1403,25 @@ void TechnoClassExt::_Draw_Target_Laser() const
     /**
      *  Draw the target laser line.
      */
-    if (Clip_Line(start_point, end_point, TacticalRect)) {
-
-        Point2D drop_start_point = start_point;
-        Point2D drop_end_point = end_point;
-
-        drop_start_point.Y += 1;
-        drop_end_point.Y += 1;
-
-        if (is_dashed) {
-
-            /**
-             *  1 pixel on, 1 off, 1 on, 1 off...
-             */
-            static bool _pattern[] = { true, false, true, false, true, false, true, false, true, false, true, false, true, false, true, false };
-
-            /**
-             *  Adjust the offset of the line pattern.
-             */
-            int offset = 7 * Frame % 16;
-
-            /**
-             *  Draw the drop shadow line.
-             */
-            if (is_dropshadow) {
-
-                if (is_thick) {
-                    drop_start_point.Y += 1;
-                    drop_end_point.Y += 1;
-                }
-
-                CompositeSurface->Draw_Dashed_Line(drop_start_point, drop_end_point, drop_color, _pattern, offset);
-
-                if (is_thick) {
-                    drop_start_point.Y += 1;
-                    drop_end_point.Y += 1;
-                    CompositeSurface->Draw_Dashed_Line(drop_start_point, drop_end_point, drop_color, _pattern, offset);
-                }
-
-            }
-
-            /**
-             *  Draw the dashed target laser line.
-             */
-            CompositeSurface->Draw_Dashed_Line(start_point, end_point, line_color, _pattern, offset);
-
-            if (is_thick) {
-                start_point.Y += 1;
-                end_point.Y += 1;
-                CompositeSurface->Draw_Dashed_Line(start_point, end_point, line_color, _pattern, offset);
-            }
-
-        }
-        else {
-
-            /**
-             *  Draw the drop shadow line.
-             */
-            if (is_dropshadow) {
+    LineBatchClass batch(CompositeSurface, TacticalRect);
 
-                if (is_thick) {
-                    drop_start_point.Y += 1;
-                    drop_end_point.Y += 1;
-                }
-
-                CompositeSurface->Draw_Line(drop_start_point, drop_end_point, drop_color);
-
-                if (is_thick) {
-                    drop_start_point.Y += 1;
-                    drop_end_point.Y += 1;
-                    CompositeSurface->Draw_Line(drop_start_point, drop_end_point, drop_color);
-                }
+    if (Clip_Line(start_point, end_point, TacticalRect)) {
 
-            }
+        /**
+         *  1 pixel on, 1 off, 1 on, 1 off...
+         */
+        static bool _pattern[] = { true, false, true, false, true, false, true, false, true, false, true, false, true, false, true, false };
 
-            /**
-             *  Draw the target laser line.
-             */
-            CompositeSurface->Draw_Line(start_point, end_point, line_color);
+        /**
+         *  Adjust the offset of the line pattern.
+         */
+        int offset = 7 * Frame % 16;
 
-            if (is_thick) {
-                start_point.Y += 1;
-                end_point.Y += 1;
-                CompositeSurface->Draw_Line(start_point, end_point, line_color);
-            }
+        batch.Add_Line(start_point, end_point, line_color, drop_color, is_thick, is_dropshadow, is_dashed ? _pattern : nullptr, offset);
 
+        if (is_thick) {
+            start_point.Y += 1;
+            end_point.Y += 1;
         }
 
     }
@@ -1503,17 +1439,19 @@ void TechnoClassExt::_Draw_Target_Laser() const
         }
 
         Rect drop_start_point_rect = TacticalRect.Intersect_With(Rect(start_point + drop_point_offset, drop_point_size, drop_point_size));
-        CompositeSurface->Fill_Rect(drop_start_point_rect, drop_color);
+        batch.Add_Point(drop_start_point_rect, drop_color, true);
 
         Rect drop_end_point_rect = TacticalRect.Intersect_With(Rect(end_point + drop_point_offset, drop_point_size, drop_point_size));
-        CompositeSurface->Fill_Rect(drop_end_point_rect, drop_color);
+        batch.Add_Point(drop_end_point_rect, drop_color, true);
     }
 
     Rect start_point_rect = TacticalRect.Intersect_With(Rect(start_point + point_offset, point_size, point_size));
-    CompositeSurface->Fill_Rect(start_point_rect, line_color);
+    batch.Add_Point(start_point_rect, line_color);
 
     Rect end_point_rect = TacticalRect.Intersect_With(Rect(end_point + point_offset, point_size, point_size));
-    CompositeSurface->Fill_Rect(end_point_rect, line_color);
+    batch.Add_Point(end_point_rect, line_color);
+
+    batch.Flush();
 }
 
 
@@ -2384,7 +2322,7 @@ DECLARE_PATCH(_TechnoClass_Take_Damage_Drop_Tiberium_Type_Patch)
 
 
 /**
- *  Patch to update the spawn manager when its owner is captured.
+ *  Patch to update the spawn manager and the buildables cache when the object is captured.
  *
  *  @author: ZivDero
  */
@@ -2399,6 +2337,12 @@ DECLARE_PATCH(_TechnoClass_Captured_Spawn_Manager_Patch)
     if (extension->SpawnManager)
         extension->SpawnManager->Detach_Spawns();
 
+    /**
+     *  The object has changed owner, which the buildables cache cannot
+     *  see from the object counts alone.
+     */
+    Buildables_Cache_Invalidate();
+
     // Stolen instructions
     if (this_ptr->Tag)
         _Tag_Spring_Entered(this_ptr);
@@ -31,6 +31,7 @@
 #include "technotype.h"
 #include "ccini.h"
 #include "filepng.h"
+#include "imagecache.h"
 #include "swizzle.h"
 #include "bsurface.h"
 #include "tibsun_globals.h"
@@ -113,7 +114,7 @@ TechnoTypeClassExtension::~TechnoTypeClassExtension()
 {
     //EXT_DEBUG_TRACE("TechnoTypeClassExtension::~TechnoTypeClassExtension - Name: %s (0x%08X)\n", Name(), (uintptr_t)(This()));
 
-    delete CameoImageSurface;
+    Image_Cache_Release(CameoImageSurface);
     CameoImageSurface = nullptr;
 }
 
@@ -143,6 +144,11 @@ HRESULT TechnoTypeClassExtension::Load(IStream *pStm)
     const char *graphic_name = GraphicName;
 
     char cameo_buffer[32];
+
+    /**
+     *  The surface pointer loaded from the stream is from the previous session.
+     */
+    CameoImageSurface = nullptr;
     
     ArtINI.Get_String(ini_name, "Cameo", "XXICON", cameo_buffer, sizeof(cameo_buffer));
     if (Wstring(cameo_buffer) != "XXICON") {
@@ -152,10 +158,7 @@ HRESULT TechnoTypeClassExtension::Load(IStream *pStm)
         /**
          *  Fetch the cameo image surface if it exists.
          */
-        BSurface *imagesurface = Vinifera_Get_Image_Surface(cameo_buffer);
-        if (imagesurface) {
-            CameoImageSurface = imagesurface;
-        }
+        CameoImageSurface = Image_Cache_Fetch(cameo_buffer);
 
     }
     
@@ -299,8 +302,9 @@ bool TechnoTypeClassExtension::Read_INI(CCINIClass &ini)
     /**
      *  Fetch the cameo image surface if it exists.
      */
-    BSurface* imagesurface = Vinifera_Get_Image_Surface(This()->CameoFilename);
+    BSurface* imagesurface = Image_Cache_Fetch(This()->CameoFilename);
     if (imagesurface) {
+        Image_Cache_Release(CameoImageSurface);
         CameoImageSurface = imagesurface;
     }
 
@@ -292,6 +292,11 @@ bool WarheadTypeClassExtension::Read_INI(CCINIClass &ini)
 
     MinDamage = ini.Get_Int(ini_name, "MinDamage", MinDamage);
 
+    /**
+     *  Flag the cached warhead damage profiles for rebuilding.
+     */
+    Verses::Mark_Changed();
+
     IsInitialized = true;
 
     return true;
@@ -26,6 +26,7 @@
  *
  ******************************************************************************/
 #include "armortype.h"
+#include "verses.h"
 #include "ccini.h"
 #include "vinifera_globals.h"
 #include "tibsun_globals.h"
@@ -346,6 +347,11 @@ bool ArmorTypeClass::Read_INI(CCINIClass& ini)
     Retaliate = ini.Get_Bool(IniName, "Retaliate", Retaliate);
     BaseArmor = ini.Get_ArmorType(IniName, "BaseArmor", BaseArmor);
 
+    /**
+     *  The Verses defaults come from the armor.
+     */
+    Verses::Mark_Changed();
+
     return true;
 }
 
@@ -45,6 +45,30 @@
 #include "weapontypeext.h"
 #include "rockettype.h"
 #include "vinifera_saveload.h"
+#include <cstring>
+#include <vector>
+
+
+/**
+ *  The version of the saved spawn control block, increment this when the
+ *  layout of the spawn control arrays changes.
+ */
+#define SPAWN_CONTROLS_VERSION 1
+
+/**
+ *  The size of the saved state of a single spawn control.
+ */
+#define SPAWN_CONTROL_SIZE (sizeof(AircraftClass*) + sizeof(SpawnControlStatus) + sizeof(CDTimerClass<FrameTimerClass>))
+
+
+/**
+ *  Precedes the spawn control arrays in the save stream.
+ */
+struct SpawnControlsHeaderStruct
+{
+    int Version;
+    int Count;
+};
 
 
 /**
@@ -76,32 +100,57 @@ IFACEMETHODIMP SpawnManagerClass::Load(IStream* pStm)
 
     new (this) SpawnManagerClass(NoInitClass());
 
+    new (&Spawnees) DynamicVectorClass<AircraftClass*>();
+    new (&SpawnStatuses) DynamicVectorClass<SpawnControlStatus>();
+    new (&ReloadTimers) DynamicVectorClass<CDTimerClass<FrameTimerClass>>();
+
     /**
-     *  Read the count of active spawn controls.
+     *  Read the spawn control block header.
      */
-    hr = pStm->Read(&SpawnCount, sizeof(SpawnCount), nullptr);
+    SpawnControlsHeaderStruct header;
+    hr = pStm->Read(&header, sizeof(header), nullptr);
     if (FAILED(hr))
         return hr;
 
-    new (&SpawnControls) DynamicVectorClass<SpawnControl*>();
-
-    if (SpawnCount <= 0)
-        return hr;
+    if (header.Version != SPAWN_CONTROLS_VERSION || header.Count < 0)
+        return E_UNEXPECTED;
 
     /**
-     *  Read each of the controls as a binary blob.
+     *  Read the spawn control arrays in one block.
      */
-    for (int index = 0; index < SpawnCount; ++index)
+    if (header.Count > 0)
     {
-        const auto control = new SpawnControl;
-        hr = pStm->Read(control, sizeof(SpawnControl), nullptr);
+        std::vector<unsigned char> block(header.Count * SPAWN_CONTROL_SIZE);
+        hr = pStm->Read(block.data(), (ULONG)block.size(), nullptr);
         if (FAILED(hr))
             return hr;
-        SpawnControls.Add(control);
+
+        Spawnees.Resize(header.Count);
+        SpawnStatuses.Resize(header.Count);
+        ReloadTimers.Resize(header.Count);
+
+        const unsigned char* spawnees_ptr = block.data();
+        const unsigned char* statuses_ptr = spawnees_ptr + header.Count * sizeof(AircraftClass*);
+        const unsigned char* timers_ptr = statuses_ptr + header.Count * sizeof(SpawnControlStatus);
+
+        for (int i = 0; i < header.Count; i++)
+        {
+            AircraftClass* spawnee;
+            SpawnControlStatus status;
+            CDTimerClass<FrameTimerClass> timer;
+
+            std::memcpy(&spawnee, spawnees_ptr + i * sizeof(AircraftClass*), sizeof(AircraftClass*));
+            std::memcpy(&status, statuses_ptr + i * sizeof(SpawnControlStatus), sizeof(SpawnControlStatus));
+            std::memcpy(&timer, timers_ptr + i * sizeof(CDTimerClass<FrameTimerClass>), sizeof(CDTimerClass<FrameTimerClass>));
+
+            Spawnees.Add(spawnee);
+            SpawnStatuses.Add(status);
+            ReloadTimers.Add(timer);
+        }
     }
 
-    for (int i = 0; i < SpawnCount; i++)
-        VINIFERA_SWIZZLE_REQUEST_POINTER_REMAP(SpawnControls[i]->Spawnee, "Spawnee");
+    for (int i = 0; i < header.Count; i++)
+        VINIFERA_SWIZZLE_REQUEST_POINTER_REMAP(Spawnees[i], "Spawnee");
 
     VINIFERA_SWIZZLE_REQUEST_POINTER_REMAP(Owner, "Owner");
     VINIFERA_SWIZZLE_REQUEST_POINTER_REMAP(SpawnType, "SpawnType");
@@ -124,25 +173,37 @@ IFACEMETHODIMP SpawnManagerClass::Save(IStream* pStm, BOOL fClearDirty)
         return hr;
 
     /**
-     *  Write the count of active spawn controls.
+     *  Write the spawn control block header.
      */
-    hr = pStm->Write(&SpawnCount, sizeof(SpawnCount), nullptr);
+    SpawnControlsHeaderStruct header;
+    header.Version = SPAWN_CONTROLS_VERSION;
+    header.Count = Spawnees.Count();
+
+    hr = pStm->Write(&header, sizeof(header), nullptr);
     if (FAILED(hr))
         return hr;
 
-    if (SpawnCount <= 0)
+    if (header.Count <= 0)
         return hr;
 
     /**
-     *  Write each of the controls as a binary blob.
+     *  Write the spawn control arrays in one block.
      */
-    for (int index = 0; index < SpawnCount; ++index)
+    std::vector<unsigned char> block(header.Count * SPAWN_CONTROL_SIZE);
+
+    unsigned char* spawnees_ptr = block.data();
+    unsigned char* statuses_ptr = spawnees_ptr + header.Count * sizeof(AircraftClass*);
+    unsigned char* timers_ptr = statuses_ptr + header.Count * sizeof(SpawnControlStatus);
+
+    for (int i = 0; i < header.Count; i++)
     {
-        hr = pStm->Write(SpawnControls[index], sizeof(SpawnControl), nullptr);
-        if (FAILED(hr))
-            return hr;
+        std::memcpy(spawnees_ptr + i * sizeof(AircraftClass*), &Spawnees[i], sizeof(AircraftClass*));
+        std::memcpy(statuses_ptr + i * sizeof(SpawnControlStatus), &SpawnStatuses[i], sizeof(SpawnControlStatus));
+        std::memcpy(timers_ptr + i * sizeof(CDTimerClass<FrameTimerClass>), &ReloadTimers[i], sizeof(CDTimerClass<FrameTimerClass>));
     }
 
+    hr = pStm->Write(block.data(), (ULONG)block.size(), nullptr);
+
     return hr;
 }
 
@@ -158,7 +219,11 @@ SpawnManagerClass::SpawnManagerClass() :
     SpawnCount(0),
     Target(nullptr),
     QueuedTarget(nullptr),
-    Status(SpawnManagerStatus::Idle)
+    Status(SpawnManagerStatus::Idle),
+    OwnerExt(nullptr),
+    OwnerTypeExt(nullptr),
+    SpawnTypeExt(nullptr),
+    SpawnRocket(nullptr)
 {
     SpawnManagers.Add(this);
 }
@@ -179,25 +244,33 @@ SpawnManagerClass::SpawnManagerClass(TechnoClass* owner, const AircraftTypeClass
     LogicRate(logic_rate),
     Target(nullptr),
     QueuedTarget(nullptr),
-    Status(SpawnManagerStatus::Idle)
+    Status(SpawnManagerStatus::Idle),
+    OwnerExt(nullptr),
+    OwnerTypeExt(nullptr),
+    SpawnTypeExt(nullptr),
+    SpawnRocket(nullptr)
 {
+    Resolve_Extensions();
+
+    Spawnees.Resize(SpawnCount);
+    SpawnStatuses.Resize(SpawnCount);
+    ReloadTimers.Resize(SpawnCount);
+
     for (int i = 0; i < SpawnCount; i++)
     {
-        auto control = new SpawnControl();
-        if (control == nullptr)
-            break;
-
         auto spawnee = static_cast<AircraftClass*>(SpawnType->Create_One_Of(owner->Owning_House()));
-        control->Spawnee = spawnee;
 
         if (spawnee != nullptr)
         {
-            control->IsSpawnedMissile = RocketTypeClass::From_AircraftType(SpawnType) != nullptr;
-            control->Spawnee->Limbo();
-            Extension::Fetch<AircraftClassExtension>(control->Spawnee)->SpawnOwner = Owner;
-            control->Status = SpawnControlStatus::Idle;
-            control->ReloadTimer = 0;
-            SpawnControls.Add(control);
+            spawnee->Limbo();
+            Extension::Fetch<AircraftClassExtension>(spawnee)->SpawnOwner = Owner;
+
+            CDTimerClass<FrameTimerClass> reload_timer;
+            reload_timer = 0;
+
+            Spawnees.Add(spawnee);
+            SpawnStatuses.Add(SpawnControlStatus::Idle);
+            ReloadTimers.Add(reload_timer);
         }
     }
 
@@ -215,13 +288,32 @@ SpawnManagerClass::~SpawnManagerClass()
     if (GameActive)
         Detach_Spawns();
 
-    for (int i = SpawnControls.Count() - 1; i >= 0; i--)
+    SpawnManagers.Delete(this);
+}
+
+
+/**
+ *  Fetches the extensions of the owner and the spawn type, and the rocket
+ *  type of the spawns, if they have not been fetched yet.
+ *
+ *  @author: agent
+ */
+void SpawnManagerClass::Resolve_Extensions()
+{
+    if (SpawnTypeExt != nullptr)
+        return;
+
+    if (Owner != nullptr)
     {
-        if (SpawnControls[i] != nullptr)
-            delete SpawnControls[i];
+        OwnerExt = Extension::Fetch<TechnoClassExtension>(Owner);
+        OwnerTypeExt = Extension::Fetch<TechnoTypeClassExtension>(Owner->Techno_Type_Class());
     }
 
-    SpawnManagers.Delete(this);
+    if (SpawnType != nullptr)
+    {
+        SpawnTypeExt = Extension::Fetch<AircraftTypeClassExtension>(SpawnType);
+        SpawnRocket = RocketTypeClass::From_AircraftType(SpawnType);
+    }
 }
 
 
@@ -266,7 +358,7 @@ void SpawnManagerClass::Compute_CRC(WWCRCEngine& crc) const
 
     crc(SpawnTimer.Value());
     crc(LogicTimer.Value());
-    crc(SpawnControls.Count());
+    crc(Spawnees.Count());
     crc(SpawnCount);
 
     if (SpawnType != nullptr)
@@ -292,17 +384,16 @@ void SpawnManagerClass::AI()
 
     LogicTimer = LogicRate;
 
+    Resolve_Extensions();
+
     /**
      *  Iterate all the controls.
      */
-    for (int i = 0; i < SpawnControls.Count(); i++)
+    for (int i = 0; i < Spawnees.Count(); i++)
     {
-        SpawnControl* control = SpawnControls[i];
-        AircraftClass* spawnee = control->Spawnee;
-        const auto owner_ext = Extension::Fetch<TechnoClassExtension>(Owner);
-        const auto owner_type_ext = Extension::Fetch<TechnoTypeClassExtension>(Owner->Techno_Type_Class());
+        AircraftClass* spawnee = Spawnees[i];
 
-        switch (control->Status)
+        switch (SpawnStatuses[i])
         {
             /**
              *  The spawn is currently idle.
@@ -336,7 +427,7 @@ void SpawnManagerClass::AI()
                 /**
                  *  If the spawner can move (i. e. is not a building), don't allow spawning while it's on the move.
                  */
-                if (control->IsSpawnedMissile && Owner->Is_Foot())
+                if (Is_Spawned_Missile() && Owner->Is_Foot())
                 {
                     if (static_cast<FootClass*>(Owner)->Locomotion->Is_Moving() || static_cast<FootClass*>(Owner)->Locomotion->Is_Moving_Now())
                         continue;
@@ -352,7 +443,7 @@ void SpawnManagerClass::AI()
                  *  We can spawn 2 missiles using the burst logic.
                  */
                 const auto weapon = Owner->Get_Weapon(WEAPON_SLOT_PRIMARY)->Weapon;
-                if (control->IsSpawnedMissile && weapon->Burst > 1 && i < weapon->Burst)
+                if (Is_Spawned_Missile() && weapon->Burst > 1 && i < weapon->Burst)
                     Owner->CurrentBurstIndex = i;
                 else
                     Owner->CurrentBurstIndex = 0;
@@ -360,7 +451,7 @@ void SpawnManagerClass::AI()
                 /**
                  *  Update our status.
                  */
-                control->Status = SpawnControlStatus::Preparing;
+                SpawnStatuses[i] = SpawnControlStatus::Preparing;
 
                 WeaponSlotType weapon_slot = Extension::Fetch<WeaponTypeClassExtension>(Owner->Get_Weapon(WEAPON_SLOT_PRIMARY)->Weapon)->IsSpawner ? WEAPON_SLOT_PRIMARY : WEAPON_SLOT_SECONDARY;
 
@@ -369,17 +460,17 @@ void SpawnManagerClass::AI()
                  */
                 Coordinate fire_coord;
                 if (Owner->CurrentBurstIndex % 2 == 0)
-                    fire_coord = owner_ext->Fire_Coord(weapon_slot);
+                    fire_coord = OwnerExt->Fire_Coord(weapon_slot);
                 else
-                    fire_coord = owner_ext->Fire_Coord(weapon_slot, owner_type_ext->SecondSpawnOffset);
+                    fire_coord = OwnerExt->Fire_Coord(weapon_slot, OwnerTypeExt->SecondSpawnOffset);
 
                 Coordinate spawn_coord = Coordinate(fire_coord.X, fire_coord.Y, fire_coord.Z + 10);
 
                 /**
                  *  Randomize the horizontal position a bit if requested.
                  */
-                if (owner_type_ext->MaxRandomSpawnOffset > 0)
-                    spawn_coord += Coordinate(Random_Pick(0, owner_type_ext->MaxRandomSpawnOffset), Random_Pick(0, owner_type_ext->MaxRandomSpawnOffset), 0);
+                if (OwnerTypeExt->MaxRandomSpawnOffset > 0)
+                    spawn_coord += Coordinate(Random_Pick(0, OwnerTypeExt->MaxRandomSpawnOffset), Random_Pick(0, OwnerTypeExt->MaxRandomSpawnOffset), 0);
 
                 /**
                  *  Place the spawn in the world.
@@ -387,7 +478,7 @@ void SpawnManagerClass::AI()
                 DirStruct dir = Owner->PrimaryFacing.Current();
                 spawnee->Unlimbo(spawn_coord, dir.Get_Dir());
 
-                const auto rocket = RocketTypeClass::From_AircraftType(SpawnType);
+                const auto rocket = SpawnRocket;
 
                 /**
                  *  Cruise missiles spawn their takeoff animation.
@@ -398,13 +489,13 @@ void SpawnManagerClass::AI()
                 /**
                  *  Reset burst since if we're done with this volley.
                  */
-                if (i == SpawnControls.Count() - 1)
+                if (i == Spawnees.Count() - 1)
                     Owner->CurrentBurstIndex = 0;
 
                 /**
                  *  Missiles only take a destination once, so they go straight to the target.
                  */
-                if (control->IsSpawnedMissile)
+                if (Is_Spawned_Missile())
                 {
                     Next_Target();
                     spawnee->Assign_Destination(Target);
@@ -429,7 +520,7 @@ void SpawnManagerClass::AI()
              */
         case SpawnControlStatus::Takeoff:
             {
-                if (control->ReloadTimer.Expired())
+                if (ReloadTimers[i].Expired())
                     Detach(spawnee);
                 break;
             }
@@ -442,7 +533,7 @@ void SpawnManagerClass::AI()
                 /**
                  *  Missiles don't do this.
                  */
-                if (control->IsSpawnedMissile)
+                if (Is_Spawned_Missile())
                     break;
 
                 /**
@@ -455,7 +546,7 @@ void SpawnManagerClass::AI()
                     spawnee->Assign_Target(nullptr);
                     spawnee->Assign_Mission(MISSION_MOVE);
                     spawnee->Commence();
-                    control->Status = SpawnControlStatus::Returning;
+                    SpawnStatuses[i] = SpawnControlStatus::Returning;
                 }
                 /**
                  *  Send the aircraft to attack.
@@ -491,7 +582,7 @@ void SpawnManagerClass::AI()
                     spawnee->Assign_Destination(Owner);
                     spawnee->Assign_Target(nullptr);
                     spawnee->Assign_Mission(MISSION_MOVE);
-                    control->Status = SpawnControlStatus::Returning;
+                    SpawnStatuses[i] = SpawnControlStatus::Returning;
                 }
                 break;
             }
@@ -508,7 +599,7 @@ void SpawnManagerClass::AI()
                 Next_Target();
                 if (spawnee->Ammo > 0 && Target)
                 {
-                    control->Status = SpawnControlStatus::Attacking;
+                    SpawnStatuses[i] = SpawnControlStatus::Attacking;
                     spawnee->Assign_Target(Target);
                     spawnee->Assign_Mission(MISSION_ATTACK);
                     break;
@@ -524,8 +615,8 @@ void SpawnManagerClass::AI()
                 if (owner_coord == spawnee_coord && std::abs(spawnee->Coord.Z - Owner->Coord.Z) < 20)
                 {
                     spawnee->Limbo();
-                    control->Status = SpawnControlStatus::Reloading;
-                    control->ReloadTimer = ReloadRate;
+                    SpawnStatuses[i] = SpawnControlStatus::Reloading;
+                    ReloadTimers[i] = ReloadRate;
                 }
                 else
                 {
@@ -545,13 +636,13 @@ void SpawnManagerClass::AI()
                 /**
                  *  Wait until the reload timer expires.
                  */
-                if (!control->ReloadTimer.Expired())
+                if (!ReloadTimers[i].Expired())
                     break;
 
                 /**
                  *  Then reset the spawn to max ammo and health.
                  */
-                control->Status = SpawnControlStatus::Idle;
+                SpawnStatuses[i] = SpawnControlStatus::Idle;
                 spawnee->Ammo = spawnee->Class->MaxAmmo;
                 spawnee->Strength = spawnee->Class->MaxStrength;
                 break;
@@ -565,17 +656,16 @@ void SpawnManagerClass::AI()
                 /**
                  *  Wait until the reload timer expires.
                  */
-                if (!control->ReloadTimer.Expired())
+                if (!ReloadTimers[i].Expired())
                     break;
 
                 /**
                  *  Create a new spawn and set it to idle.
                  */
-                control->Spawnee = static_cast<AircraftClass*>(SpawnType->Create_One_Of(Owner->Owning_House()));
-                control->IsSpawnedMissile = RocketTypeClass::From_AircraftType(SpawnType) != nullptr;
-                control->Spawnee->Limbo();
-                Extension::Fetch<AircraftClassExtension>(control->Spawnee)->SpawnOwner = Owner;
-                control->Status = SpawnControlStatus::Idle;
+                Spawnees[i] = static_cast<AircraftClass*>(SpawnType->Create_One_Of(Owner->Owning_House()));
+                Spawnees[i]->Limbo();
+                Extension::Fetch<AircraftClassExtension>(Spawnees[i])->SpawnOwner = Owner;
+                SpawnStatuses[i] = SpawnControlStatus::Idle;
                 break;
             }
         }
@@ -612,10 +702,9 @@ void SpawnManagerClass::AI()
          *  Check to make sure all of our spawns are currently preparing to launch.
          *  This should only happen when the spawns are missiles, I believe.
          */
-        for (int i = 0; i < SpawnControls.Count(); i++)
+        for (int i = 0; i < Spawnees.Count(); i++)
         {
-            const SpawnControl* control = SpawnControls[i];
-            if (control->Status != SpawnControlStatus::Preparing && control->Status != SpawnControlStatus::Dead)
+            if (SpawnStatuses[i] != SpawnControlStatus::Preparing && SpawnStatuses[i] != SpawnControlStatus::Dead)
                 return;
         }
 
@@ -623,32 +712,29 @@ void SpawnManagerClass::AI()
          *  Process all our missiles.
          */
         bool is_missile_launcher = false;
-        for (int i = 0; i < SpawnControls.Count(); i++)
+        for (int i = 0; i < Spawnees.Count(); i++)
         {
-            SpawnControl* control = SpawnControls[i];
-            AircraftClass* spawnee = control->Spawnee;
+            AircraftClass* spawnee = Spawnees[i];
 
             /**
              *  Don't process dead spawns.
              */
-            if (control->Status == SpawnControlStatus::Preparing)
+            if (SpawnStatuses[i] == SpawnControlStatus::Preparing)
             {
                 /**
                  *  If the spawn is a missile, add it to the kamikaze tracker and set it to take off.
                  *  Also set the reload timer to the missile's takeoff time.
                  */
-                if (Extension::Fetch<AircraftTypeClassExtension>(spawnee->Techno_Type_Class())->IsMissileSpawn)
+                if (SpawnTypeExt->IsMissileSpawn)
                 {
                     is_missile_launcher = true;
                     KamikazeTracker->Add(spawnee, Target);
                     KamikazeTracker->UpdateTimer = 2;
 
-                    if (control->IsSpawnedMissile)
+                    if (Is_Spawned_Missile())
                     {
-                        control->Status = SpawnControlStatus::Takeoff;
-                        const auto atype = control->Spawnee->Class;
-                        const RocketTypeClass* rocket = RocketTypeClass::From_AircraftType(atype);
-                        control->ReloadTimer = rocket->PauseFrames + rocket->TiltFrames;
+                        SpawnStatuses[i] = SpawnControlStatus::Takeoff;
+                        ReloadTimers[i] = SpawnRocket->PauseFrames + SpawnRocket->TiltFrames;
                     }
                     else
                     {
@@ -660,7 +746,7 @@ void SpawnManagerClass::AI()
                  */
                 else
                 {
-                    control->Status = SpawnControlStatus::Attacking;
+                    SpawnStatuses[i] = SpawnControlStatus::Attacking;
                     spawnee->Assign_Target(Target);
                     spawnee->Assign_Mission(MISSION_ATTACK);
                 }
@@ -686,10 +772,9 @@ void SpawnManagerClass::AI()
     else if (Status == SpawnManagerStatus::Cooldown)
     {
         bool is_idle = true;
-        for (int i = 0; i < SpawnControls.Count(); i++)
+        for (int i = 0; i < Spawnees.Count(); i++)
         {
-            SpawnControl* control = SpawnControls[i];
-            if (control->Status == SpawnControlStatus::Attacking || control->Status == SpawnControlStatus::Returning)
+            if (SpawnStatuses[i] == SpawnControlStatus::Attacking || SpawnStatuses[i] == SpawnControlStatus::Returning)
             {
                 is_idle = false;
                 break;
@@ -714,49 +799,48 @@ void SpawnManagerClass::Detach_Spawns()
     /**
      *  Iterate all the spawns.
      */
-    for (int i = 0; i < SpawnControls.Count(); i++)
+    for (int i = 0; i < Spawnees.Count(); i++)
     {
         /**
          *  Don't need to do anything about dead spawns.
          */
-        SpawnControl* control = SpawnControls[i];
-        if (control->Status == SpawnControlStatus::Dead)
+        if (SpawnStatuses[i] == SpawnControlStatus::Dead)
             continue;
 
         /**
          *  If it's currently docked, just kill it off. It's already limboed.
          */
-        if (control->Status == SpawnControlStatus::Idle || control->Status == SpawnControlStatus::Reloading)
+        if (SpawnStatuses[i] == SpawnControlStatus::Idle || SpawnStatuses[i] == SpawnControlStatus::Reloading)
         {
-            control->Status = SpawnControlStatus::Dead;
-            control->Spawnee->Remove_This();
+            SpawnStatuses[i] = SpawnControlStatus::Dead;
+            Spawnees[i]->Remove_This();
         }
         else
         {
             /**
              *  If it's a rocket taking off, detach it and remove it from the world.
              */
-            if (control->Status == SpawnControlStatus::Takeoff)
+            if (SpawnStatuses[i] == SpawnControlStatus::Takeoff)
             {
-                KamikazeTracker->Detach(control->Spawnee);
-                control->Status = SpawnControlStatus::Dead;
-                control->Spawnee->Remove_This();
+                KamikazeTracker->Detach(Spawnees[i]);
+                SpawnStatuses[i] = SpawnControlStatus::Dead;
+                Spawnees[i]->Remove_This();
             }
             /**
              *  Otherwise it's probably currently in flight, so just detach it.
              */
             else
             {
-                control->Status = SpawnControlStatus::Dead;
-                KamikazeTracker->Add(control->Spawnee, Target);
+                SpawnStatuses[i] = SpawnControlStatus::Dead;
+                KamikazeTracker->Add(Spawnees[i], Target);
             }
         }
 
         /**
          *  Set the spawn to regenerate.
          */
-        control->Spawnee = nullptr;
-        control->ReloadTimer = regen_rate;
+        Spawnees[i] = nullptr;
+        ReloadTimers[i] = regen_rate;
     }
 }
 
@@ -780,20 +864,20 @@ void SpawnManagerClass::Queue_Target(TARGET target)
  */
 void SpawnManagerClass::Abandon_Target()
 {
+    Resolve_Extensions();
+
     /**
      *  Loop all the spawns. If any of them are currently preparing to attack, drop them.
      */
-    for (int i = 0; i < SpawnControls.Count(); ++i)
+    for (int i = 0; i < Spawnees.Count(); ++i)
     {
-        SpawnControl* control = SpawnControls[i];
-        if (control->Status == SpawnControlStatus::Preparing)
+        if (SpawnStatuses[i] == SpawnControlStatus::Preparing)
         {
-            const auto extension = Extension::Fetch<AircraftTypeClassExtension>(control->Spawnee->Techno_Type_Class());
-            if (extension->IsMissileSpawn)
+            if (SpawnTypeExt->IsMissileSpawn)
             {
-                KamikazeTracker->Add(control->Spawnee, Target);
+                KamikazeTracker->Add(Spawnees[i], Target);
                 KamikazeTracker->UpdateTimer = 2;
-                Detach(control->Spawnee);
+                Detach(Spawnees[i]);
             }
         }
     }
@@ -830,6 +914,8 @@ bool SpawnManagerClass::Next_Target()
  */
 void SpawnManagerClass::Detach(TARGET target)
 {
+    Resolve_Extensions();
+
     /**
      *  If it's the suspended target, remove it.
      *  If we don't have any more targets, stop attacking.
@@ -853,16 +939,15 @@ void SpawnManagerClass::Detach(TARGET target)
         /**
          *  Check if it's one of the spawns. If so, remove it.
          */
-        for (int i = 0; i < SpawnControls.Count(); i++)
+        for (int i = 0; i < Spawnees.Count(); i++)
         {
-            const auto control = SpawnControls[i];
-            if (control->Spawnee == target)
+            if (Spawnees[i] == target)
             {
-                if (control->Spawnee->Strength <= 0 || control->Spawnee->IsKamikaze || control->IsSpawnedMissile)
+                if (Spawnees[i]->Strength <= 0 || Spawnees[i]->IsKamikaze || Is_Spawned_Missile())
                 {
-                    control->Spawnee = nullptr;
-                    control->Status = SpawnControlStatus::Dead;
-                    control->ReloadTimer = RegenRate;
+                    Spawnees[i] = nullptr;
+                    SpawnStatuses[i] = SpawnControlStatus::Dead;
+                    ReloadTimers[i] = RegenRate;
                 }
 
                 break;
@@ -889,9 +974,9 @@ void SpawnManagerClass::Detach(TARGET target)
 int SpawnManagerClass::Active_Count()
 {
     int count = 0;
-    for (int i = 0; i < SpawnControls.Count(); i++)
+    for (int i = 0; i < Spawnees.Count(); i++)
     {
-        if (SpawnControls[i]->Status != SpawnControlStatus::Dead)
+        if (SpawnStatuses[i] != SpawnControlStatus::Dead)
             count++;
     }
     return count;
@@ -906,10 +991,10 @@ int SpawnManagerClass::Active_Count()
 int SpawnManagerClass::Docked_Count()
 {
     int count = 0;
-    for (int i = 0; i < SpawnControls.Count(); i++)
+    for (int i = 0; i < Spawnees.Count(); i++)
     {
-        if (SpawnControls[i]->Status == SpawnControlStatus::Reloading ||
-            SpawnControls[i]->Status == SpawnControlStatus::Idle)
+        if (SpawnStatuses[i] == SpawnControlStatus::Reloading ||
+            SpawnStatuses[i] == SpawnControlStatus::Idle)
             count++;
     }
     return count;
@@ -923,17 +1008,19 @@ int SpawnManagerClass::Docked_Count()
  */
 int SpawnManagerClass::Preparing_Count()
 {
+    Resolve_Extensions();
+
     int count = 0;
-    for (int i = 0; i < SpawnControls.Count(); i++)
+    for (int i = 0; i < Spawnees.Count(); i++)
     {
-        if (SpawnControls[i]->Status == SpawnControlStatus::Takeoff)
+        if (SpawnStatuses[i] == SpawnControlStatus::Takeoff)
             count++;
 
-        if (SpawnControls[i]->Status == SpawnControlStatus::Preparing)
+        if (SpawnStatuses[i] == SpawnControlStatus::Preparing)
         {
-            const AircraftClass* spawnee = SpawnControls[i]->Spawnee;
+            const AircraftClass* spawnee = Spawnees[i];
             if (spawnee && !spawnee->IsInLimbo
-                && Extension::Fetch<AircraftTypeClassExtension>(spawnee->Techno_Type_Class())->IsMissileSpawn)
+                && SpawnTypeExt->IsMissileSpawn)
             {
                 count++;
             }
@@ -36,6 +36,10 @@ class AircraftTypeClass;
 class TechnoClass;
 class FrameTimerClass;
 class AircraftClass;
+class TechnoClassExtension;
+class TechnoTypeClassExtension;
+class AircraftTypeClassExtension;
+class RocketTypeClass;
 
 enum class SpawnManagerStatus {
     Idle = 0,		// no target or out of range
@@ -59,14 +63,6 @@ class DECLSPEC_UUID(UUID_SPAWN_MANAGER)
     SpawnManagerClass : public AbstractClass
 {
 public:
-    struct SpawnControl
-    {
-        AircraftClass* Spawnee;
-        SpawnControlStatus Status;
-        CDTimerClass<FrameTimerClass> ReloadTimer;
-        bool IsSpawnedMissile;
-    };
-
     /**
     *  IPersist
     */
@@ -81,7 +77,7 @@ public:
 public:
     SpawnManagerClass();
     SpawnManagerClass(TechnoClass* owner, const AircraftTypeClass* spawns, int spawn_count, int regen_rate, int reload_rate, int spawn_rate, int logic_rate);
-    SpawnManagerClass(const NoInitClass& noinit) : SpawnControls(noinit), LogicTimer(noinit), SpawnTimer(noinit) {}
+    SpawnManagerClass(const NoInitClass& noinit) : Spawnees(noinit), SpawnStatuses(noinit), ReloadTimers(noinit), LogicTimer(noinit), SpawnTimer(noinit), OwnerExt(nullptr), OwnerTypeExt(nullptr), SpawnTypeExt(nullptr), SpawnRocket(nullptr) {}
     virtual ~SpawnManagerClass() override;
 
     /**
@@ -104,6 +100,10 @@ public:
     SpawnManagerClass(const SpawnManagerClass&) = delete;
     SpawnManagerClass& operator= (const SpawnManagerClass&) = delete;
 
+private:
+    void Resolve_Extensions();
+    bool Is_Spawned_Missile() const { return SpawnRocket != nullptr; }
+
 public:
     /**
      *  The Techno that owns this spawn manager.
@@ -141,9 +141,12 @@ public:
     int LogicRate;
 
     /**
-     *  This vector holds the spawn manager.
+     *  The state of each spawn, stored as parallel arrays indexed by the
+     *  spawn number so the AI loop walks contiguous memory.
      */
-    DynamicVectorClass<SpawnControl*> SpawnControls;
+    DynamicVectorClass<AircraftClass*> Spawnees;
+    DynamicVectorClass<SpawnControlStatus> SpawnStatuses;
+    DynamicVectorClass<CDTimerClass<FrameTimerClass>> ReloadTimers;
 
     /**
      *  The timer that controls how often the spawn manager should execute its AI function.
@@ -169,4 +172,15 @@ public:
      *  The current status of the spawn manager.
      */
     SpawnManagerStatus Status;
+
+private:
+    /**
+     *  The extensions of the owner and the spawn type, and the rocket type of
+     *  the spawns. These are resolved once instead of on every spawn update,
+     *  and again after a load as the extensions are recreated.
+     */
+    TechnoClassExtension* OwnerExt;
+    TechnoTypeClassExtension* OwnerTypeExt;
+    AircraftTypeClassExtension* SpawnTypeExt;
+    const RocketTypeClass* SpawnRocket;
 };
\ No newline at end of file
@@ -0,0 +1,116 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          DAMAGEFALLOFF.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Division by reciprocal for the damage falloff.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "damagefalloff.h"
+#include "asserthandler.h"
+#include <algorithm>
+
+
+/**
+ *  The reciprocals for the damage falloff steps, entry 0 is unused as the
+ *  damage is not divided at step 0.
+ */
+static const struct DamageFalloffTableStruct
+{
+    DamageFalloffTableStruct()
+    {
+        Steps[0].Reciprocal = 1;
+        Steps[0].Shift = 0;
+
+        for (int step = 1; step <= DAMAGE_FALLOFF_STEPS; ++step) {
+            Steps[step] = Make_Reciprocal(step);
+        }
+    }
+
+    DamageReciprocalStruct Steps[DAMAGE_FALLOFF_STEPS+1];
+} DamageFalloffTable;
+
+
+/**
+ *  Calculates the reciprocal and shift that divide any value in the range
+ *  [0, 2^31) by the divisor exactly, using (value * reciprocal) >> shift.
+ * 
+ *  With l = ceil(log2(divisor)) and a shift of 31+l, the reciprocal is
+ *  rounded up so its error is less than 2^l, which keeps the product within
+ *  one unit of the true quotient for all 31 bit values (Granlund-Montgomery).
+ *
+ *  @author: agent
+ */
+DamageReciprocalStruct Make_Reciprocal(int divisor)
+{
+    ASSERT(divisor > 0);
+
+    int log2 = 0;
+    while ((1ULL << log2) < (uint64_t)divisor) {
+        ++log2;
+    }
+
+    DamageReciprocalStruct result;
+    result.Shift = 31 + log2;
+    result.Reciprocal = ((1ULL << result.Shift) + divisor - 1) / divisor;
+
+    return result;
+}
+
+
+/**
+ *  Fetches the falloff step for the distance from the impact point, this is
+ *  the distance divided by the divisor, clamped to [0, 16]. The reciprocal
+ *  must have been made from the divisor.
+ *
+ *  @author: agent
+ */
+int Damage_Falloff_Step(int distance, int divisor, const DamageReciprocalStruct &reciprocal)
+{
+    if (distance <= 0 || divisor <= 0) {
+        return std::clamp(distance / divisor, 0, DAMAGE_FALLOFF_STEPS);
+    }
+
+    uint64_t step = ((uint64_t)distance * reciprocal.Reciprocal) >> reciprocal.Shift;
+    return (int)std::min(step, (uint64_t)DAMAGE_FALLOFF_STEPS);
+}
+
+
+/**
+ *  Divides the damage by the falloff step.
+ *
+ *  @author: agent
+ */
+int Damage_Falloff(int damage, int step)
+{
+    ASSERT(step > 0 && step <= DAMAGE_FALLOFF_STEPS);
+
+    /**
+     *  The reciprocal is only exact for non-negative values.
+     */
+    if (damage < 0) {
+        return damage / step;
+    }
+
+    const DamageReciprocalStruct &reciprocal = DamageFalloffTable.Steps[step];
+    return (int)(((uint64_t)damage * reciprocal.Reciprocal) >> reciprocal.Shift);
+}
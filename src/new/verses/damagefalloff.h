@@ -0,0 +1,51 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          DAMAGEFALLOFF.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Division by reciprocal for the damage falloff.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+
+
+/**
+ *  The largest falloff step, damage is divided by at most this amount.
+ */
+#define DAMAGE_FALLOFF_STEPS 16
+
+
+/**
+ *  Reciprocal of a divisor, see Make_Reciprocal.
+ */
+struct DamageReciprocalStruct
+{
+    uint64_t Reciprocal;
+    int Shift;
+};
+
+
+DamageReciprocalStruct Make_Reciprocal(int divisor);
+int Damage_Falloff_Step(int distance, int divisor, const DamageReciprocalStruct &reciprocal);
+int Damage_Falloff(int damage, int step);
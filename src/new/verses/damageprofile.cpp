@@ -0,0 +1,140 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          DAMAGEPROFILE.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Precomputed per-warhead damage modifier profiles.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "damageprofile.h"
+#include "damagefalloff.h"
+#include "verses.h"
+#include "armortype.h"
+#include "warheadtype.h"
+#include "warheadtypeext.h"
+#include "extension.h"
+#include "tibsun_globals.h"
+#include "vinifera_globals.h"
+#include "asserthandler.h"
+
+
+/**
+ *  The profiles, indexed by the warhead heap id, and the Verses revision
+ *  they were built from.
+ */
+static std::vector<WarheadDamageProfileStruct> DamageProfiles;
+static std::vector<bool> DamageProfileValid;
+static unsigned DamageProfileRevision = 0;
+
+
+/**
+ *  Resolves the damage profile of a warhead.
+ *
+ *  @author: agent
+ */
+static void Build_Profile(WarheadTypeClass *warhead, WarheadDamageProfileStruct &profile)
+{
+    const WarheadType warheadtype = static_cast<WarheadType>(warhead->Get_Heap_ID());
+
+    profile.MinDamage = Extension::Fetch<WarheadTypeClassExtension>(warhead)->MinDamage;
+    profile.SpreadFactor = warhead->SpreadFactor;
+
+    if (!warhead->SpreadFactor) {
+        profile.DistanceDivisor = PIXEL_LEPTON_W / 2;
+    } else {
+        profile.DistanceDivisor = warhead->SpreadFactor * (PIXEL_LEPTON_W / 2 + 1);
+    }
+
+    if (profile.DistanceDivisor > 0) {
+        DamageReciprocalStruct reciprocal = Make_Reciprocal(profile.DistanceDivisor);
+        profile.DistanceReciprocal = reciprocal.Reciprocal;
+        profile.DistanceShift = reciprocal.Shift;
+    } else {
+        profile.DistanceReciprocal = 0;
+        profile.DistanceShift = 0;
+    }
+
+    profile.Modifiers.resize(ArmorTypes.Count());
+    for (int armor = ARMOR_FIRST; armor < ArmorTypes.Count(); ++armor) {
+        profile.Modifiers[armor] = Verses::Get_Modifier(static_cast<ArmorType>(armor), warheadtype);
+    }
+}
+
+
+/**
+ *  Fetches the damage profile of a warhead, (re)building it if the Verses
+ *  data or the warhead has changed since it was built.
+ *
+ *  @author: agent
+ */
+const WarheadDamageProfileStruct &Warhead_Damage_Profile(WarheadTypeClass *warhead)
+{
+    ASSERT(warhead != nullptr);
+
+    /**
+     *  Any change to the Verses, armor or warhead data invalidates all profiles.
+     */
+    if (DamageProfileRevision != Verses::Get_Revision() || DamageProfiles.size() != (size_t)WarheadTypes.Count()) {
+        DamageProfiles.resize(WarheadTypes.Count());
+        DamageProfileValid.assign(WarheadTypes.Count(), false);
+        DamageProfileRevision = Verses::Get_Revision();
+    }
+
+    const int index = warhead->Get_Heap_ID();
+    ASSERT(index >= 0 && index < (int)DamageProfiles.size());
+
+    WarheadDamageProfileStruct &profile = DamageProfiles[index];
+
+    if (!DamageProfileValid[index] || profile.SpreadFactor != warhead->SpreadFactor) {
+        Build_Profile(warhead, profile);
+        DamageProfileValid[index] = true;
+    }
+
+    return profile;
+}
+
+
+/**
+ *  Fetches the falloff step for the distance from the impact point,
+ *  this is the distance divided by the warhead spread, clamped to [0, 16].
+ *
+ *  @author: agent
+ */
+int Warhead_Damage_Falloff_Step(const WarheadDamageProfileStruct &profile, int distance)
+{
+    DamageReciprocalStruct reciprocal;
+    reciprocal.Reciprocal = profile.DistanceReciprocal;
+    reciprocal.Shift = profile.DistanceShift;
+
+    return Damage_Falloff_Step(distance, profile.DistanceDivisor, reciprocal);
+}
+
+
+/**
+ *  Divides the damage by the falloff step.
+ *
+ *  @author: agent
+ */
+int Warhead_Damage_Falloff(int damage, int step)
+{
+    return Damage_Falloff(damage, step);
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          DAMAGEPROFILE.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Precomputed per-warhead damage modifier profiles.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+#include "tibsun_defines.h"
+#include <vector>
+
+
+class WarheadTypeClass;
+
+
+/**
+ *  The damage modifiers of a warhead, resolved from the Verses tables and
+ *  the warhead data so the per-target damage calculation does not need to
+ *  look them up again.
+ */
+struct WarheadDamageProfileStruct
+{
+    /**
+     *  The warhead specific minimum damage, or -1 to use the rules default.
+     */
+    int MinDamage;
+
+    /**
+     *  The spread factor the distance divisor was calculated for.
+     */
+    int SpreadFactor;
+
+    /**
+     *  The distance is divided by this to get the falloff step, the division
+     *  is performed as a multiply by the reciprocal and a shift.
+     */
+    int DistanceDivisor;
+    uint64_t DistanceReciprocal;
+    int DistanceShift;
+
+    /**
+     *  The Verses modifier for each armor type.
+     */
+    std::vector<double> Modifiers;
+};
+
+
+const WarheadDamageProfileStruct &Warhead_Damage_Profile(WarheadTypeClass *warhead);
+int Warhead_Damage_Falloff_Step(const WarheadDamageProfileStruct &profile, int distance);
+int Warhead_Damage_Falloff(int damage, int step);
@@ -39,6 +39,7 @@ std::vector<std::vector<Verses::VersesData<double>>> Verses::Modifier;
 std::vector<std::vector<Verses::VersesData<bool>>> Verses::ForceFire;
 std::vector<std::vector<Verses::VersesData<bool>>> Verses::PassiveAcquire;
 std::vector<std::vector<Verses::VersesData<bool>>> Verses::Retaliate;
+unsigned Verses::Revision = 0;
 
 /**
  *  Saves all the Verses arrays to the stream.
@@ -84,6 +85,9 @@ HRESULT Verses::Load(IStream* pStm)
         return hr;
 
     hr = Load_2D_Vector(pStm, Retaliate, "Verses::Retaliate");
+
+    Mark_Changed();
+
     return hr;
 }
 
@@ -95,6 +99,8 @@ HRESULT Verses::Load(IStream* pStm)
  */
 void Verses::Resize()
 {
+    Mark_Changed();
+
     const int old_armor_count = Modifier.size();
 
     // Add new arrays for new armors
@@ -134,6 +140,8 @@ void Verses::Clear()
     ForceFire.clear();
     PassiveAcquire.clear();
     Retaliate.clear();
+
+    Mark_Changed();
 }
 
 
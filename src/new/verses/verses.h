@@ -61,6 +61,9 @@ public:
     static void Resize();
     static void Clear();
 
+    static void Mark_Changed() { ++Revision; }
+    static unsigned Get_Revision() { return Revision; }
+
     static void Set_Modifier(ArmorType armor, WarheadType warhead, double value) { Set_Value(armor, warhead, value, Modifier); }
     static double Get_Modifier(ArmorType armor, WarheadType warhead) { return Get_Value(armor, warhead, Modifier, &ArmorTypeClass::Modifier); }
 
@@ -112,6 +115,12 @@ private:
     static std::vector<std::vector<VersesData<bool>>> ForceFire;
     static std::vector<std::vector<VersesData<bool>>> PassiveAcquire;
     static std::vector<std::vector<VersesData<bool>>> Retaliate;
+
+    /**
+     *  Incremented whenever the tables or the armor and warhead data they
+     *  fall back to might have changed, so cached results can be rebuilt.
+     */
+    static unsigned Revision;
 };
 
 
@@ -128,6 +137,8 @@ void Verses::Set_Value(ArmorType armor, WarheadType warhead, T value, std::vecto
 
     vector[armor][warhead].Value = value;
     vector[armor][warhead].IsSet = true;
+
+    Mark_Changed();
 }
 
 
@@ -54,9 +54,17 @@
 #include "uicontrol.h"
 #include "mousetype.h"
 #include "actiontype.h"
+#include "spawner_settings.h"
+#include "imagecache.h"
+#include "textcache.h"
+#include "framepacer.h"
+#include "vinifera_saveindex.h"
+#include "vinifera_manifest.h"
+#include "crashrecord.h"
 #include "debughandler.h"
 #include "asserthandler.h"
 #include <string>
+#include <algorithm>
 
 #include "rocketlocomotion.h"
 #include "setup_hooks.h"
@@ -149,98 +157,51 @@ bool Vinifera_Load_INI()
 /**
  *  Loads the exception database.
  * 
+ *  The database may be the text file shipped with the target, or the compiled
+ *  form written by the edbcompile tool, which loads without any parsing. Either
+ *  way the result is an address sorted table the exception handler can binary
+ *  search. If the load fails for any reason, the database is left empty.
+ * 
  *  @author: CCHyper
  */
 static bool Vinifera_Load_Exception_Database(const char *filename)
 {
+    ExceptionInfoDatabase.Clear();
+
     RawFileClass file(filename);
     if (!file.Is_Available()) {
         return false;
     }
 
-    FileStraw fstraw(file);
-
-    bool eof = false;
-    bool found_first_line = false;
-    char line_buffer[11 + 2 + 2 + 1024]; // address, bool, bool, desc
-    ExceptionInfoDatabaseStruct einfo;
-
-    while (true) {
-
-        char *tok = nullptr;
-           
-        /**
-         *  Read the line into the buffer.
-         */
-        int count = Read_Line(fstraw, line_buffer, sizeof(line_buffer), eof);
-
-        /**
-         *  Handle end of file and invalid line cases.
-         */
-        if (eof) {
-            break;
-        }
-        if (!count) {
-            continue;
-        }
-        if (count >= sizeof(line_buffer)) {
-            break;
-        }
-
-        int index = 0; // cursor position.
-
-        /**
-         *  Step over any indenting.
-         */
-        while (std::isspace(line_buffer[index])) {
-            ++index;
-        }
-
-        /**
-         *  Handle commented out lines.
-         */
-        if (line_buffer[index] == ';') {
-            continue;
-        }
-
-        /**
-         *  Process the database line.
-         */
-
-        tok = std::strtok(&line_buffer[index], ",");
-        ASSERT(tok != nullptr);
-        if (tok[0] != '0' || tok[1] != 'x') {
-            DEBUG_WARNING("Invalid address format in exception database!\n");
-            return false;
-        }
-        einfo.Address = std::strtoul(tok+2, nullptr, 16);
+    int size = file.Size();
+    if (size <= 0) {
+        return false;
+    }
 
-        tok = std::strtok(nullptr, ",");
-        ASSERT(tok != nullptr);
-        einfo.CanContinue = std::strtoul(tok, nullptr, 10) ? true : false;
+    char *buffer = new char [size];
 
-        tok = std::strtok(nullptr, ",");
-        ASSERT(tok != nullptr);
-        einfo.Ignore = std::strtoul(tok, nullptr, 10) ? true : false;
-        
-        tok = std::strtok(nullptr, ",");
-        ASSERT(tok != nullptr);
-        std::strncpy(einfo.Description, tok, std::strlen(tok));
+    int read = file.Read(buffer, size);
+    bool compiled = ExceptionDatabaseClass::Is_Compiled(buffer, read);
+    bool loaded = (read == size) && ExceptionInfoDatabase.Load(buffer, size);
 
-        ExceptionInfoDatabase.Add(einfo);
-    }
+    delete [] buffer;
 
-    if (!ExceptionInfoDatabase.Count()) {
-        DEBUG_WARNING("Invalid format in exception database!\n");
+    if (!loaded) {
+        ExceptionInfoDatabase.Clear();
         return false;
     }
 
+    DEBUG_INFO("Loaded %d exception database entries (%d unique descriptions) from the %s database.\n",
+        ExceptionInfoDatabase.Count(), ExceptionInfoDatabase.Description_Count(),
+        compiled ? "compiled" : "text");
+
 #ifndef NDEBUG
     DEV_DEBUG_INFO("Exception database dump...\n");
     for (int i = 0; i < ExceptionInfoDatabase.Count(); ++i) {
-        ExceptionInfoDatabaseStruct &e = ExceptionInfoDatabase[i];
-        DEV_DEBUG_INFO("  0x%08X %s %s \"%.32s...\"\n",
-                       e.Address, e.CanContinue ? "true " : "false",
+        const ExceptionInfoDatabaseStruct &e = ExceptionInfoDatabase[i];
+        DEV_DEBUG_INFO("  0x%08X-0x%08X %s %s \"%.32s...\"\n",
+                       e.Address, e.EndAddress,
+                       e.CanContinue ? "true " : "false",
                        e.Ignore ? "true " : "false",
                        e.Description);
     }
@@ -429,6 +390,15 @@ bool Vinifera_Parse_Command_Line(int argc, char *argv[])
             continue;
         }
 
+        /**
+         *  Only capture raw addresses on a crash, leaving symbolisation for later?
+         */
+        if (stricmp(string, "-FAST_CRASH_CAPTURE") == 0) {
+            DEBUG_INFO("  - Fast crash capture enabled.\n");
+            FastCrashCapture = true;
+            continue;
+        }
+
         /**
          *  Specify the random number seed (for debugging).
          */
@@ -551,6 +521,15 @@ bool Vinifera_Startup()
 #endif
     }
 
+    /**
+     *  Parse the spawner settings once, rather than each hook reading SPAWN.INI
+     *  when it first needs a value.
+     */
+    DWORD spawner_time = timeGetTime();
+    if (Spawner::Load_Settings()) {
+        DEBUG_INFO("Loaded SPAWN.INI settings in %d ms.\n", timeGetTime() - spawner_time);
+    }
+
     DEBUG_INFO("Setting up conditional hooks.\n");
     Setup_Conditional_Hooks();
 
@@ -638,6 +617,21 @@ bool Vinifera_Startup()
     //CnCNet5::IsActive = true; // Enable when new Client system is implemented.
 #endif
 
+    /**
+     *  Verify the game archives against the manifest (if one is present), so
+     *  modified or mismatched files are reported before a network game. This
+     *  reads every listed archive, so it is only done when launched by the
+     *  spawner or for CnCNet, where mismatched files cause desyncs.
+     */
+    if (Spawner::Settings.IsLoaded || CnCNet4::IsEnabled || CnCNet5::IsActive) {
+        if (!Vinifera_Verify_Manifest("MANIFEST.INI")) {
+            DEBUG_WARNING("One or more files failed the manifest check!\n");
+            MessageBox(MainWindow, "One or more game files do not match the manifest, see the debug log for details.", "Vinifera", MB_ICONWARNING|MB_OK);
+        }
+    } else {
+        DEBUG_INFO("Manifest: Skipped, not a network launch.\n");
+    }
+
     KamikazeTracker = new KamikazeTrackerClass;
 
     return true;
@@ -686,6 +680,28 @@ bool Vinifera_Shutdown()
     delete KamikazeTracker;
     KamikazeTracker = nullptr;
 
+    /**
+     *  Cleanup the shared image surfaces.
+     */
+    Image_Cache_Print_Stats();
+    Image_Cache_Clear();
+
+    /**
+     *  Cleanup the cached overlay text.
+     */
+    Text_Run_Cache_Print_Stats();
+    Text_Run_Cache_Clear();
+
+    /**
+     *  Release the frame pacer timer resolution request.
+     */
+    Frame_Pacer_Shutdown();
+
+    /**
+     *  Write out any changes to the save index.
+     */
+    Save_Index_Flush();
+
     DEV_DEBUG_INFO("Shutdown - New Count: %d, Delete Count: %d\n", Vinifera_New_Count, Vinifera_Delete_Count);
 
     return true;
@@ -59,6 +59,8 @@ bool Vinifera_Developer_FrameStep = false;
 int Vinifera_Developer_FrameStepCount = 0;
 bool Vinifera_Developer_AIControl = false;
 bool Vinifera_Developer_IsToReloadRules = false;
+bool Vinifera_Developer_IsToReloadRulesIncremental = false;
+bool Vinifera_Developer_Profiler = false;
 
 bool Vinifera_SkipLogoMovies = false;
 bool Vinifera_SkipStartupMovies = false;
@@ -98,4 +100,4 @@ bool Vinifera_ExitAfterSkip = false;
 
 bool Vinifera_NewSidebar = false;
 
-DynamicVectorClass<ExceptionInfoDatabaseStruct> ExceptionInfoDatabase;
+ExceptionDatabaseClass ExceptionInfoDatabase;
@@ -30,6 +30,7 @@
 #include "always.h"
 #include "vector.h"
 #include "ccfile.h"
+#include "exceptiondb.h"
 
 
 class KamikazeTrackerClass;
@@ -81,6 +82,8 @@ extern bool Vinifera_Developer_FrameStep;
 extern int Vinifera_Developer_FrameStepCount;
 extern bool Vinifera_Developer_AIControl;
 extern bool Vinifera_Developer_IsToReloadRules;
+extern bool Vinifera_Developer_IsToReloadRulesIncremental;
+extern bool Vinifera_Developer_Profiler;
 
 
 /**
@@ -131,28 +134,4 @@ extern bool Vinifera_ExitAfterSkip;
 extern bool Vinifera_NewSidebar;
 
 
-/**
- *  Definition for the exception database struct. If you update this
- *  struct, make sure you check if you need to update the exception handler.
- */
-struct ExceptionInfoDatabaseStruct
-{
-    ExceptionInfoDatabaseStruct() :
-        Address(0x00000000),
-        CanContinue(false),
-        Ignore(false),
-        Description()
-    {
-        std::memset(Description, 0, sizeof(Description));
-    }
-
-    bool operator==(const ExceptionInfoDatabaseStruct &src) const { return false; }
-    bool operator!=(const ExceptionInfoDatabaseStruct &src) const { return true; }
-
-    uint32_t Address;
-    bool CanContinue;
-    bool Ignore;
-    char Description[1024];
-};
-
-extern DynamicVectorClass<ExceptionInfoDatabaseStruct> ExceptionInfoDatabase;
+extern ExceptionDatabaseClass ExceptionInfoDatabase;
@@ -0,0 +1,231 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          VINIFERA_MANIFEST.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Verification of the game archives against a SHA-1 manifest.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "vinifera_manifest.h"
+#include "sha.h"
+#include "ccfile.h"
+#include "ccini.h"
+#include "debughandler.h"
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+
+/**
+ *  The section of the manifest listing each file and its expected digest.
+ */
+#define MANIFEST_SECTION "Manifest"
+
+
+/**
+ *  Files are hashed in large chunks so the archives are streamed from disk
+ *  with as few reads as possible.
+ */
+#define MANIFEST_CHUNK_SIZE (256*1024)
+
+
+/**
+ *  The number of files hashed together, matching the streams SHA::Hash_Streams
+ *  processes at once.
+ */
+#define MANIFEST_STREAMS 4
+
+
+/**
+ *  Hashes the contents of several files together, streaming each in large
+ *  chunks. The chunks of all the open files are hashed in a single pass so
+ *  their blocks can share the vector units. Returns the number of files that
+ *  were hashed; found[] is set for each file that could be opened.
+ * 
+ *  @author: agent
+ */
+int Vinifera_Hash_Files(const char **filenames, unsigned char (*digests)[20], bool *found, int count)
+{
+    if (!filenames || !digests || !found) {
+        return 0;
+    }
+
+    unsigned char *buffer = new unsigned char [MANIFEST_STREAMS * MANIFEST_CHUNK_SIZE];
+
+    int hashed = 0;
+
+    for (int first = 0; first < count; first += MANIFEST_STREAMS) {
+
+        int lanes = std::min(count - first, MANIFEST_STREAMS);
+
+        CCFileClass file[MANIFEST_STREAMS];
+        SHA sha[MANIFEST_STREAMS];
+        bool open[MANIFEST_STREAMS] = { false };
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            found[first+lane] = false;
+            file[lane].Set_Name(filenames[first+lane]);
+            if (file[lane].Is_Available() && file[lane].Open(FILE_ACCESS_READ)) {
+                found[first+lane] = true;
+                open[lane] = true;
+            }
+        }
+
+        while (true) {
+
+            SHA *streams[MANIFEST_STREAMS];
+            const void *data[MANIFEST_STREAMS];
+            long lengths[MANIFEST_STREAMS];
+            int active = 0;
+
+            for (int lane = 0; lane < lanes; ++lane) {
+                if (!open[lane]) {
+                    continue;
+                }
+
+                unsigned char *chunk = &buffer[lane * MANIFEST_CHUNK_SIZE];
+                long read = file[lane].Read(chunk, MANIFEST_CHUNK_SIZE);
+                if (read < MANIFEST_CHUNK_SIZE) {
+                    file[lane].Close();
+                    open[lane] = false;
+                }
+                if (read <= 0) {
+                    continue;
+                }
+
+                streams[active] = &sha[lane];
+                data[active] = chunk;
+                lengths[active] = read;
+                ++active;
+            }
+
+            if (!active) {
+                break;
+            }
+
+            SHA::Hash_Streams(streams, data, lengths, active);
+        }
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            if (found[first+lane]) {
+                sha[lane].Result(digests[first+lane]);
+                ++hashed;
+            }
+        }
+    }
+
+    delete [] buffer;
+
+    return hashed;
+}
+
+
+/**
+ *  Hashes the contents of a file, streaming it in large chunks.
+ * 
+ *  @author: agent
+ */
+bool Vinifera_Hash_File(const char *filename, unsigned char *digest)
+{
+    if (!filename || !digest) {
+        return false;
+    }
+
+    bool found = false;
+    Vinifera_Hash_Files(&filename, (unsigned char (*)[20])digest, &found, 1);
+
+    return found;
+}
+
+
+/**
+ *  Checks each file listed in the manifest against its expected SHA-1 digest.
+ *  Returns false if any listed file is missing or does not match. A missing
+ *  manifest is not an error, there is simply nothing to verify.
+ * 
+ *  @author: agent
+ */
+bool Vinifera_Verify_Manifest(const char *filename)
+{
+    CCFileClass file(filename);
+    if (!file.Is_Available()) {
+        return true;
+    }
+
+    CCINIClass ini;
+    ini.Load(file, false);
+
+    DWORD start_time = timeGetTime();
+
+    int count = ini.Entry_Count(MANIFEST_SECTION);
+    if (count <= 0) {
+        return true;
+    }
+
+    const char **entries = new const char * [count];
+    unsigned char (*digests)[20] = new unsigned char [count][20];
+    bool *found = new bool [count];
+
+    int entry_count = 0;
+    for (int index = 0; index < count; ++index) {
+        const char *entry = ini.Get_Entry(MANIFEST_SECTION, index);
+        if (entry) {
+            entries[entry_count++] = entry;
+        }
+    }
+
+    Vinifera_Hash_Files(entries, digests, found, entry_count);
+
+    int failed = 0;
+
+    for (int index = 0; index < entry_count; ++index) {
+
+        const char *entry = entries[index];
+
+        if (!found[index]) {
+            DEBUG_WARNING("Manifest: \"%s\" is missing!\n", entry);
+            ++failed;
+            continue;
+        }
+
+        char expected[64];
+        ini.Get_String(MANIFEST_SECTION, entry, "", expected, sizeof(expected));
+
+        char result[(sizeof(digests[index])*2)+1];
+        for (int i = 0; i < sizeof(digests[index]); ++i) {
+            std::snprintf(&result[i*2], 3, "%02x", digests[index][i]);
+        }
+
+        if (strcmpi(result, expected) != 0) {
+            DEBUG_WARNING("Manifest: \"%s\" does not match (expected %s, got %s)!\n", entry, expected, result);
+            ++failed;
+        }
+    }
+
+    DEBUG_INFO("Manifest: Verified %d files (%d failed) in %d ms.\n", entry_count, failed, timeGetTime() - start_time);
+
+    delete [] entries;
+    delete [] digests;
+    delete [] found;
+
+    return failed == 0;
+}
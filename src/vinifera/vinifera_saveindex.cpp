@@ -0,0 +1,300 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          VINIFERA_SAVEINDEX.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Persistent index of the save file headers in the saves directory.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "vinifera_saveindex.h"
+#include "vinifera_savever.h"
+#include "vinifera_globals.h"
+#include "miscutil.h"
+#include "debughandler.h"
+#include <Windows.h>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <unordered_map>
+
+
+/**
+ *  The filename of the index, this lives in the saves directory.
+ */
+#define SAVE_INDEX_FILENAME "SAVEGAME.IDX"
+
+
+/**
+ *  Identifies the index file and the layout of the entries it holds. The
+ *  size of the version info is stored too, so a change to it invalidates
+ *  any index written by an older build.
+ */
+#define SAVE_INDEX_ID       0x58444956 // "VIDX"
+#define SAVE_INDEX_VERSION  1
+
+
+typedef struct SaveIndexHeaderStruct
+{
+    uint32_t ID;
+    uint32_t Version;
+    uint32_t InfoSize;
+    uint32_t Count;
+} SaveIndexHeaderStruct;
+
+
+/**
+ *  A single save file in the index. The header is only valid while the size
+ *  and last write time of the file match the values stored here.
+ */
+typedef struct SaveIndexEntryStruct
+{
+    char Filename[MAX_PATH];
+    uint32_t SizeLow;
+    uint32_t SizeHigh;
+    FILETIME LastWriteTime;
+    ViniferaSaveVersionInfo Info;
+} SaveIndexEntryStruct;
+
+
+static std::unordered_map<std::string, SaveIndexEntryStruct> SaveIndex;
+static bool SaveIndexLoaded = false;
+static bool SaveIndexDirty = false;
+
+
+/**
+ *  The index is keyed by the upper-cased filename, without the path.
+ */
+static std::string Save_Index_Key(const char *filename)
+{
+    std::string key = Filename_From_Path(filename);
+    for (char &c : key) {
+        c = (char)std::toupper((unsigned char)c);
+    }
+    return key;
+}
+
+
+static void Save_Index_Filename(char *buffer, size_t size)
+{
+    std::snprintf(buffer, size, "%s\\%s", Vinifera_SavedGamesDirectory, SAVE_INDEX_FILENAME);
+}
+
+
+/**
+ *  Reads the index file from the saves directory, if it exists.
+ * 
+ *  @author: agent
+ */
+static void Save_Index_Load()
+{
+    if (SaveIndexLoaded) {
+        return;
+    }
+
+    SaveIndexLoaded = true;
+    SaveIndexDirty = false;
+    SaveIndex.clear();
+
+    char index_filename[PATH_MAX];
+    Save_Index_Filename(index_filename, sizeof(index_filename));
+
+    FILE *fp = std::fopen(index_filename, "rb");
+    if (fp == nullptr) {
+        return;
+    }
+
+    SaveIndexHeaderStruct header;
+    if (std::fread(&header, sizeof(header), 1, fp) != 1
+     || header.ID != SAVE_INDEX_ID
+     || header.Version != SAVE_INDEX_VERSION
+     || header.InfoSize != sizeof(ViniferaSaveVersionInfo)) {
+
+        DEBUG_WARNING("Save index \"%s\" is out of date, it will be rebuilt.\n", index_filename);
+        std::fclose(fp);
+        SaveIndexDirty = true;
+        return;
+    }
+
+    SaveIndex.reserve(header.Count);
+
+    for (uint32_t i = 0; i < header.Count; ++i) {
+        SaveIndexEntryStruct entry;
+        if (std::fread(&entry, sizeof(entry), 1, fp) != 1) {
+            DEBUG_WARNING("Save index \"%s\" is truncated!\n", index_filename);
+            SaveIndexDirty = true;
+            break;
+        }
+        entry.Filename[std::size(entry.Filename)-1] = '\0';
+        SaveIndex[Save_Index_Key(entry.Filename)] = entry;
+    }
+
+    std::fclose(fp);
+
+    DEBUG_INFO("Save index: Loaded %d entries.\n", (int)SaveIndex.size());
+}
+
+
+/**
+ *  Reads the header from a save file and stores it in the index.
+ * 
+ *  @author: agent
+ */
+static bool Save_Index_Read_File(const char *filename, const WIN32_FILE_ATTRIBUTE_DATA &attributes, ViniferaSaveVersionInfo &info)
+{
+    if (!Vinifera_Get_Savefile_Info(filename, info)) {
+        return false;
+    }
+
+    SaveIndexEntryStruct entry;
+    std::memset(&entry, 0, sizeof(entry));
+    std::strncpy(entry.Filename, Filename_From_Path(filename), std::size(entry.Filename)-1);
+    entry.SizeLow = attributes.nFileSizeLow;
+    entry.SizeHigh = attributes.nFileSizeHigh;
+    entry.LastWriteTime = attributes.ftLastWriteTime;
+    entry.Info = info;
+
+    SaveIndex[Save_Index_Key(filename)] = entry;
+    SaveIndexDirty = true;
+
+    return true;
+}
+
+
+/**
+ *  Fetches the header of a save file, only opening the file itself if it is
+ *  not in the index or has changed since it was indexed.
+ * 
+ *  @author: agent
+ */
+bool Save_Index_Get_Info(const char *filename, ViniferaSaveVersionInfo &info)
+{
+    Save_Index_Load();
+
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExA(filename, GetFileExInfoStandard, &attributes)) {
+        return false;
+    }
+
+    auto it = SaveIndex.find(Save_Index_Key(filename));
+    if (it != SaveIndex.end()) {
+        const SaveIndexEntryStruct &entry = it->second;
+        if (entry.SizeLow == attributes.nFileSizeLow
+         && entry.SizeHigh == attributes.nFileSizeHigh
+         && CompareFileTime(&entry.LastWriteTime, &attributes.ftLastWriteTime) == 0) {
+
+            info = entry.Info;
+            return true;
+        }
+    }
+
+    return Save_Index_Read_File(filename, attributes, info);
+}
+
+
+/**
+ *  Re-reads the header of a save file that has just been written.
+ * 
+ *  @author: agent
+ */
+void Save_Index_Update(const char *filename)
+{
+    Save_Index_Load();
+
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExA(filename, GetFileExInfoStandard, &attributes)) {
+        Save_Index_Remove(filename);
+        return;
+    }
+
+    ViniferaSaveVersionInfo info;
+    if (!Save_Index_Read_File(filename, attributes, info)) {
+        Save_Index_Remove(filename);
+    }
+}
+
+
+/**
+ *  Removes a deleted save file from the index.
+ * 
+ *  @author: agent
+ */
+void Save_Index_Remove(const char *filename)
+{
+    Save_Index_Load();
+
+    if (SaveIndex.erase(Save_Index_Key(filename)) > 0) {
+        SaveIndexDirty = true;
+    }
+}
+
+
+/**
+ *  Writes the index to the saves directory if it has changed. Entries for
+ *  files that no longer exist are dropped.
+ * 
+ *  @author: agent
+ */
+void Save_Index_Flush()
+{
+    if (!SaveIndexLoaded || !SaveIndexDirty) {
+        return;
+    }
+
+    char index_filename[PATH_MAX];
+    Save_Index_Filename(index_filename, sizeof(index_filename));
+
+    char filename[PATH_MAX];
+
+    for (auto it = SaveIndex.begin(); it != SaveIndex.end(); ) {
+        std::snprintf(filename, sizeof(filename), "%s\\%s", Vinifera_SavedGamesDirectory, it->second.Filename);
+        if (GetFileAttributesA(filename) == INVALID_FILE_ATTRIBUTES) {
+            it = SaveIndex.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    FILE *fp = std::fopen(index_filename, "wb");
+    if (fp == nullptr) {
+        DEBUG_ERROR("Failed to open save index \"%s\" for writing!\n", index_filename);
+        return;
+    }
+
+    SaveIndexHeaderStruct header;
+    header.ID = SAVE_INDEX_ID;
+    header.Version = SAVE_INDEX_VERSION;
+    header.InfoSize = sizeof(ViniferaSaveVersionInfo);
+    header.Count = (uint32_t)SaveIndex.size();
+
+    std::fwrite(&header, sizeof(header), 1, fp);
+
+    for (const auto &it : SaveIndex) {
+        std::fwrite(&it.second, sizeof(it.second), 1, fp);
+    }
+
+    std::fclose(fp);
+
+    SaveIndexDirty = false;
+
+    DEBUG_INFO("Save index: Wrote %d entries.\n", (int)SaveIndex.size());
+}
@@ -31,6 +31,7 @@
 #include "tibsun_util.h"
 #include "vinifera_util.h"
 #include "vinifera_gitinfo.h"
+#include "vinifera_saveindex.h"
 #include "wstring.h"
 #include "saveload.h"
 #include "extension.h"
@@ -969,6 +970,11 @@ bool LoadOptionsClassExt::_Load_File(const char* filename)
     ScenarioStarted = false;
 
     _makepath(formatted_file_name, nullptr, Vinifera_SavedGamesDirectory, Filename_From_Path(filename), nullptr);
+    /**
+     *  Write out any headers indexed while listing the saves.
+     */
+    Save_Index_Flush();
+
     const bool result = Load_Game(formatted_file_name);
 
     if (handle) {
@@ -996,6 +1002,16 @@ bool LoadOptionsClassExt::_Save_File(const char* filename, const char* descripti
     _makepath(formatted_file_name, nullptr, Vinifera_SavedGamesDirectory, Filename_From_Path(filename), nullptr);
     const bool result = Save_Game(formatted_file_name, description, false);
 
+    /**
+     *  Keep the save index in sync with the saves directory.
+     */
+    if (result) {
+        Save_Index_Update(formatted_file_name);
+    } else {
+        Save_Index_Remove(formatted_file_name);
+    }
+    Save_Index_Flush();
+
     if (handle) {
         WinDialogClass::End_Dialog(handle);
     }
@@ -1014,7 +1030,14 @@ bool LoadOptionsClassExt::_Delete_File(const char* filename)
     char formatted_file_name[PATH_MAX];
 
     _makepath(formatted_file_name, nullptr, Vinifera_SavedGamesDirectory, Filename_From_Path(filename), nullptr);
-    return DeleteFileA(formatted_file_name);
+    const bool result = DeleteFileA(formatted_file_name) != FALSE;
+
+    if (result) {
+        Save_Index_Remove(formatted_file_name);
+        Save_Index_Flush();
+    }
+
+    return result;
 }
 
 
@@ -1034,8 +1057,12 @@ bool LoadOptionsClassExt::_Read_File(FileEntryClass* file, WIN32_FIND_DATA* file
 
         _makepath(formatted_file_name, nullptr, Vinifera_SavedGamesDirectory, Filename_From_Path(filename->cFileName), nullptr);
 
+        /**
+         *  Fetch the header from the save index, this only opens the save
+         *  file if it is new or has changed since it was last indexed.
+         */
         ViniferaSaveVersionInfo saveversion;
-        if (Vinifera_Get_Savefile_Info(formatted_file_name, saveversion)) {
+        if (Save_Index_Get_Info(formatted_file_name, saveversion)) {
 
             unsigned game_version = saveversion.Get_Internal_Version();
             if (game_version != GameVersion) {
@@ -43,7 +43,7 @@
 #include "msgbox.h"
 #include "minidump.h"
 #include "winutil.h"
-#include "xzip.h"
+#include "zipwriter.h"
 #include <cstdio>
 
 
@@ -476,28 +476,52 @@ const char *Vinifera_Get_Window_Title(DWORD dwPid)
 }
 
 
+/**
+ *  Should this file be stored in the archive as-is rather than compressed?
+ * 
+ *  Images and archives are already compressed, so deflating them only costs
+ *  time. Mini dumps can be hundreds of megabytes and deflating them at crash
+ *  time stalls the handler for seconds, so those are stored too.
+ */
+static bool Vinifera_Zip_Should_Store(const char *filename)
+{
+    static const char *_stored_ext[] = {
+        ".DMP", ".PNG", ".JPG", ".JPEG", ".ZIP", ".7Z"
+    };
+
+    const char *ext = std::strrchr(filename, '.');
+    if (!ext) {
+        return false;
+    }
+
+    for (int i = 0; i < std::size(_stored_ext); ++i) {
+        if (stricmp(ext, _stored_ext[i]) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
 /**
  *  Creates a zip file is the specified files.
  * 
- *  @note: If the zip file already exists, it will be updated.
+ *  Each file is streamed into the archive in fixed size chunks, so memory use
+ *  does not depend on the size of the files. The files that are compressed
+ *  are deflated on a thread each, up to the number of processors.
+ * 
+ *  @note: If the zip file already exists, it will be replaced.
  * 
  *  @author: CCHyper
  */
 bool Vinifera_Create_Zip(const char *filename, DynamicVectorClass<const char *> &filelist, const char *path)
 {
     char buffer[PATH_MAX];
-    
-    if (path) {
-        std::snprintf(buffer, sizeof(buffer), "%s\\%s", path, filename);
-    } else {
-        std::snprintf(buffer, sizeof(buffer), ".\\%s", filename);
-    }
 
-    HZIP hZip = CreateZip((void *)buffer, 0, ZIP_FILENAME);
-    if (!hZip) {
-        DEBUG_ERROR("Failed to create zip archive \"%s\"!\n", filename);
-        return false;
-    }
+    DWORD start_time = timeGetTime();
+
+    ZipWriterClass zip;
 
     /**
      *  
@@ -508,16 +532,23 @@ bool Vinifera_Create_Zip(const char *filename, DynamicVectorClass<const char *>
         } else {
             std::snprintf(buffer, sizeof(buffer), ".\\%s", filelist[i]);
         }
-        ZRESULT zresult = ZipAdd(hZip, filelist[i], buffer, 0, ZIP_FILENAME);
-        if (zresult != ZR_OK) {
-            DEBUG_ERROR("Failed to add file \"%s\" to zip archive \"%s\"!\n", buffer, filename);
-            return false;
-        }
+        zip.Add_File(filelist[i], buffer, Vinifera_Zip_Should_Store(filelist[i]));
+    }
+
+    if (path) {
+        std::snprintf(buffer, sizeof(buffer), "%s\\%s", path, filename);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), ".\\%s", filename);
+    }
+
+    if (!zip.Write(buffer)) {
+        DEBUG_ERROR("Failed to create zip archive \"%s\"!\n", filename);
+        return false;
     }
-    
-    DEBUG_INFO("Zip archive \"%s\" created sucessfully.\n", filename);
 
-    return CloseZip(hZip) == ZR_OK;
+    DEBUG_INFO("Zip archive \"%s\" created sucessfully in %d ms.\n", filename, timeGetTime() - start_time);
+
+    return true;
 }
 
 
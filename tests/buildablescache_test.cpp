@@ -0,0 +1,388 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          BUILDABLESCACHE_TEST.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Host test for the buildables cache.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "hosttest.h"
+#include "buildablescache.h"
+#include <random>
+#include <vector>
+
+
+/**
+ *  A small model of the game; houses owning objects of a few kinds, and
+ *  types that need a building, power and a tech level to be built.
+ */
+#define LIST_COUNT      4
+#define LIST_BUILDINGS  0
+#define TYPE_COUNT      24
+#define HOUSE_COUNT     3
+
+
+struct TypeStruct
+{
+    int Prerequisite;
+    int TechLevel;
+    bool NeedsPower;
+    int BuildLimit;
+};
+
+struct HouseStruct
+{
+    int Power;
+    int Drain;
+    int TechLevel;
+    int Owned[LIST_COUNT][TYPE_COUNT];
+};
+
+static TypeStruct Types[LIST_COUNT][TYPE_COUNT];
+static HouseStruct Houses[HOUSE_COUNT];
+
+static int BuildCalls = 0;
+
+
+static int Owned_Buildings(const HouseStruct &house)
+{
+    int count = 0;
+    for (int type = 0; type < TYPE_COUNT; ++type) {
+        count += house.Owned[LIST_BUILDINGS][type];
+    }
+    return count;
+}
+
+
+static int Objects_In_Game(int list)
+{
+    int count = 0;
+    for (const HouseStruct &house : Houses) {
+        for (int type = 0; type < TYPE_COUNT; ++type) {
+            count += house.Owned[list][type];
+        }
+    }
+    return count;
+}
+
+
+/**
+ *  The uncached check, the equivalent of Can_Build and Who_Can_Build_Me.
+ */
+static std::vector<int> Uncached_Buildables(const HouseStruct &house, int list)
+{
+    std::vector<int> buildables;
+
+    for (int type = 0; type < TYPE_COUNT; ++type) {
+        const TypeStruct &info = Types[list][type];
+
+        if (info.TechLevel > house.TechLevel) {
+            continue;
+        }
+        if (info.Prerequisite >= 0 && house.Owned[LIST_BUILDINGS][info.Prerequisite] == 0) {
+            continue;
+        }
+        if (info.NeedsPower && house.Power < house.Drain) {
+            continue;
+        }
+        if (info.BuildLimit > 0 && house.Owned[list][type] >= info.BuildLimit) {
+            continue;
+        }
+
+        buildables.push_back(type);
+    }
+
+    return buildables;
+}
+
+
+/**
+ *  The same hashes the game uses, over the model.
+ */
+static uint32_t Tech_State(void *param)
+{
+    const HouseStruct &house = *(HouseStruct *)param;
+    uint32_t hash = BuildablesCacheClass::HASH_START;
+
+    BuildablesCacheClass::Hash(hash, house.Power);
+    BuildablesCacheClass::Hash(hash, house.Drain);
+    BuildablesCacheClass::Hash(hash, house.TechLevel);
+
+    for (int list = 0; list < LIST_COUNT; ++list) {
+        BuildablesCacheClass::Hash(hash, TYPE_COUNT);
+        for (int type = 0; type < TYPE_COUNT; ++type) {
+            BuildablesCacheClass::Hash(hash, house.Owned[list][type]);
+        }
+    }
+
+    return hash;
+}
+
+
+static uint32_t Quick_Tech_State(const HouseStruct &house)
+{
+    uint32_t hash = BuildablesCacheClass::HASH_START;
+
+    BuildablesCacheClass::Hash(hash, house.Power);
+    BuildablesCacheClass::Hash(hash, house.Drain);
+    BuildablesCacheClass::Hash(hash, house.TechLevel);
+    BuildablesCacheClass::Hash(hash, Owned_Buildings(house));
+
+    for (int list = 0; list < LIST_COUNT; ++list) {
+        BuildablesCacheClass::Hash(hash, Objects_In_Game(list));
+    }
+
+    return hash;
+}
+
+
+static void Build(void *param, int list, std::vector<int> &buildables)
+{
+    ++BuildCalls;
+    buildables = Uncached_Buildables(*(HouseStruct *)param, list);
+}
+
+
+static void Setup(std::mt19937 &random)
+{
+    for (int list = 0; list < LIST_COUNT; ++list) {
+        for (int type = 0; type < TYPE_COUNT; ++type) {
+            TypeStruct &info = Types[list][type];
+            info.Prerequisite = (random() % 4) == 0 ? -1 : (int)(random() % TYPE_COUNT);
+            info.TechLevel = (int)(random() % 10);
+            info.NeedsPower = (random() % 3) == 0;
+            info.BuildLimit = (random() % 5) == 0 ? 1 + (int)(random() % 2) : 0;
+        }
+    }
+
+    for (HouseStruct &house : Houses) {
+        house = HouseStruct();
+        house.Power = 100;
+        house.Drain = 50;
+        house.TechLevel = 5;
+        house.Owned[LIST_BUILDINGS][0] = 1;
+    }
+}
+
+
+/**
+ *  Moves one object of the kind between houses; the number of objects in the
+ *  game stays the same.
+ */
+static bool Capture(std::mt19937 &random, int list, HouseStruct &from, HouseStruct &to)
+{
+    for (int tries = 0; tries < 100; ++tries) {
+        int type = (int)(random() % TYPE_COUNT);
+        if (from.Owned[list][type] > 0) {
+            --from.Owned[list][type];
+            ++to.Owned[list][type];
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ *  Plays random events for a number of frames, with several factories of
+ *  each kind updating every frame, and compares every list fetched from the
+ *  cache with the uncached result.
+ */
+static void Test_Random_Game()
+{
+    std::mt19937 random(42);
+    Setup(random);
+
+    BuildablesCacheClass cache(LIST_COUNT, Tech_State, Build);
+
+    int mismatches = 0;
+    int fetches = 0;
+    BuildCalls = 0;
+
+    for (int frame = 0; frame < 5000; ++frame) {
+
+        HouseStruct &player = Houses[0];
+
+        for (int update = 0; update < 6; ++update) {
+
+            /**
+             *  Events happen between the factory updates within a frame.
+             */
+            int list = (int)(random() % LIST_COUNT);
+            HouseStruct &other = Houses[1 + random() % (HOUSE_COUNT - 1)];
+
+            switch (random() % 12) {
+                case 0:
+                case 1:
+                    ++Houses[random() % HOUSE_COUNT].Owned[list][random() % TYPE_COUNT];
+                    break;
+
+                case 2:
+                {
+                    HouseStruct &house = Houses[random() % HOUSE_COUNT];
+                    int type = (int)(random() % TYPE_COUNT);
+                    if (house.Owned[list][type] > 0) {
+                        --house.Owned[list][type];
+                    }
+                    break;
+                }
+
+                case 3:
+                    /**
+                     *  A building capture changes the number of buildings the
+                     *  player owns, which the quick state sees without help.
+                     */
+                    if (random() % 2) {
+                        Capture(random, LIST_BUILDINGS, other, player);
+                    } else {
+                        Capture(random, LIST_BUILDINGS, player, other);
+                    }
+                    break;
+
+                case 4:
+                    /**
+                     *  Any other capture is only seen through the invalidation
+                     *  done by the capture hook.
+                     */
+                    if (Capture(random, 1 + random() % (LIST_COUNT - 1), other, player)) {
+                        cache.Invalidate();
+                    }
+                    break;
+
+                case 5:
+                    player.Power += (int)(random() % 61) - 30;
+                    break;
+
+                case 6:
+                    if (random() % 50 == 0) {
+                        player.TechLevel = (int)(random() % 11);
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+
+            for (int factory = 0; factory < LIST_COUNT * 2; ++factory) {
+                int factory_list = factory % LIST_COUNT;
+                const std::vector<int> &cached = cache.Fetch(&player, factory_list, frame, Quick_Tech_State(player));
+                ++fetches;
+                if (cached != Uncached_Buildables(player, factory_list)) {
+                    ++mismatches;
+                }
+            }
+        }
+    }
+
+    TEST_CHECK_PRINT(mismatches == 0, "%d of %d fetches", mismatches, fetches);
+
+    /**
+     *  Most fetches must be served from the cache.
+     */
+    std::printf("%d fetches, %d lists built.\n", fetches, BuildCalls);
+    TEST_CHECK_PRINT(BuildCalls < fetches / 4, "%d lists built for %d fetches", BuildCalls, fetches);
+}
+
+
+/**
+ *  A capture of a building within a frame, where the number of objects in the
+ *  game does not change, must still be seen.
+ */
+static void Test_Building_Capture()
+{
+    std::mt19937 random(7);
+    Setup(random);
+
+    for (int type = 0; type < TYPE_COUNT; ++type) {
+        Types[1][type].Prerequisite = 5;
+        Types[1][type].TechLevel = 0;
+        Types[1][type].NeedsPower = false;
+        Types[1][type].BuildLimit = 0;
+    }
+
+    HouseStruct &player = Houses[0];
+    HouseStruct &enemy = Houses[1];
+    enemy.Owned[LIST_BUILDINGS][5] = 1;
+
+    BuildablesCacheClass cache(LIST_COUNT, Tech_State, Build);
+
+    TEST_CHECK(cache.Fetch(&player, 1, 100, Quick_Tech_State(player)).empty());
+
+    --enemy.Owned[LIST_BUILDINGS][5];
+    ++player.Owned[LIST_BUILDINGS][5];
+
+    TEST_CHECK(cache.Fetch(&player, 1, 100, Quick_Tech_State(player)).size() == TYPE_COUNT);
+
+    ++enemy.Owned[LIST_BUILDINGS][5];
+    --player.Owned[LIST_BUILDINGS][5];
+
+    TEST_CHECK(cache.Fetch(&player, 1, 100, Quick_Tech_State(player)).empty());
+}
+
+
+/**
+ *  Invalidating rebuilds every list, and an unchanged state does not.
+ */
+static void Test_Invalidate()
+{
+    std::mt19937 random(9);
+    Setup(random);
+
+    HouseStruct &player = Houses[0];
+
+    BuildablesCacheClass cache(LIST_COUNT, Tech_State, Build);
+    BuildCalls = 0;
+
+    for (int list = 0; list < LIST_COUNT; ++list) {
+        cache.Fetch(&player, list, 1, Quick_Tech_State(player));
+    }
+    TEST_CHECK(BuildCalls == LIST_COUNT);
+
+    for (int frame = 2; frame < 10; ++frame) {
+        for (int list = 0; list < LIST_COUNT; ++list) {
+            cache.Fetch(&player, list, frame, Quick_Tech_State(player));
+        }
+    }
+    TEST_CHECK(BuildCalls == LIST_COUNT);
+
+    cache.Invalidate();
+    for (int list = 0; list < LIST_COUNT; ++list) {
+        cache.Fetch(&player, list, 10, Quick_Tech_State(player));
+    }
+    TEST_CHECK(BuildCalls == LIST_COUNT * 2);
+
+    /**
+     *  Another house does not share the lists of the first.
+     */
+    cache.Fetch(&Houses[1], 0, 10, Quick_Tech_State(Houses[1]));
+    TEST_CHECK(BuildCalls == LIST_COUNT * 2 + 1);
+}
+
+
+int main()
+{
+    Test_Random_Game();
+    Test_Building_Capture();
+    Test_Invalidate();
+
+    return TEST_RESULT();
+}
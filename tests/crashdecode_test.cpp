@@ -0,0 +1,190 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          CRASHDECODE_TEST.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Host test for the offline crash record decoder.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "hosttest.h"
+#include "crashdecoder.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+/**
+ *  An excerpt in the layout the Visual C++ linker writes.
+ */
+static const char LinkerMap[] =
+    " Vinifera\r\n"
+    "\r\n"
+    " Timestamp is 5f000000 (Mon Jul 06 12:00:00 2020)\r\n"
+    "\r\n"
+    " Preferred load address is 10000000\r\n"
+    "\r\n"
+    " Start         Length     Name                   Class\r\n"
+    " 0001:00000000 00012345H .text$mn                CODE\r\n"
+    "\r\n"
+    "  Address         Publics by Value              Rva+Base       Lib:Object\r\n"
+    "\r\n"
+    " 0000:00000000       ___guard_fids_count        00000000     <absolute>\r\n"
+    " 0001:00000000       ?First@@YAXXZ              10001000 f   first.obj\r\n"
+    " 0001:00000100       ?Second@@YAXXZ             10001100 f   second.obj\r\n"
+    " 0001:00000400       ?Third@@YAXXZ              10001400 f i third.obj\r\n"
+    "\r\n"
+    " entry point at        0001:00000000\r\n"
+    "\r\n"
+    " Static symbols\r\n"
+    "\r\n"
+    " 0001:00000200       _Static_Helper             10001200 f   second.obj\r\n";
+
+
+static void Write_Word(std::vector<unsigned char> &data, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        data.push_back((unsigned char)(value >> (i * 8)));
+    }
+}
+
+
+static void Write_String(std::vector<unsigned char> &data, const char *text, int size)
+{
+    std::vector<unsigned char> field(size, 0);
+    std::memcpy(field.data(), text, std::min((int)std::strlen(text), size - 1));
+    data.insert(data.end(), field.begin(), field.end());
+}
+
+
+/**
+ *  Builds a record in the layout written by Crash_Record_Write.
+ */
+static std::vector<unsigned char> Make_Record(const std::vector<uint32_t> &frames)
+{
+    std::vector<unsigned char> data;
+    Write_Word(data, 0x53524356);
+    Write_Word(data, 1);
+    Write_Word(data, 0xC0000005);
+    Write_Word(data, 0x10001104);
+    Write_Word(data, 1);
+    Write_Word(data, 0x00000010);
+    Write_Word(data, 0x10001104);
+    Write_Word(data, 0x0019FF00);
+    Write_Word(data, 0x0019FF20);
+    Write_Word(data, (uint32_t)frames.size());
+    Write_Word(data, 2);
+    Write_String(data, "0123456789abcdef", 48);
+
+    for (uint32_t frame : frames) {
+        Write_Word(data, frame);
+    }
+
+    Write_Word(data, 0x00400000);
+    Write_Word(data, 0x00300000);
+    Write_Word(data, 0x3C000000);
+    Write_String(data, "GAME.EXE", 64);
+
+    Write_Word(data, 0x20000000);
+    Write_Word(data, 0x00100000);
+    Write_Word(data, 0x5F000000);
+    Write_String(data, "Vinifera.dll", 64);
+
+    return data;
+}
+
+
+static void Test_Map()
+{
+    AddressMapClass map;
+    TEST_CHECK(map.Load("build/Vinifera.map", LinkerMap, (int)std::strlen(LinkerMap)));
+    TEST_CHECK(map.Module_Name() == "vinifera");
+    TEST_CHECK(map.Count() == 4);
+
+    uint32_t offset = 0;
+    TEST_CHECK(map.Find(0x0FFF, offset) == nullptr);
+
+    const char *name = map.Find(0x1000, offset);
+    TEST_CHECK(name && std::strcmp(name, "?First@@YAXXZ") == 0 && offset == 0);
+
+    name = map.Find(0x1104, offset);
+    TEST_CHECK(name && std::strcmp(name, "?Second@@YAXXZ") == 0 && offset == 4);
+
+    name = map.Find(0x1250, offset);
+    TEST_CHECK(name && std::strcmp(name, "_Static_Helper") == 0 && offset == 0x50);
+
+    name = map.Find(0x9000, offset);
+    TEST_CHECK(name && std::strcmp(name, "?Third@@YAXXZ") == 0 && offset == 0x7C00);
+
+    AddressMapClass bad;
+    TEST_CHECK(!bad.Load("bad.map", "not a map", 9));
+}
+
+
+static void Test_Record()
+{
+    /**
+     *  The DLL is loaded at a different base than the map prefers, the
+     *  symbols must still resolve relative to the module.
+     */
+    std::vector<uint32_t> frames = { 0x20001104, 0x00401234, 0x20001420, 0x7FFF0000 };
+    std::vector<unsigned char> data = Make_Record(frames);
+
+    CrashRecordFileStruct record;
+    TEST_CHECK(Crash_Record_Read(data.data(), (int)data.size(), record));
+    TEST_CHECK(record.Frames == frames);
+    TEST_CHECK(record.Modules.size() == 2);
+    TEST_CHECK(record.BuildHash == "0123456789abcdef");
+    TEST_CHECK(record.Modules.size() == 2 && record.Modules[1].Name == "Vinifera.dll");
+
+    std::vector<AddressMapClass> maps(1);
+    maps[0].Load("Vinifera.map", LinkerMap, (int)std::strlen(LinkerMap));
+
+    std::string text = Crash_Record_Decode(record, maps);
+    TEST_CHECK(text.find("Access violation writing 0x00000010") != std::string::npos);
+    TEST_CHECK(text.find("0x20001104 Vinifera.dll+0x1104 ?Second@@YAXXZ+0x4") != std::string::npos);
+    TEST_CHECK(text.find("0x00401234 GAME.EXE+0x1234\n") != std::string::npos);
+    TEST_CHECK(text.find("0x20001420 Vinifera.dll+0x1420 ?Third@@YAXXZ+0x20") != std::string::npos);
+    TEST_CHECK(text.find("0x7FFF0000 <Unknown>") != std::string::npos);
+
+    /**
+     *  Truncated, padded and mislabelled records are rejected.
+     */
+    TEST_CHECK(!Crash_Record_Read(data.data(), (int)data.size() - 1, record));
+    data.push_back(0);
+    TEST_CHECK(!Crash_Record_Read(data.data(), (int)data.size(), record));
+    data.pop_back();
+    data[0] = 'X';
+    TEST_CHECK(!Crash_Record_Read(data.data(), (int)data.size(), record));
+
+    std::vector<uint32_t> too_many(65, 0x20001000);
+    data = Make_Record(too_many);
+    TEST_CHECK(!Crash_Record_Read(data.data(), (int)data.size(), record));
+}
+
+
+int main()
+{
+    Test_Map();
+    Test_Record();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,194 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          DAMAGEFALLOFF_TEST.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Host test for the damage falloff division by reciprocal.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "hosttest.h"
+#include "damagefalloff.h"
+#include <algorithm>
+#include <climits>
+
+
+/**
+ *  The largest distance divisor tested, a warhead spread of over 1000 cells.
+ */
+#define DIVISOR_MAX 4096
+
+/**
+ *  Every damage value below this is tested against every step.
+ */
+#define DAMAGE_EXHAUSTIVE_MAX (1 << 24)
+
+
+/**
+ *  The original calculations.
+ */
+static int Reference_Step(int distance, int divisor)
+{
+    return std::clamp(distance / divisor, 0, DAMAGE_FALLOFF_STEPS);
+}
+
+
+static int Reference_Falloff(int damage, int step)
+{
+    return damage / step;
+}
+
+
+/**
+ *  Checks the reciprocal is exact for the whole 31 bit range.
+ *
+ *  Writing x = q*d + r, (x*m) >> s is q as long as r + x*e/2^s < d, where
+ *  e = m*d - 2^s is the rounding error of the reciprocal. With r at most
+ *  d-1, x*e < 2^s is enough, and as x < 2^31 that holds if e <= 2^(s-31).
+ */
+static bool Reciprocal_Is_Exact(int divisor)
+{
+    DamageReciprocalStruct reciprocal = Make_Reciprocal(divisor);
+
+    if (reciprocal.Shift < 31 || reciprocal.Shift > 62) {
+        return false;
+    }
+
+    uint64_t power = 1ULL << reciprocal.Shift;
+    if (reciprocal.Reciprocal * (uint64_t)divisor < power) {
+        return false;
+    }
+
+    uint64_t error = reciprocal.Reciprocal * (uint64_t)divisor - power;
+    return error <= (1ULL << (reciprocal.Shift - 31));
+}
+
+
+/**
+ *  Every divisor's reciprocal is exact, and the product cannot overflow.
+ */
+static void Test_Reciprocals()
+{
+    for (int divisor = 1; divisor <= DIVISOR_MAX; ++divisor) {
+        TEST_CHECK_PRINT(Reciprocal_Is_Exact(divisor), "divisor %d", divisor);
+
+        DamageReciprocalStruct reciprocal = Make_Reciprocal(divisor);
+        TEST_CHECK_PRINT(reciprocal.Reciprocal <= (1ULL << 33), "divisor %d", divisor);
+    }
+
+    /**
+     *  The largest possible divisor too.
+     */
+    TEST_CHECK(Reciprocal_Is_Exact(INT_MAX));
+}
+
+
+/**
+ *  Compares the falloff step with the original for every divisor and every
+ *  distance up to where the step is clamped. The multiply and shift can only
+ *  grow with the distance, so past 17 times the divisor it stays clamped.
+ */
+static void Test_Falloff_Step()
+{
+    int failures = 0;
+
+    for (int divisor = 1; divisor <= DIVISOR_MAX && failures < 10; ++divisor) {
+        DamageReciprocalStruct reciprocal = Make_Reciprocal(divisor);
+
+        const int last = divisor * (DAMAGE_FALLOFF_STEPS + 1) + 1;
+        for (int distance = -2; distance <= last; ++distance) {
+            int step = Damage_Falloff_Step(distance, divisor, reciprocal);
+            if (step != Reference_Step(distance, divisor)) {
+                TEST_CHECK_PRINT(false, "divisor %d, distance %d, step %d", divisor, distance, step);
+                ++failures;
+                break;
+            }
+        }
+
+        static const int far[] = { 1 << 20, 1 << 30, INT_MAX - 1, INT_MAX, INT_MIN };
+        for (int distance : far) {
+            TEST_CHECK_PRINT(Damage_Falloff_Step(distance, divisor, reciprocal) == Reference_Step(distance, divisor), "divisor %d, distance %d", divisor, distance);
+        }
+    }
+
+    /**
+     *  Negative divisors, from a negative spread, use the plain division.
+     */
+    DamageReciprocalStruct unused = { 0, 0 };
+    for (int divisor = -10; divisor < 0; ++divisor) {
+        for (int distance = -100; distance <= 100; ++distance) {
+            TEST_CHECK(Damage_Falloff_Step(distance, divisor, unused) == Reference_Step(distance, divisor));
+        }
+    }
+}
+
+
+/**
+ *  Compares the damage falloff with the original for every step and every
+ *  damage below 2^24, and for the top of the range.
+ */
+static void Test_Falloff()
+{
+    for (int step = 1; step <= DAMAGE_FALLOFF_STEPS; ++step) {
+
+        int failures = 0;
+
+        for (int damage = -65536; damage < DAMAGE_EXHAUSTIVE_MAX && failures == 0; ++damage) {
+            if (Damage_Falloff(damage, step) != Reference_Falloff(damage, step)) {
+                TEST_CHECK_PRINT(false, "step %d, damage %d", step, damage);
+                ++failures;
+            }
+        }
+
+        for (int damage = INT_MAX; damage > INT_MAX - DAMAGE_EXHAUSTIVE_MAX / 16 && failures == 0; --damage) {
+            if (Damage_Falloff(damage, step) != Reference_Falloff(damage, step)) {
+                TEST_CHECK_PRINT(false, "step %d, damage %d", step, damage);
+                ++failures;
+            }
+        }
+
+        TEST_CHECK(Damage_Falloff(INT_MIN, step) == Reference_Falloff(INT_MIN, step));
+
+        /**
+         *  The quotient only changes at multiples of the step, so sample
+         *  either side of them through the rest of the range. The whole
+         *  range is covered by the proof in Test_Reciprocals.
+         */
+        for (int64_t multiple = (DAMAGE_EXHAUSTIVE_MAX / step) * step; multiple <= INT_MAX && failures == 0; multiple += (int64_t)step * 4099) {
+            int damage = (int)multiple;
+            if (Damage_Falloff(damage, step) != Reference_Falloff(damage, step)
+             || Damage_Falloff(damage - 1, step) != Reference_Falloff(damage - 1, step)) {
+                TEST_CHECK_PRINT(false, "step %d, damage %d", step, damage);
+                ++failures;
+            }
+        }
+    }
+}
+
+
+int main()
+{
+    Test_Reciprocals();
+    Test_Falloff_Step();
+    Test_Falloff();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,231 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          EXCEPTIONDB_TEST.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Host test for the exception database.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "hosttest.h"
+#include "exceptiondb.h"
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+
+static bool Load(ExceptionDatabaseClass &database, const std::string &text)
+{
+    return database.Load(text.data(), (int)text.size());
+}
+
+
+/**
+ *  The lookup on a text database, covering single addresses, ranges, ties and
+ *  the comment and whitespace handling.
+ */
+static void Test_Text()
+{
+    const std::string text =
+        "; A comment line.\r\n"
+        "\r\n"
+        "0x00401000,1,0,Single address, with a comma\r\n"
+        "  0x00402000-0x004020FF,0,1,Range\n"
+        "0x00402010,1,1,Inside the range\n"
+        "0x00402010,0,0,Same start, listed second\n"
+        "0x00500000-0x005FFFFF,0,0,Wide range\n"
+        "0x00401000,0,0,Duplicate of the first\n"
+        "0x00600000,1,0,Range\n";
+
+    ExceptionDatabaseClass database;
+    TEST_CHECK(Load(database, text));
+    TEST_CHECK(database.Count() == 7);
+    TEST_CHECK(database.Description_Count() == 6);
+    TEST_CHECK(database.Max_Range() == 0xFFFFF);
+
+    const ExceptionInfoDatabaseStruct *entry = database.Find(0x00401000);
+    TEST_CHECK(entry && std::strcmp(entry->Description, "Single address, with a comma") == 0);
+    TEST_CHECK(entry && entry->CanContinue && !entry->Ignore);
+
+    TEST_CHECK(database.Find(0x00400FFF) == nullptr);
+    TEST_CHECK(database.Find(0x00401001) == nullptr);
+
+    entry = database.Find(0x00402000);
+    TEST_CHECK(entry && std::strcmp(entry->Description, "Range") == 0 && entry->Ignore);
+
+    entry = database.Find(0x00402010);
+    TEST_CHECK(entry && std::strcmp(entry->Description, "Inside the range") == 0);
+
+    /**
+     *  Past the single address at 0x00402010, the enclosing range applies.
+     */
+    entry = database.Find(0x00402011);
+    TEST_CHECK(entry && std::strcmp(entry->Description, "Range") == 0);
+    TEST_CHECK(database.Find(0x00402100) == nullptr);
+
+    entry = database.Find(0x005ABCDE);
+    TEST_CHECK(entry && std::strcmp(entry->Description, "Wide range") == 0);
+
+    /**
+     *  Interned descriptions share the same storage.
+     */
+    TEST_CHECK(database.Find(0x00600000)->Description == database.Find(0x00402000)->Description);
+}
+
+
+/**
+ *  A failed load must leave the database empty, even when it held a valid
+ *  database before.
+ */
+static void Test_Failures()
+{
+    static const char *const bad[] = {
+        "",
+        "; Only a comment.\n",
+        "401000,0,0,Missing the prefix\n",
+        "0x00401000,0,0,Fine\n0x00402000-401000,0,0,Bad range prefix\n",
+        "0x00401000,0,0,Fine\n0x00402000-0x00401000,0,0,Reversed range\n",
+    };
+
+    for (const char *text : bad) {
+        ExceptionDatabaseClass database;
+        TEST_CHECK(Load(database, "0x00401000,0,0,Valid\n"));
+        TEST_CHECK(!Load(database, text));
+        TEST_CHECK_PRINT(database.Count() == 0 && database.Max_Range() == 0 && database.Find(0x00401000) == nullptr, "\"%s\"", text);
+    }
+
+    /**
+     *  Lines missing fields are skipped.
+     */
+    ExceptionDatabaseClass database;
+    TEST_CHECK(Load(database, "0x00401000,0\n0x00402000,0,0,Fine\n"));
+    TEST_CHECK(database.Count() == 1 && database.Find(0x00401000) == nullptr);
+}
+
+
+/**
+ *  The compiled form must load to the same table, and any truncation or
+ *  corruption must be rejected.
+ */
+static void Test_Compiled()
+{
+    std::mt19937 random(0x5EED);
+
+    std::string text;
+    for (int index = 0; index < 500; ++index) {
+        char line[128];
+        uint32_t address = 0x00400000 + (uint32_t)(random() % 0x200000);
+        if (random() % 4 == 0) {
+            std::snprintf(line, sizeof(line), "0x%08X-0x%08X,%d,%d,Description %d\n", address, address + (uint32_t)(random() % 0x100),
+                (int)(random() % 2), (int)(random() % 2), (int)(random() % 50));
+        } else {
+            std::snprintf(line, sizeof(line), "0x%08X,%d,%d,Description %d\n", address,
+                (int)(random() % 2), (int)(random() % 2), (int)(random() % 50));
+        }
+        text += line;
+    }
+
+    ExceptionDatabaseClass database;
+    TEST_CHECK(Load(database, text));
+
+    std::vector<unsigned char> compiled;
+    database.Save_Compiled(compiled);
+    TEST_CHECK(ExceptionDatabaseClass::Is_Compiled(compiled.data(), (int)compiled.size()));
+
+    ExceptionDatabaseClass loaded;
+    TEST_CHECK(loaded.Load(compiled.data(), (int)compiled.size()));
+    TEST_CHECK(loaded.Count() == database.Count());
+    TEST_CHECK(loaded.Max_Range() == database.Max_Range());
+    TEST_CHECK(loaded.Description_Count() == database.Description_Count());
+
+    for (int index = 0; index < database.Count() && index < loaded.Count(); ++index) {
+        TEST_CHECK(loaded[index].Address == database[index].Address);
+        TEST_CHECK(loaded[index].EndAddress == database[index].EndAddress);
+        TEST_CHECK(loaded[index].CanContinue == database[index].CanContinue);
+        TEST_CHECK(loaded[index].Ignore == database[index].Ignore);
+        TEST_CHECK(std::strcmp(loaded[index].Description, database[index].Description) == 0);
+    }
+
+    /**
+     *  Every lookup must give the same answer from both forms.
+     */
+    for (uint32_t address = 0x003FFF00; address < 0x00600200; address += 7) {
+        const ExceptionInfoDatabaseStruct *a = database.Find(address);
+        const ExceptionInfoDatabaseStruct *b = loaded.Find(address);
+        TEST_CHECK_PRINT((a == nullptr) == (b == nullptr), "address 0x%08X", address);
+        if (a && b) {
+            TEST_CHECK_PRINT(a->Address == b->Address && std::strcmp(a->Description, b->Description) == 0, "address 0x%08X", address);
+        }
+    }
+
+    /**
+     *  Truncated data is rejected.
+     */
+    for (int length : { 0, 4, 19, 20, 36, (int)compiled.size() - 1 }) {
+        ExceptionDatabaseClass truncated;
+        TEST_CHECK_PRINT(!truncated.Load_Compiled(compiled.data(), length), "length %d", length);
+        TEST_CHECK(truncated.Count() == 0);
+    }
+
+    /**
+     *  So is a description offset past the pool, an out of order entry, a
+     *  reversed range and an unterminated pool.
+     */
+    const int entries = 20;
+    const int entry_size = 16;
+
+    std::vector<unsigned char> corrupt = compiled;
+    corrupt[entries + 12] = 0xFF;
+    corrupt[entries + 13] = 0xFF;
+    ExceptionDatabaseClass rejected;
+    TEST_CHECK(!rejected.Load_Compiled(corrupt.data(), (int)corrupt.size()));
+    TEST_CHECK(rejected.Count() == 0);
+
+    corrupt = compiled;
+    std::memcpy(&corrupt[entries + entry_size], &compiled[entries + 2 * entry_size], 4);
+    std::memcpy(&corrupt[entries + 2 * entry_size], &compiled[entries + entry_size], 4);
+    if (std::memcmp(&compiled[entries + entry_size], &compiled[entries + 2 * entry_size], 4) != 0) {
+        TEST_CHECK(!rejected.Load_Compiled(corrupt.data(), (int)corrupt.size()));
+    }
+
+    corrupt = compiled;
+    corrupt[entries + 4] = 0;
+    corrupt[entries + 5] = 0;
+    corrupt[entries + 6] = 0;
+    corrupt[entries + 7] = 0;
+    TEST_CHECK(!rejected.Load_Compiled(corrupt.data(), (int)corrupt.size()));
+
+    corrupt = compiled;
+    corrupt.back() = 'x';
+    TEST_CHECK(!rejected.Load_Compiled(corrupt.data(), (int)corrupt.size()));
+    TEST_CHECK(rejected.Count() == 0);
+}
+
+
+int main()
+{
+    Test_Text();
+    Test_Failures();
+    Test_Compiled();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,136 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          FRAMEPACER_TEST.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Host test for the frame pacer.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "hosttest.h"
+#include "framepacer.h"
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+
+typedef std::chrono::steady_clock ClockType;
+
+
+static double Seconds(ClockType::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+
+static double CPU_Seconds()
+{
+    return double(std::clock()) / CLOCKS_PER_SEC;
+}
+
+
+/**
+ *  Paces two seconds of frames at the rate, with a little work in each frame,
+ *  and checks the frame rate, the frame intervals and the time spent spinning.
+ */
+static void Test_Frame_Rate(int frame_rate)
+{
+    const int frames = frame_rate * 2;
+    const double period = 1000.0 / frame_rate;
+
+    Frame_Pacer_Reset();
+    Frame_Pacer_Wait(frame_rate);
+    Frame_Pacer_Mark_Frame();
+
+    ClockType::time_point start = ClockType::now();
+    double cpu_start = CPU_Seconds();
+
+    for (int frame = 0; frame < frames; ++frame) {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        Frame_Pacer_Wait(frame_rate);
+        Frame_Pacer_Mark_Frame();
+    }
+
+    double elapsed = Seconds(ClockType::now() - start);
+    double cpu = CPU_Seconds() - cpu_start;
+
+    double rate = frames / elapsed;
+    float median = Frame_Pacer_Percentile(50.0f);
+    float p95 = Frame_Pacer_Percentile(95.0f);
+
+    std::printf("%d FPS: %.2f FPS, median %.2f ms, 95%% %.2f ms, %.0f%% CPU, overshoot estimate %.2f ms.\n",
+        frame_rate, rate, median, p95, cpu / elapsed * 100.0, Frame_Pacer_Sleep_Overshoot());
+
+    /**
+     *  The schedule keeps the average rate exact unless frames are missed.
+     */
+    TEST_CHECK_PRINT(rate > frame_rate * 0.95 && rate < frame_rate * 1.02, "%d FPS: %.2f", frame_rate, rate);
+    TEST_CHECK_PRINT(median > period * 0.9 && median < period * 1.1, "%d FPS: median %.2f ms", frame_rate, median);
+
+    /**
+     *  At most half of each frame may be spun.
+     */
+    TEST_CHECK_PRINT(Frame_Pacer_Sleep_Overshoot() <= period / 2.0, "%d FPS: %.2f ms", frame_rate, Frame_Pacer_Sleep_Overshoot());
+    TEST_CHECK_PRINT(cpu < elapsed * 0.75, "%d FPS: %.0f%% CPU", frame_rate, cpu / elapsed * 100.0);
+}
+
+
+/**
+ *  A stall in one frame must not leave the pacer spinning afterwards.
+ */
+static void Test_Stall()
+{
+    const int frame_rate = 60;
+
+    Frame_Pacer_Reset();
+
+    for (int frame = 0; frame < 30; ++frame) {
+        Frame_Pacer_Wait(frame_rate);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    double cpu_start = CPU_Seconds();
+    ClockType::time_point start = ClockType::now();
+
+    for (int frame = 0; frame < 60; ++frame) {
+        Frame_Pacer_Wait(frame_rate);
+    }
+
+    double elapsed = Seconds(ClockType::now() - start);
+    double cpu = CPU_Seconds() - cpu_start;
+
+    TEST_CHECK_PRINT(Frame_Pacer_Sleep_Overshoot() <= 1000.0 / frame_rate / 2.0, "%.2f ms", Frame_Pacer_Sleep_Overshoot());
+    TEST_CHECK_PRINT(cpu < elapsed * 0.75, "%.0f%% CPU", cpu / elapsed * 100.0);
+}
+
+
+int main()
+{
+    Test_Frame_Rate(30);
+    Test_Frame_Rate(60);
+    Test_Frame_Rate(144);
+    Test_Stall();
+
+    Frame_Pacer_Shutdown();
+
+    return TEST_RESULT();
+}
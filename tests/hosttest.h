@@ -0,0 +1,64 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          HOSTTEST.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Minimal check macros shared by the host tests.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include <cstdio>
+
+
+/**
+ *  The number of failed checks, each test returns non-zero if any failed.
+ */
+static int TestFailures = 0;
+
+
+/**
+ *  Records a failure if the expression is false. The optional message is
+ *  printed along with the expression.
+ */
+#define TEST_CHECK(exp) \
+    do { \
+        if (!(exp)) { \
+            std::fprintf(stderr, "%s(%d): check failed: %s\n", __FILE__, __LINE__, #exp); \
+            ++TestFailures; \
+        } \
+    } while (false)
+
+#define TEST_CHECK_PRINT(exp, msg, ...) \
+    do { \
+        if (!(exp)) { \
+            std::fprintf(stderr, "%s(%d): check failed: %s: " msg "\n", __FILE__, __LINE__, #exp, ##__VA_ARGS__); \
+            ++TestFailures; \
+        } \
+    } while (false)
+
+
+/**
+ *  Returns the process exit code for the test.
+ */
+#define TEST_RESULT() \
+    (TestFailures == 0 ? (std::printf("All checks passed.\n"), 0) : (std::printf("%d check(s) failed.\n", TestFailures), 1))
@@ -0,0 +1,296 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          SHA_TEST.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Host test and benchmark for the Secure Hash Algorithm.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "hosttest.h"
+#include "sha.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+
+/**
+ *  A plain, one block at a time SHA-1, used as the reference the engine's
+ *  scalar, SHA extension and multi-stream paths must all match.
+ */
+static void Reference_SHA(const unsigned char *data, size_t length, unsigned char *digest)
+{
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+    std::vector<unsigned char> message(data, data + length);
+    message.push_back(0x80);
+    while ((message.size() % 64) != 56) {
+        message.push_back(0);
+    }
+    uint64_t bits = (uint64_t)length * 8;
+    for (int index = 7; index >= 0; --index) {
+        message.push_back((unsigned char)(bits >> (index * 8)));
+    }
+
+    for (size_t block = 0; block < message.size(); block += 64) {
+        uint32_t w[80];
+        for (int index = 0; index < 16; ++index) {
+            const unsigned char *p = &message[block + index * 4];
+            w[index] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+        }
+        for (int index = 16; index < 80; ++index) {
+            uint32_t x = w[index-3] ^ w[index-8] ^ w[index-14] ^ w[index-16];
+            w[index] = (x << 1) | (x >> 31);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int index = 0; index < 80; ++index) {
+            uint32_t f;
+            uint32_t k;
+            if (index < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+            else if (index < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+            else if (index < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+            uint32_t temp = ((a << 5) | (a >> 27)) + f + e + k + w[index];
+            e = d;
+            d = c;
+            c = (b << 30) | (b >> 2);
+            b = a;
+            a = temp;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    for (int index = 0; index < 5; ++index) {
+        digest[index*4+0] = (unsigned char)(h[index] >> 24);
+        digest[index*4+1] = (unsigned char)(h[index] >> 16);
+        digest[index*4+2] = (unsigned char)(h[index] >> 8);
+        digest[index*4+3] = (unsigned char)(h[index]);
+    }
+}
+
+
+static std::string To_Hex(const unsigned char *digest)
+{
+    char buffer[41];
+    for (int index = 0; index < 20; ++index) {
+        std::snprintf(&buffer[index*2], 3, "%02x", digest[index]);
+    }
+    return buffer;
+}
+
+
+/**
+ *  The FIPS 180 example messages.
+ */
+static void Test_Vectors()
+{
+    static const struct {
+        const char *message;
+        const char *digest;
+    } vectors[] = {
+        { "", "da39a3ee5e6b4b0d3255bfef95601890afd80709" },
+        { "abc", "a9993e364706816aba3e25717850c26c9cd0d89d" },
+        { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", "84983e441c3bd26ebaae4aa1f95129e5e54670f1" },
+    };
+
+    for (const auto &vector : vectors) {
+        SHA sha;
+        sha.Hash(vector.message, (long)std::strlen(vector.message));
+        unsigned char digest[20];
+        TEST_CHECK(sha.Result(digest) == 20);
+        TEST_CHECK_PRINT(To_Hex(digest) == vector.digest, "\"%s\" gave %s", vector.message, To_Hex(digest).c_str());
+    }
+
+    /**
+     *  One million 'a', fed in uneven pieces.
+     */
+    std::vector<unsigned char> million(1000000, 'a');
+    SHA sha;
+    for (size_t offset = 0; offset < million.size(); ) {
+        long piece = std::min((long)(million.size() - offset), 4093L);
+        sha.Hash(&million[offset], piece);
+        offset += piece;
+    }
+    unsigned char digest[20];
+    sha.Result(digest);
+    TEST_CHECK_PRINT(To_Hex(digest) == "34aa973cd4c4daa4f61eeb2bdbad27316534016f", "million 'a' gave %s", To_Hex(digest).c_str());
+}
+
+
+/**
+ *  Compares the engine with the reference over every length around the
+ *  padding boundaries and random lengths, whole and in random pieces.
+ */
+static void Test_Against_Reference(const char *path)
+{
+    std::mt19937 random(0x5EED);
+
+    std::vector<size_t> lengths;
+    for (size_t length = 0; length <= 200; ++length) {
+        lengths.push_back(length);
+    }
+    for (int index = 0; index < 200; ++index) {
+        lengths.push_back(random() % 20000);
+    }
+
+    for (size_t length : lengths) {
+        std::vector<unsigned char> data(length + 1);
+        for (unsigned char &c : data) c = (unsigned char)random();
+
+        unsigned char expected[20];
+        Reference_SHA(data.data(), length, expected);
+
+        SHA whole;
+        whole.Hash(data.data(), (long)length);
+        unsigned char actual[20];
+        whole.Result(actual);
+        TEST_CHECK_PRINT(std::memcmp(actual, expected, 20) == 0, "%s whole length %zu", path, length);
+
+        SHA pieces;
+        for (size_t offset = 0; offset < length; ) {
+            size_t piece = std::min(length - offset, (size_t)(1 + random() % 300));
+            pieces.Hash(&data[offset], (long)piece);
+            offset += piece;
+        }
+        pieces.Result(actual);
+        TEST_CHECK_PRINT(std::memcmp(actual, expected, 20) == 0, "%s pieces length %zu", path, length);
+    }
+}
+
+
+/**
+ *  Hashes groups of streams with differing lengths and starting partial
+ *  blocks through Hash_Streams, and checks each against the reference.
+ */
+static void Test_Streams(const char *path)
+{
+    std::mt19937 random(0xC0FFEE);
+
+    for (int iteration = 0; iteration < 300; ++iteration) {
+        const int count = 1 + (int)(random() % 9);
+
+        std::vector<std::vector<unsigned char>> data(count);
+        std::vector<SHA> sha(count);
+        std::vector<size_t> split(count);
+
+        for (int index = 0; index < count; ++index) {
+            data[index].resize(random() % 5000);
+            for (unsigned char &c : data[index]) c = (unsigned char)random();
+            split[index] = data[index].empty() ? 0 : random() % data[index].size();
+
+            /**
+             *  Leave some streams part way through a block.
+             */
+            sha[index].Hash(data[index].data(), (long)split[index]);
+        }
+
+        /**
+         *  Feed the rest in two rounds of Hash_Streams.
+         */
+        for (int pass = 0; pass < 2; ++pass) {
+            std::vector<SHA *> streams(count);
+            std::vector<const void *> pointers(count);
+            std::vector<long> lengths(count);
+            for (int index = 0; index < count; ++index) {
+                size_t remaining = data[index].size() - split[index];
+                size_t piece = pass == 0 ? remaining / 2 + (remaining ? random() % (remaining / 2 + 1) : 0) : remaining;
+                piece = std::min(piece, remaining);
+                streams[index] = &sha[index];
+                pointers[index] = data[index].data() + split[index];
+                lengths[index] = (long)piece;
+                split[index] += piece;
+            }
+            SHA::Hash_Streams(streams.data(), pointers.data(), lengths.data(), count);
+        }
+
+        for (int index = 0; index < count; ++index) {
+            unsigned char expected[20];
+            unsigned char actual[20];
+            Reference_SHA(data[index].data(), data[index].size(), expected);
+            sha[index].Result(actual);
+            TEST_CHECK_PRINT(std::memcmp(actual, expected, 20) == 0, "%s stream %d of %d length %zu", path, index, count, data[index].size());
+        }
+    }
+}
+
+
+/**
+ *  Prints the throughput of the single stream and multi-stream paths. This is
+ *  informational only, the timings are not checked.
+ */
+static void Benchmark(const char *path)
+{
+    const size_t size = 16 * 1024 * 1024;
+    std::vector<unsigned char> data(size * 4);
+    for (size_t index = 0; index < data.size(); ++index) {
+        data[index] = (unsigned char)(index * 31);
+    }
+
+    unsigned char digest[20];
+
+    auto start = std::chrono::steady_clock::now();
+    for (int index = 0; index < 4; ++index) {
+        SHA sha;
+        sha.Hash(&data[index * size], (long)size);
+        sha.Result(digest);
+    }
+    double single = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    SHA sha[4];
+    SHA *streams[4] = { &sha[0], &sha[1], &sha[2], &sha[3] };
+    const void *pointers[4] = { &data[0], &data[size], &data[size*2], &data[size*3] };
+    long lengths[4] = { (long)size, (long)size, (long)size, (long)size };
+    SHA::Hash_Streams(streams, pointers, lengths, 4);
+    for (int index = 0; index < 4; ++index) {
+        sha[index].Result(digest);
+    }
+    double multi = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double megabytes = (size * 4) / (1024.0 * 1024.0);
+    std::printf("%s: one stream at a time %.0f MB/s, four streams %.0f MB/s.\n", path, megabytes / single, megabytes / multi);
+}
+
+
+int main()
+{
+    /**
+     *  Run everything with the SHA extensions (if the processor has them)
+     *  and then with the scalar and multi-stream code.
+     */
+    SHA::Set_Extensions_Enabled(true);
+    Test_Vectors();
+    Test_Against_Reference("extensions");
+    Test_Streams("extensions");
+    Benchmark("extensions");
+
+    SHA::Set_Extensions_Enabled(false);
+    Test_Vectors();
+    Test_Against_Reference("scalar");
+    Test_Streams("scalar");
+    Benchmark("scalar");
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,328 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          SHAPEEXPAND_TEST.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Host test for the shape frame expansion.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "hosttest.h"
+#include "shapeexpand.h"
+#include <cstring>
+#include <random>
+#include <vector>
+
+
+typedef std::vector<unsigned char> BufferType;
+
+
+/**
+ *  A frame as it should look once drawn, zero is transparent.
+ */
+struct TestFrameStruct
+{
+    int Width;
+    int Height;
+    unsigned Flags;
+    bool Empty;
+    BufferType Pixels;
+};
+
+
+/**
+ *  Encodes a line the way the shape tools do: the line length, then the
+ *  pixels, with runs of transparent pixels as a zero and the run length when
+ *  the frame is transparent.
+ */
+static void Encode_Line(const unsigned char *pixels, int width, bool transparent, BufferType &output)
+{
+    BufferType line(2);
+
+    for (int x = 0; x < width; ) {
+        if (transparent && pixels[x] == 0) {
+            int run = 0;
+            while (x < width && pixels[x] == 0 && run < 255) {
+                ++run;
+                ++x;
+            }
+            line.push_back(0);
+            line.push_back((unsigned char)run);
+        } else {
+            line.push_back(pixels[x++]);
+        }
+    }
+
+    line[0] = (unsigned char)line.size();
+    line[1] = (unsigned char)(line.size() >> 8);
+
+    output.insert(output.end(), line.begin(), line.end());
+}
+
+
+static BufferType Build_Shape(const std::vector<TestFrameStruct> &frames)
+{
+    BufferType shape(sizeof(ShapeExpandHeaderStruct) + frames.size() * sizeof(ShapeExpandFrameStruct));
+
+    ShapeExpandHeaderStruct header = { 0, 60, 30, (unsigned short)frames.size() };
+    std::memcpy(&shape[0], &header, sizeof(header));
+
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const TestFrameStruct &frame = frames[i];
+
+        ShapeExpandFrameStruct info;
+        std::memset(&info, 0, sizeof(info));
+        info.Width = (unsigned short)frame.Width;
+        info.Height = (unsigned short)frame.Height;
+        info.Flags = frame.Flags;
+        info.Offset = frame.Empty ? 0 : (unsigned int)shape.size();
+
+        if (!frame.Empty) {
+            if (frame.Flags & SHAPE_FRAME_COMPRESSED) {
+                for (int y = 0; y < frame.Height; ++y) {
+                    Encode_Line(&frame.Pixels[y * frame.Width], frame.Width, (frame.Flags & SHAPE_FRAME_TRANSPARENT) != 0, shape);
+                }
+            } else {
+                shape.insert(shape.end(), frame.Pixels.begin(), frame.Pixels.end());
+            }
+        }
+
+        std::memcpy(&shape[sizeof(ShapeExpandHeaderStruct) + i * sizeof(ShapeExpandFrameStruct)], &info, sizeof(info));
+    }
+
+    return shape;
+}
+
+
+static TestFrameStruct Make_Frame(std::mt19937 &random, int width, int height, unsigned flags)
+{
+    TestFrameStruct frame;
+    frame.Width = width;
+    frame.Height = height;
+    frame.Flags = flags;
+    frame.Empty = false;
+    frame.Pixels.resize(width * height);
+
+    /**
+     *  Runs of transparent pixels of all lengths, some longer than a run can
+     *  encode, between solid pixels.
+     */
+    for (int i = 0; i < width * height; ) {
+        int run = 1 + (int)(random() % 300);
+        bool clear = (flags & SHAPE_FRAME_TRANSPARENT) && (random() % 2);
+        for (; run > 0 && i < width * height; --run, ++i) {
+            frame.Pixels[i] = clear ? 0 : (unsigned char)(1 + random() % 255);
+        }
+    }
+
+    return frame;
+}
+
+
+/**
+ *  Checks every pixel of every expanded frame, and that the headers of the
+ *  expanded shape describe raw frames within it.
+ */
+static bool Check_Expanded(const BufferType &expanded, const std::vector<TestFrameStruct> &frames)
+{
+    if (expanded.size() < sizeof(ShapeExpandHeaderStruct)) {
+        return false;
+    }
+
+    const ShapeExpandHeaderStruct *header = (const ShapeExpandHeaderStruct *)&expanded[0];
+    if (header->FrameCount != frames.size()) {
+        return false;
+    }
+
+    const ShapeExpandFrameStruct *infos = (const ShapeExpandFrameStruct *)&expanded[sizeof(ShapeExpandHeaderStruct)];
+
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const TestFrameStruct &frame = frames[i];
+        const ShapeExpandFrameStruct &info = infos[i];
+
+        if (info.Width != frame.Width || info.Height != frame.Height) {
+            return false;
+        }
+
+        /**
+         *  Frames without data keep their flags, as nothing is drawn for them.
+         */
+        if (frame.Empty) {
+            if (info.Offset != 0) {
+                return false;
+            }
+            continue;
+        }
+
+        if (info.Flags & SHAPE_FRAME_COMPRESSED) {
+            return false;
+        }
+
+        if (info.Offset + frame.Pixels.size() > expanded.size()) {
+            return false;
+        }
+
+        for (int y = 0; y < frame.Height; ++y) {
+            for (int x = 0; x < frame.Width; ++x) {
+                if (expanded[info.Offset + y * frame.Width + x] != frame.Pixels[y * frame.Width + x]) {
+                    std::fprintf(stderr, "Frame %d pixel %d,%d differs.\n", (int)i, x, y);
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ *  Shapes of every kind of frame expand to the same pixels.
+ */
+static void Test_Expand()
+{
+    std::mt19937 random(3);
+
+    for (int test = 0; test < 200; ++test) {
+        std::vector<TestFrameStruct> frames;
+
+        int count = 1 + (int)(random() % 8);
+        for (int i = 0; i < count; ++i) {
+            static const unsigned flag_choices[] = {
+                SHAPE_FRAME_COMPRESSED|SHAPE_FRAME_TRANSPARENT,
+                SHAPE_FRAME_COMPRESSED,
+                SHAPE_FRAME_TRANSPARENT,
+                0
+            };
+            unsigned flags = flag_choices[random() % 4];
+            int width = 1 + (int)(random() % 600);
+            int height = 1 + (int)(random() % 40);
+
+            TestFrameStruct frame = Make_Frame(random, width, height, flags);
+            frame.Empty = (random() % 10) == 0;
+            frames.push_back(frame);
+        }
+
+        /**
+         *  At least one frame must be compressed for the shape to expand.
+         */
+        frames[0] = Make_Frame(random, 1 + (int)(random() % 100), 1 + (int)(random() % 30), SHAPE_FRAME_COMPRESSED|SHAPE_FRAME_TRANSPARENT);
+
+        BufferType shape = Build_Shape(frames);
+        BufferType expanded;
+        TEST_CHECK_PRINT(Shape_Expand(shape.data(), shape.size(), expanded), "shape %d", test);
+        TEST_CHECK_PRINT(Check_Expanded(expanded, frames), "shape %d", test);
+    }
+
+    /**
+     *  A shape with no compressed frames is used as it is.
+     */
+    std::vector<TestFrameStruct> frames;
+    frames.push_back(Make_Frame(random, 20, 20, SHAPE_FRAME_TRANSPARENT));
+    BufferType shape = Build_Shape(frames);
+    BufferType expanded;
+    TEST_CHECK(!Shape_Expand(shape.data(), shape.size(), expanded));
+    TEST_CHECK(expanded.empty());
+}
+
+
+/**
+ *  A shape cut short anywhere, or with its offsets and line lengths pointing
+ *  outside the entry, is rejected rather than read past its end. The data is
+ *  copied to a buffer of exactly the entry size so the address sanitizer, when
+ *  available, catches any read past it.
+ */
+static void Test_Malformed()
+{
+    std::mt19937 random(5);
+
+    std::vector<TestFrameStruct> frames;
+    frames.push_back(Make_Frame(random, 48, 24, SHAPE_FRAME_COMPRESSED|SHAPE_FRAME_TRANSPARENT));
+    frames.push_back(Make_Frame(random, 30, 10, 0));
+    frames.push_back(Make_Frame(random, 48, 24, SHAPE_FRAME_COMPRESSED));
+
+    const BufferType shape = Build_Shape(frames);
+
+    for (size_t length = 0; length < shape.size(); ++length) {
+        unsigned char *data = new unsigned char [length + 1];
+        std::memcpy(data, shape.data(), length);
+
+        BufferType expanded;
+        TEST_CHECK_PRINT(!Shape_Expand(data, length, expanded), "cut to %d of %d bytes", (int)length, (int)shape.size());
+        TEST_CHECK(expanded.empty());
+
+        delete [] data;
+    }
+
+    /**
+     *  Corrupt each byte of the headers and the first lines in turn. The
+     *  result must either be rejected or be a shape whose raw frames lie
+     *  within the expanded data.
+     */
+    for (size_t index = 0; index < 256 && index < shape.size(); ++index) {
+        for (int value : { 0x00, 0x01, 0x7F, 0xFF }) {
+            BufferType corrupt = shape;
+            corrupt[index] = (unsigned char)value;
+
+            unsigned char *data = new unsigned char [corrupt.size()];
+            std::memcpy(data, corrupt.data(), corrupt.size());
+
+            BufferType expanded;
+            if (Shape_Expand(data, corrupt.size(), expanded)) {
+                const ShapeExpandHeaderStruct *header = (const ShapeExpandHeaderStruct *)&expanded[0];
+                const ShapeExpandFrameStruct *infos = (const ShapeExpandFrameStruct *)&expanded[sizeof(ShapeExpandHeaderStruct)];
+                for (int i = 0; i < header->FrameCount; ++i) {
+                    TEST_CHECK(!(infos[i].Flags & SHAPE_FRAME_COMPRESSED) || !infos[i].Offset);
+                    TEST_CHECK(!infos[i].Offset || infos[i].Offset + (size_t)infos[i].Width * infos[i].Height <= expanded.size());
+                }
+            } else {
+                TEST_CHECK(expanded.empty());
+            }
+
+            delete [] data;
+        }
+    }
+
+    /**
+     *  A frame offset past the end, and a raw frame running past the end.
+     */
+    BufferType corrupt = shape;
+    ShapeExpandFrameStruct *infos = (ShapeExpandFrameStruct *)&corrupt[sizeof(ShapeExpandHeaderStruct)];
+    infos[0].Offset = (unsigned int)corrupt.size();
+    BufferType expanded;
+    TEST_CHECK(!Shape_Expand(corrupt.data(), corrupt.size(), expanded));
+
+    corrupt = shape;
+    infos = (ShapeExpandFrameStruct *)&corrupt[sizeof(ShapeExpandHeaderStruct)];
+    infos[1].Height = 1000;
+    TEST_CHECK(!Shape_Expand(corrupt.data(), corrupt.size(), expanded));
+
+    TEST_CHECK(!Shape_Expand(nullptr, 100, expanded));
+}
+
+
+int main()
+{
+    Test_Expand();
+    Test_Malformed();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          ALWAYS.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Host stand-in for the base header, used by the host tests.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include <inttypes.h>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+
+#ifndef PATH_MAX
+#define PATH_MAX 260
+#endif
+
+#ifndef _MAX_PATH
+#define _MAX_PATH PATH_MAX
+#endif
+
+#ifndef MAX_PATH
+#define MAX_PATH PATH_MAX
+#endif
+
+
+#ifndef ARRAY_SIZE
+#define ARRAY_SIZE(x) int(sizeof(x) / sizeof(x[0]))
+#endif
+
+
+#if __cplusplus < 201703L
+#include <functional>
+
+namespace std
+{
+    template<class T, class Compare>
+    constexpr const T &clamp(const T &v, const T &lo, const T &hi, Compare comp)
+    {
+        return comp(v, lo) ? lo : comp(hi, v) ? hi : v;
+    }
+
+    template<class T>
+    constexpr const T &clamp(const T &v, const T &lo, const T &hi)
+    {
+        return clamp(v, lo, hi, std::less<T>());
+    }
+}
+#endif
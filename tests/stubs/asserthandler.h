@@ -0,0 +1,53 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          ASSERTHANDLER.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Host stand-in for the assertion handler, used by the host
+ *                 tests. A failed assertion aborts the test.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+#include <cstdio>
+#include <cstdlib>
+
+
+#define ASSERT(exp) \
+    do { \
+        if (!(exp)) { \
+            std::fprintf(stderr, "%s(%d): ASSERT(%s) failed\n", __FILE__, __LINE__, #exp); \
+            std::abort(); \
+        } \
+    } while (false)
+
+#define ASSERT_PRINT(exp, msg, ...) \
+    do { \
+        if (!(exp)) { \
+            std::fprintf(stderr, "%s(%d): ASSERT(%s) failed: " msg "\n", __FILE__, __LINE__, #exp, ##__VA_ARGS__); \
+            std::abort(); \
+        } \
+    } while (false)
+
+#define ASSERT_FATAL(exp, ...) ASSERT(exp)
+#define ASSERT_FATAL_PRINT(exp, msg, ...) ASSERT_PRINT(exp, msg, ##__VA_ARGS__)
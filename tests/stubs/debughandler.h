@@ -0,0 +1,40 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          DEBUGHANDLER.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Host stand-in for the debug printing functions, used by the
+ *                 host tests. All output goes to stderr.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+#include <cstdio>
+
+
+#define DEBUG_SAY(x, ...) std::fprintf(stderr, x, ##__VA_ARGS__)
+#define DEBUG_INFO(x, ...) std::fprintf(stderr, x, ##__VA_ARGS__)
+#define DEBUG_WARNING(x, ...) std::fprintf(stderr, x, ##__VA_ARGS__)
+#define DEBUG_ERROR(x, ...) std::fprintf(stderr, x, ##__VA_ARGS__)
+#define DEBUG_FATAL(x, ...) std::fprintf(stderr, x, ##__VA_ARGS__)
+#define DEBUG_TRACE(x, ...) ((void)0)
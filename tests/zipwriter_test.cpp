@@ -0,0 +1,540 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          ZIPWRITER_TEST.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Host test for the deflater and the zip writer.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "hosttest.h"
+#include "deflater.h"
+#include "zipwriter.h"
+#include "lodepng.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+
+/**
+ *  The size of the synthetic mini dump, the size of a full memory dump of the
+ *  game late in a large match.
+ */
+#define DUMP_SIZE (200*1024*1024)
+
+
+typedef std::vector<unsigned char> BufferType;
+
+
+static bool Append_Output(void *param, const void *data, int length)
+{
+    BufferType *buffer = (BufferType *)param;
+    buffer->insert(buffer->end(), (const unsigned char *)data, (const unsigned char *)data + length);
+    return true;
+}
+
+
+static bool Inflate(const BufferType &compressed, BufferType &output)
+{
+    unsigned char *data = nullptr;
+    size_t size = 0;
+
+    unsigned error = lodepng_inflate(&data, &size, compressed.data(), compressed.size(), &lodepng_default_decompress_settings);
+    if (error == 0) {
+        output.assign(data, data + size);
+    }
+    std::free(data);
+
+    return error == 0;
+}
+
+
+/**
+ *  Deflates the data, feeding it in pieces of the given size.
+ */
+static BufferType Deflate(const BufferType &data, int piece)
+{
+    BufferType output;
+    DeflaterClass *deflater = new DeflaterClass(Append_Output, &output);
+
+    for (size_t offset = 0; offset < data.size(); offset += piece) {
+        int length = (int)std::min<size_t>(piece, data.size() - offset);
+        TEST_CHECK(deflater->Write(&data[offset], length));
+    }
+    TEST_CHECK(deflater->Finish());
+
+    delete deflater;
+
+    return output;
+}
+
+
+/**
+ *  Fills a buffer with data that looks like part of a memory dump: runs of
+ *  zeroes, repeated code and structures, small integers and some noise.
+ */
+static void Fill_Dump(unsigned char *buffer, int size, std::mt19937 &random)
+{
+    int offset = 0;
+    while (offset < size) {
+        int length = std::min(size - offset, 256 + (int)(random() % 8192));
+
+        switch (random() % 5) {
+            case 0:
+                std::memset(&buffer[offset], 0, length);
+                break;
+
+            case 1:
+            {
+                static const unsigned char code[] = { 0x55, 0x8B, 0xEC, 0x83, 0xEC, 0x10, 0x53, 0x56, 0x57, 0x8B, 0xF1, 0xE8, 0x00, 0x10, 0x40, 0x00 };
+                for (int i = 0; i < length; ++i) {
+                    buffer[offset + i] = code[(i + (offset & 7)) % sizeof(code)];
+                }
+                break;
+            }
+
+            case 2:
+                for (int i = 0; i < length; ++i) {
+                    buffer[offset + i] = (i & 3) == 0 ? (unsigned char)(random() % 16) : 0;
+                }
+                break;
+
+            case 3:
+            {
+                /**
+                 *  Copies of earlier data, like duplicated heap objects.
+                 */
+                int distance = 1 + (int)(random() % 30000);
+                for (int i = 0; i < length; ++i) {
+                    int source = offset + i - distance;
+                    buffer[offset + i] = source >= 0 ? buffer[source] : (unsigned char)i;
+                }
+                break;
+            }
+
+            default:
+                for (int i = 0; i < length; ++i) {
+                    buffer[offset + i] = (unsigned char)random();
+                }
+                break;
+        }
+
+        offset += length;
+    }
+}
+
+
+static BufferType Make_Dump(int size, unsigned seed)
+{
+    std::mt19937 random(seed);
+    BufferType data(size);
+    Fill_Dump(data.data(), size, random);
+    return data;
+}
+
+
+static BufferType Make_Log(int size, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::string text;
+    char line[128];
+
+    while ((int)text.size() < size) {
+        std::snprintf(line, sizeof(line), "[%08u] Frame %u: Unit %u moved to cell %u,%u.\r\n",
+            (unsigned)text.size(), (unsigned)(random() % 100000), (unsigned)(random() % 2000), (unsigned)(random() % 512), (unsigned)(random() % 512));
+        text += line;
+    }
+    text.resize(size);
+
+    return BufferType(text.begin(), text.end());
+}
+
+
+/**
+ *  Deflated data must inflate back to the input for every kind of input and
+ *  however it is fed to the deflater.
+ */
+static void Test_Deflate()
+{
+    std::mt19937 random(1234);
+
+    std::vector<BufferType> inputs;
+    inputs.push_back(BufferType());
+    inputs.push_back(BufferType(1, 'A'));
+    inputs.push_back(BufferType(3, 'A'));
+    inputs.push_back(BufferType(100000, 0));
+    inputs.push_back(Make_Log(300000, 1));
+    inputs.push_back(Make_Dump(1*1024*1024, 2));
+
+    BufferType noise(200000);
+    for (unsigned char &byte : noise) {
+        byte = (unsigned char)random();
+    }
+    inputs.push_back(noise);
+
+    /**
+     *  Matches at the longest distance, either side of the window slide.
+     */
+    BufferType repeat(32768*5 + 17);
+    for (size_t i = 0; i < repeat.size(); ++i) {
+        repeat[i] = (i % 32506) < 300 ? (unsigned char)(i % 32506) : (unsigned char)random();
+    }
+    inputs.push_back(repeat);
+
+    static const int pieces[] = { 1, 7, 4096, 65536, 1 << 30 };
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        for (int piece : pieces) {
+            if (piece == 1 && inputs[i].size() > 100000) {
+                continue;
+            }
+
+            BufferType compressed = Deflate(inputs[i], piece);
+            BufferType output;
+            TEST_CHECK_PRINT(Inflate(compressed, output), "input %d, pieces of %d", (int)i, piece);
+            TEST_CHECK_PRINT(output == inputs[i], "input %d, pieces of %d", (int)i, piece);
+        }
+    }
+
+    /**
+     *  Compressible data must actually be compressed.
+     */
+    TEST_CHECK(Deflate(inputs[3], 65536).size() < 1000);
+    TEST_CHECK(Deflate(inputs[4], 65536).size() < inputs[4].size() / 2);
+}
+
+
+/**
+ *  An entry read back from an archive.
+ */
+struct ZipEntryStruct
+{
+    std::string Name;
+    int Method;
+    uint32_t CRC;
+    uint32_t CompressedSize;
+    uint32_t Size;
+    long DataOffset;
+};
+
+
+static uint32_t Get_Word(const unsigned char *data)
+{
+    return data[0] | (data[1] << 8);
+}
+
+
+static uint32_t Get_Long(const unsigned char *data)
+{
+    return Get_Word(data) | (Get_Word(data + 2) << 16);
+}
+
+
+/**
+ *  Reads the central directory of an archive, checking each local header
+ *  agrees with it.
+ */
+static bool Read_Zip(const char *filename, std::vector<ZipEntryStruct> &entries)
+{
+    std::FILE *file = std::fopen(filename, "rb");
+    if (!file) {
+        return false;
+    }
+
+    unsigned char end[22];
+    bool success = std::fseek(file, -22, SEEK_END) == 0 && std::fread(end, 1, 22, file) == 22 && Get_Long(end) == 0x06054B50;
+
+    int count = success ? (int)Get_Word(&end[10]) : 0;
+    uint32_t directory_size = success ? Get_Long(&end[12]) : 0;
+    uint32_t directory_offset = success ? Get_Long(&end[16]) : 0;
+
+    BufferType directory(directory_size);
+    success = success && std::fseek(file, directory_offset, SEEK_SET) == 0 && std::fread(directory.data(), 1, directory_size, file) == directory_size;
+
+    size_t position = 0;
+    for (int i = 0; i < count && success; ++i) {
+        const unsigned char *record = &directory[position];
+        if (position + 46 > directory.size() || Get_Long(record) != 0x02014B50) {
+            success = false;
+            break;
+        }
+
+        ZipEntryStruct entry;
+        entry.Method = Get_Word(&record[10]);
+        entry.CRC = Get_Long(&record[16]);
+        entry.CompressedSize = Get_Long(&record[20]);
+        entry.Size = Get_Long(&record[24]);
+        int name_length = Get_Word(&record[28]);
+        entry.Name.assign((const char *)&record[46], name_length);
+        uint32_t offset = Get_Long(&record[42]);
+        position += 46 + name_length + Get_Word(&record[30]) + Get_Word(&record[32]);
+
+        unsigned char local[30];
+        success = std::fseek(file, offset, SEEK_SET) == 0 && std::fread(local, 1, 30, file) == 30
+               && Get_Long(local) == 0x04034B50
+               && (int)Get_Word(&local[8]) == entry.Method
+               && Get_Long(&local[14]) == entry.CRC
+               && Get_Long(&local[18]) == entry.CompressedSize
+               && Get_Long(&local[22]) == entry.Size
+               && (int)Get_Word(&local[26]) == name_length;
+
+        entry.DataOffset = offset + 30 + name_length + Get_Word(&local[28]);
+        entries.push_back(entry);
+    }
+
+    std::fclose(file);
+
+    return success;
+}
+
+
+static BufferType Read_Entry(const char *filename, const ZipEntryStruct &entry)
+{
+    BufferType data(entry.CompressedSize);
+    std::FILE *file = std::fopen(filename, "rb");
+    if (file) {
+        std::fseek(file, entry.DataOffset, SEEK_SET);
+        if (std::fread(data.data(), 1, data.size(), file) != data.size()) {
+            data.clear();
+        }
+        std::fclose(file);
+    }
+    return data;
+}
+
+
+static bool Write_File(const std::string &filename, const BufferType &data)
+{
+    std::FILE *file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool success = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    return (std::fclose(file) == 0) && success;
+}
+
+
+static bool File_Exists(const std::string &filename)
+{
+    std::FILE *file = std::fopen(filename.c_str(), "rb");
+    if (file) {
+        std::fclose(file);
+    }
+    return file != nullptr;
+}
+
+
+static std::string Temp_Path(const char *name)
+{
+    const char *directory = std::getenv("TMPDIR");
+    return std::string(directory && *directory ? directory : "/tmp") + "/vinifera_zipwriter_test_" + name;
+}
+
+
+/**
+ *  Writes archives of stored and deflated files with different thread counts
+ *  and reads every entry back.
+ */
+static void Test_Archive()
+{
+    struct {
+        const char *Name;
+        BufferType Data;
+        bool Store;
+    } files[] = {
+        { "DEBUG.LOG", Make_Log(2*1024*1024, 10), false },
+        { "EXCEPT.TXT", Make_Log(20000, 11), false },
+        { "EMPTY.TXT", BufferType(), false },
+        { "SCREEN.PNG", Make_Dump(300000, 12), true },
+        { "debug\\CRASH.DMP", Make_Dump(3*1024*1024, 13), true },
+        { "SYNC.TXT", Make_Log(500000, 14), false },
+    };
+
+    const size_t file_count = sizeof(files) / sizeof(files[0]);
+    const std::string archive = Temp_Path("archive.zip");
+
+    for (int threads : { 1, 2, 8 }) {
+
+        ZipWriterClass zip;
+        for (auto &file : files) {
+            std::string path = Temp_Path(std::to_string(&file - files).c_str());
+            TEST_CHECK(Write_File(path, file.Data));
+            zip.Add_File(file.Name, path.c_str(), file.Store);
+        }
+
+        TEST_CHECK_PRINT(zip.Write(archive.c_str(), threads), "%d threads", threads);
+
+        std::vector<ZipEntryStruct> entries;
+        TEST_CHECK(Read_Zip(archive.c_str(), entries));
+        TEST_CHECK(entries.size() == file_count);
+
+        for (size_t i = 0; i < entries.size() && i < file_count; ++i) {
+            const ZipEntryStruct &entry = entries[i];
+
+            std::string name = files[i].Name;
+            std::replace(name.begin(), name.end(), '\\', '/');
+            TEST_CHECK(entry.Name == name);
+            TEST_CHECK(entry.Method == (files[i].Store ? 0 : 8));
+            TEST_CHECK(entry.Size == files[i].Data.size());
+
+            BufferType data = Read_Entry(archive.c_str(), entry);
+            BufferType output;
+            if (entry.Method == 8) {
+                TEST_CHECK_PRINT(Inflate(data, output), "%s", entry.Name.c_str());
+            } else {
+                output = data;
+            }
+            TEST_CHECK_PRINT(output == files[i].Data, "%s, %d threads", entry.Name.c_str(), threads);
+            TEST_CHECK(entry.CRC == Zip_CRC32(0, output.data(), (int)output.size()));
+        }
+    }
+
+    /**
+     *  A missing file fails the archive and leaves nothing behind.
+     */
+    ZipWriterClass zip;
+    zip.Add_File("DEBUG.LOG", Temp_Path("0").c_str());
+    zip.Add_File("MISSING.LOG", Temp_Path("missing").c_str());
+    TEST_CHECK(!zip.Write(archive.c_str()));
+    TEST_CHECK(!File_Exists(archive));
+    TEST_CHECK(!File_Exists(archive + ".0.tmp"));
+
+    for (size_t i = 0; i < file_count; ++i) {
+        std::remove(Temp_Path(std::to_string(i).c_str()).c_str());
+    }
+
+    /**
+     *  The known check value of the CRC.
+     */
+    TEST_CHECK(Zip_CRC32(0, "123456789", 9) == 0xCBF43926);
+}
+
+
+static long Peak_Memory_KB()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+
+static double Seconds_Since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+/**
+ *  Archives a 200MB mini dump along with the logs, as the crash handler does,
+ *  and reports the time taken and the memory used. This runs first and the
+ *  files are written in pieces, so the only large allocations would be the
+ *  writer's own.
+ */
+static void Test_Large_Dump()
+{
+    const std::string dump = Temp_Path("large.dmp");
+    const std::string log = Temp_Path("large.log");
+    const std::string archive = Temp_Path("large.zip");
+
+    {
+        std::mt19937 random(99);
+        BufferType piece(1024*1024);
+        std::FILE *file = std::fopen(dump.c_str(), "wb");
+        TEST_CHECK(file != nullptr);
+        if (!file) {
+            return;
+        }
+        for (int written = 0; written < DUMP_SIZE; written += (int)piece.size()) {
+            Fill_Dump(piece.data(), (int)piece.size(), random);
+            std::fwrite(piece.data(), 1, piece.size(), file);
+        }
+        std::fclose(file);
+
+        file = std::fopen(log.c_str(), "wb");
+        TEST_CHECK(file != nullptr);
+        if (!file) {
+            return;
+        }
+        for (int i = 0; i < 16; ++i) {
+            BufferType text = Make_Log(256*1024, 98 + i);
+            std::fwrite(text.data(), 1, text.size(), file);
+        }
+        std::fclose(file);
+    }
+
+    const long baseline = Peak_Memory_KB();
+
+    struct {
+        const char *Name;
+        bool Store;
+        int Threads;
+    } runs[] = {
+        { "stored", true, 0 },
+        { "deflated, 1 thread", false, 1 },
+        { "deflated, a thread per processor", false, 0 },
+    };
+
+    for (auto &run : runs) {
+        ZipWriterClass zip;
+        zip.Add_File("DEBUG.LOG", log.c_str());
+        zip.Add_File("CRASH.DMP", dump.c_str(), run.Store);
+        zip.Add_File("DEBUG2.LOG", log.c_str());
+
+        auto start = std::chrono::steady_clock::now();
+        TEST_CHECK(zip.Write(archive.c_str(), run.Threads));
+        double seconds = Seconds_Since(start);
+
+        std::vector<ZipEntryStruct> entries;
+        TEST_CHECK(Read_Zip(archive.c_str(), entries));
+        TEST_CHECK(entries.size() == 3);
+
+        long archive_size = entries.empty() ? 0 : entries.back().DataOffset + entries.back().CompressedSize;
+        std::printf("200MB dump %s, with 8MB of logs: %.2f s, %.1f MB/s, archive %.1f MB.\n",
+            run.Name, seconds, (DUMP_SIZE / (1024.0*1024.0)) / seconds, archive_size / (1024.0*1024.0));
+    }
+
+    /**
+     *  Streaming keeps the writer's memory to its buffers, a few hundred KB a
+     *  thread, whatever the size of the files.
+     */
+    long growth = Peak_Memory_KB() - baseline;
+    std::printf("Peak memory growth while archiving: %ld KB.\n", growth);
+    TEST_CHECK_PRINT(growth < 32*1024, "%ld KB", growth);
+
+    std::remove(dump.c_str());
+    std::remove(log.c_str());
+    std::remove(archive.c_str());
+}
+
+
+int main()
+{
+    Test_Large_Dump();
+    Test_Deflate();
+    Test_Archive();
+
+    return TEST_RESULT();
+}
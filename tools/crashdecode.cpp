@@ -0,0 +1,98 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          CRASHDECODE.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Prints a crash record with its frames symbolised.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "crashdecoder.h"
+#include <cstdio>
+#include <vector>
+
+
+static bool Read_File(const char *filename, std::vector<char> &data)
+{
+    std::FILE *file = std::fopen(filename, "rb");
+    if (!file) {
+        return false;
+    }
+
+    data.clear();
+    char chunk[4096];
+    size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    std::fclose(file);
+
+    return true;
+}
+
+
+/**
+ *  Usage: crashdecode <record> [map...]
+ *
+ *  Prints a CRASH_*.BIN record written with -FAST_CRASH_CAPTURE. Each map is
+ *  a linker map (such as the Vinifera.map written next to the DLL by the
+ *  build) and is matched to a loaded module by its file name, so the frames
+ *  in that module are printed with their symbol.
+ */
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <record> [map...]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<char> data;
+    if (!Read_File(argv[1], data)) {
+        std::fprintf(stderr, "Failed to open \"%s\"!\n", argv[1]);
+        return 1;
+    }
+
+    CrashRecordFileStruct record;
+    if (!Crash_Record_Read(data.data(), (int)data.size(), record)) {
+        std::fprintf(stderr, "\"%s\" is not a valid crash record!\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<AddressMapClass> maps;
+
+    for (int index = 2; index < argc; ++index) {
+        if (!Read_File(argv[index], data)) {
+            std::fprintf(stderr, "Failed to open \"%s\"!\n", argv[index]);
+            return 1;
+        }
+
+        AddressMapClass map;
+        if (!map.Load(argv[index], data.data(), (int)data.size())) {
+            std::fprintf(stderr, "\"%s\" is not a valid linker map!\n", argv[index]);
+            return 1;
+        }
+        maps.push_back(map);
+    }
+
+    std::fputs(Crash_Record_Decode(record, maps).c_str(), stdout);
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          CRASHDECODER.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Offline decoding and symbolising of crash records.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "crashdecoder.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+
+/**
+ *  The crash record layout, these must match crashrecord.h.
+ */
+#define CRASH_RECORD_ID             0x53524356 // "VCRS"
+#define CRASH_RECORD_VERSION        1
+
+#define CRASH_RECORD_FRAMES_MAX     64
+#define CRASH_RECORD_MODULES_MAX    128
+
+#define CRASH_RECORD_HEADER_SIZE    (11 * 4 + 48)
+#define CRASH_RECORD_MODULE_SIZE    (3 * 4 + 64)
+
+
+static uint32_t Read_Word(const unsigned char *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+
+static std::string Read_String(const unsigned char *data, int size)
+{
+    const char *text = (const char *)data;
+    return std::string(text, std::find(text, text + size, '\0'));
+}
+
+
+/**
+ *  Returns the lower case module name without its path or extension, which is
+ *  how the maps and the recorded modules are matched.
+ */
+static std::string Module_Key(const std::string &name)
+{
+    std::string key = name.substr(name.find_last_of("/\\") == std::string::npos ? 0 : name.find_last_of("/\\") + 1);
+    key = key.substr(0, key.find_last_of('.'));
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return key;
+}
+
+
+/**
+ *  Reads the public and static symbols of a Visual C++ linker map.
+ *
+ *  Each symbol line is "segment:offset name rva+base [f] [i] object", the
+ *  preferred load address is subtracted to get the address in the image.
+ *
+ *  @author: agent
+ */
+bool AddressMapClass::Load(const char *module, const char *text, int length)
+{
+    Module = Module_Key(module ? module : "");
+    Symbols.clear();
+
+    if (!text || length <= 0) {
+        return false;
+    }
+
+    std::string map(text, length);
+
+    const char *preferred_text = std::strstr(map.c_str(), "Preferred load address is ");
+    if (!preferred_text) {
+        return false;
+    }
+
+    unsigned preferred = 0;
+    if (std::sscanf(preferred_text, "Preferred load address is %x", &preferred) != 1) {
+        return false;
+    }
+
+    size_t position = 0;
+    while (position < map.size()) {
+
+        size_t end = map.find('\n', position);
+        if (end == std::string::npos) {
+            end = map.size();
+        }
+
+        std::string line = map.substr(position, end - position);
+        position = end + 1;
+
+        unsigned segment = 0;
+        unsigned offset = 0;
+        unsigned address = 0;
+        char name[1024];
+
+        if (std::sscanf(line.c_str(), " %x:%x %1023s %x", &segment, &offset, name, &address) != 4) {
+            continue;
+        }
+
+        /**
+         *  Segment zero holds absolute symbols, not code or data.
+         */
+        if (segment == 0 || address < preferred) {
+            continue;
+        }
+
+        Symbols.push_back({ address - preferred, name });
+    }
+
+    std::stable_sort(Symbols.begin(), Symbols.end(), [](const SymbolStruct &a, const SymbolStruct &b) { return a.RVA < b.RVA; });
+
+    return !Symbols.empty();
+}
+
+
+/**
+ *  Finds the symbol at or before the address, returning its name and the
+ *  offset of the address into it.
+ *
+ *  @author: agent
+ */
+const char *AddressMapClass::Find(uint32_t rva, uint32_t &offset) const
+{
+    auto it = std::upper_bound(Symbols.begin(), Symbols.end(), rva, [](uint32_t value, const SymbolStruct &symbol) { return value < symbol.RVA; });
+    if (it == Symbols.begin()) {
+        return nullptr;
+    }
+
+    --it;
+    offset = rva - it->RVA;
+    return it->Name.c_str();
+}
+
+
+/**
+ *  Reads a crash record, checking its sizes against the data.
+ *
+ *  @author: agent
+ */
+bool Crash_Record_Read(const void *data, int length, CrashRecordFileStruct &record)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+
+    if (!bytes || length < CRASH_RECORD_HEADER_SIZE) {
+        return false;
+    }
+
+    if (Read_Word(&bytes[0]) != CRASH_RECORD_ID || Read_Word(&bytes[4]) != CRASH_RECORD_VERSION) {
+        return false;
+    }
+
+    uint32_t frame_count = Read_Word(&bytes[36]);
+    uint32_t module_count = Read_Word(&bytes[40]);
+
+    if (frame_count > CRASH_RECORD_FRAMES_MAX || module_count > CRASH_RECORD_MODULES_MAX) {
+        return false;
+    }
+
+    if (length != (int)(CRASH_RECORD_HEADER_SIZE + frame_count * 4 + module_count * CRASH_RECORD_MODULE_SIZE)) {
+        return false;
+    }
+
+    record.ExceptionCode = Read_Word(&bytes[8]);
+    record.ExceptionAddress = Read_Word(&bytes[12]);
+    record.AccessType = Read_Word(&bytes[16]);
+    record.AccessAddress = Read_Word(&bytes[20]);
+    record.Eip = Read_Word(&bytes[24]);
+    record.Esp = Read_Word(&bytes[28]);
+    record.Ebp = Read_Word(&bytes[32]);
+    record.BuildHash = Read_String(&bytes[44], 48);
+
+    const unsigned char *cursor = &bytes[CRASH_RECORD_HEADER_SIZE];
+
+    record.Frames.clear();
+    for (uint32_t i = 0; i < frame_count; ++i, cursor += 4) {
+        record.Frames.push_back(Read_Word(cursor));
+    }
+
+    record.Modules.clear();
+    for (uint32_t i = 0; i < module_count; ++i, cursor += CRASH_RECORD_MODULE_SIZE) {
+        CrashRecordFileStruct::ModuleStruct module;
+        module.Base = Read_Word(&cursor[0]);
+        module.Size = Read_Word(&cursor[4]);
+        module.TimeDateStamp = Read_Word(&cursor[8]);
+        module.Name = Read_String(&cursor[12], 64);
+        record.Modules.push_back(module);
+    }
+
+    return true;
+}
+
+
+/**
+ *  Formats the record as text, resolving each frame to a symbol where a map
+ *  for its module was given.
+ *
+ *  @author: agent
+ */
+std::string Crash_Record_Decode(const CrashRecordFileStruct &record, const std::vector<AddressMapClass> &maps)
+{
+    std::string output;
+    char buffer[1024];
+
+    std::snprintf(buffer, sizeof(buffer), "Build: %s\n", record.BuildHash.c_str());
+    output += buffer;
+
+    std::snprintf(buffer, sizeof(buffer), "Exception 0x%08X at 0x%08X\n", record.ExceptionCode, record.ExceptionAddress);
+    output += buffer;
+
+    if (record.ExceptionCode == 0xC0000005) {
+        static const char *const access[] = { "reading", "writing" };
+        const char *type = record.AccessType < 2 ? access[record.AccessType] : "executing";
+        std::snprintf(buffer, sizeof(buffer), "Access violation %s 0x%08X\n", type, record.AccessAddress);
+        output += buffer;
+    }
+
+    std::snprintf(buffer, sizeof(buffer), "EIP 0x%08X ESP 0x%08X EBP 0x%08X\n\n", record.Eip, record.Esp, record.Ebp);
+    output += buffer;
+
+    output += "Call Stack:\n";
+
+    for (uint32_t address : record.Frames) {
+
+        const CrashRecordFileStruct::ModuleStruct *module = nullptr;
+        for (const auto &m : record.Modules) {
+            if (address >= m.Base && address - m.Base < m.Size) {
+                module = &m;
+                break;
+            }
+        }
+
+        if (!module) {
+            std::snprintf(buffer, sizeof(buffer), "  0x%08X <Unknown>\n", address);
+            output += buffer;
+            continue;
+        }
+
+        uint32_t rva = address - module->Base;
+
+        const char *symbol = nullptr;
+        uint32_t offset = 0;
+        std::string key = Module_Key(module->Name);
+        for (const AddressMapClass &map : maps) {
+            if (map.Module_Name() == key) {
+                symbol = map.Find(rva, offset);
+                break;
+            }
+        }
+
+        if (symbol) {
+            std::snprintf(buffer, sizeof(buffer), "  0x%08X %s+0x%X %s+0x%X\n", address, module->Name.c_str(), rva, symbol, offset);
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "  0x%08X %s+0x%X\n", address, module->Name.c_str(), rva);
+        }
+        output += buffer;
+    }
+
+    output += "\nModules:\n";
+
+    for (const auto &module : record.Modules) {
+        std::snprintf(buffer, sizeof(buffer), "  0x%08X 0x%08X %08X %s\n", module.Base, module.Size, module.TimeDateStamp, module.Name.c_str());
+        output += buffer;
+    }
+
+    return output;
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          CRASHDECODER.H
+ *
+ *  @author        agent
+ *
+ *  @brief         Offline decoding and symbolising of crash records.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include "always.h"
+#include <string>
+#include <vector>
+
+
+/**
+ *  The symbols of one module, read from the map file the linker writes at
+ *  build time. Addresses are held relative to the image base, so they apply
+ *  wherever the module was loaded.
+ */
+class AddressMapClass
+{
+    public:
+        AddressMapClass() : Module(), Symbols() {}
+
+        bool Load(const char *module, const char *text, int length);
+
+        const char *Find(uint32_t rva, uint32_t &offset) const;
+
+        const std::string &Module_Name() const { return Module; }
+        int Count() const { return (int)Symbols.size(); }
+
+    private:
+        struct SymbolStruct
+        {
+            uint32_t RVA;
+            std::string Name;
+        };
+
+        /**
+         *  The module name the map belongs to, without its extension.
+         */
+        std::string Module;
+
+        /**
+         *  The symbols, sorted by their address.
+         */
+        std::vector<SymbolStruct> Symbols;
+};
+
+
+/**
+ *  A crash record as written by Crash_Record_Write.
+ */
+struct CrashRecordFileStruct
+{
+    struct ModuleStruct
+    {
+        uint32_t Base;
+        uint32_t Size;
+        uint32_t TimeDateStamp;
+        std::string Name;
+    };
+
+    uint32_t ExceptionCode;
+    uint32_t ExceptionAddress;
+    uint32_t AccessType;
+    uint32_t AccessAddress;
+    uint32_t Eip;
+    uint32_t Esp;
+    uint32_t Ebp;
+    std::string BuildHash;
+    std::vector<uint32_t> Frames;
+    std::vector<ModuleStruct> Modules;
+};
+
+
+bool Crash_Record_Read(const void *data, int length, CrashRecordFileStruct &record);
+std::string Crash_Record_Decode(const CrashRecordFileStruct &record, const std::vector<AddressMapClass> &maps);
@@ -0,0 +1,106 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          EDBCOMPILE.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Compiles a text exception database into its binary form.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "exceptiondb.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+/**
+ *  Usage: edbcompile <input> <output>
+ *
+ *  Reads a text (or already compiled) exception database and writes the
+ *  compiled form, which Vinifera loads in place of the text file. The output
+ *  is read back and checked against the input before the tool succeeds.
+ */
+int main(int argc, char **argv)
+{
+    if (argc != 3) {
+        std::fprintf(stderr, "Usage: %s <input> <output>\n", argv[0]);
+        return 1;
+    }
+
+    std::FILE *in = std::fopen(argv[1], "rb");
+    if (!in) {
+        std::fprintf(stderr, "Failed to open \"%s\"!\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<char> text;
+    char chunk[4096];
+    size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), in)) > 0) {
+        text.insert(text.end(), chunk, chunk + read);
+    }
+    std::fclose(in);
+
+    ExceptionDatabaseClass database;
+    if (!database.Load(text.data(), (int)text.size())) {
+        std::fprintf(stderr, "Failed to load \"%s\"!\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<unsigned char> compiled;
+    database.Save_Compiled(compiled);
+
+    /**
+     *  Make sure the compiled form loads back to the same table.
+     */
+    ExceptionDatabaseClass check;
+    if (!check.Load_Compiled(compiled.data(), (int)compiled.size()) || check.Count() != database.Count()) {
+        std::fprintf(stderr, "The compiled database failed to load back!\n");
+        return 1;
+    }
+    for (int index = 0; index < database.Count(); ++index) {
+        const ExceptionInfoDatabaseStruct &a = database[index];
+        const ExceptionInfoDatabaseStruct &b = check[index];
+        if (a.Address != b.Address || a.EndAddress != b.EndAddress || a.CanContinue != b.CanContinue
+         || a.Ignore != b.Ignore || std::strcmp(a.Description, b.Description) != 0) {
+            std::fprintf(stderr, "The compiled database does not match at entry %d!\n", index);
+            return 1;
+        }
+    }
+
+    std::FILE *out = std::fopen(argv[2], "wb");
+    if (!out) {
+        std::fprintf(stderr, "Failed to create \"%s\"!\n", argv[2]);
+        return 1;
+    }
+
+    bool written = std::fwrite(compiled.data(), 1, compiled.size(), out) == compiled.size();
+    written = (std::fclose(out) == 0) && written;
+    if (!written) {
+        std::fprintf(stderr, "Failed to write \"%s\"!\n", argv[2]);
+        return 1;
+    }
+
+    std::printf("Compiled %d entries (%d unique descriptions) into %d bytes.\n",
+        database.Count(), database.Description_Count(), (int)compiled.size());
+
+    return 0;
+}
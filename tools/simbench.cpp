@@ -0,0 +1,603 @@
+/*******************************************************************************
+/*                 O P E N  S O U R C E  --  V I N I F E R A                  **
+/*******************************************************************************
+ *
+ *  @project       Vinifera
+ *
+ *  @file          SIMBENCH.CPP
+ *
+ *  @author        agent
+ *
+ *  @brief         Headless benchmark of the portable logic modules.
+ *
+ *  @license       Vinifera is free software: you can redistribute it and/or
+ *                 modify it under the terms of the GNU General Public License
+ *                 as published by the Free Software Foundation, either version
+ *                 3 of the License, or (at your option) any later version.
+ *
+ *                 Vinifera is distributed in the hope that it will be
+ *                 useful, but WITHOUT ANY WARRANTY; without even the implied
+ *                 warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *                 PURPOSE. See the GNU General Public License for more details.
+ *
+ *                 You should have received a copy of the GNU General Public
+ *                 License along with this program.
+ *                 If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "damagefalloff.h"
+#include "buildablescache.h"
+#include "shapeexpand.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <vector>
+
+
+/**
+ *  The subsystems timed by the benchmark.
+ */
+typedef enum SubsystemType
+{
+    SUBSYSTEM_NONE = -1,
+
+    SUBSYSTEM_VERSES,
+    SUBSYSTEM_BUILDABLES,
+    SUBSYSTEM_SHAPE_EXPAND,
+
+    SUBSYSTEM_COUNT
+} SubsystemType;
+
+static const char *SubsystemNames[SUBSYSTEM_COUNT] = {
+    "verses",
+    "buildables",
+    "shape_expand"
+};
+
+
+struct SubsystemStatsStruct
+{
+    int Calls;
+    double TotalTime;
+    double PeakTime;
+    long long Allocations;
+    long long Frees;
+    uint32_t Checksum;
+};
+
+static SubsystemStatsStruct SubsystemStats[SUBSYSTEM_COUNT];
+static SubsystemType CurrentSubsystem = SUBSYSTEM_NONE;
+
+
+/**
+ *  Counts the allocations made by the subsystem being timed, the same way
+ *  Vinifera counts its own with Vinifera_New_Count and Vinifera_Delete_Count.
+ */
+void *operator new(size_t size)
+{
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    if (CurrentSubsystem != SUBSYSTEM_NONE) {
+        ++SubsystemStats[CurrentSubsystem].Allocations;
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (ptr && CurrentSubsystem != SUBSYSTEM_NONE) {
+        ++SubsystemStats[CurrentSubsystem].Frees;
+    }
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+
+/**
+ *  Times one call into a subsystem.
+ */
+class SubsystemTimerClass
+{
+    public:
+        SubsystemTimerClass(SubsystemType subsystem) :
+            Subsystem(subsystem),
+            Start(std::chrono::steady_clock::now())
+        {
+            CurrentSubsystem = subsystem;
+        }
+
+        ~SubsystemTimerClass()
+        {
+            double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+            SubsystemStatsStruct &stats = SubsystemStats[Subsystem];
+            ++stats.Calls;
+            stats.TotalTime += time;
+            stats.PeakTime = std::max(stats.PeakTime, time);
+
+            CurrentSubsystem = SUBSYSTEM_NONE;
+        }
+
+    private:
+        SubsystemType Subsystem;
+        std::chrono::steady_clock::time_point Start;
+};
+
+
+/**
+ *  Mixes a result into the checksum of a subsystem, so runs with the same seed
+ *  can be checked to have done the same work.
+ */
+static void Checksum(SubsystemType subsystem, int value)
+{
+    BuildablesCacheClass::Hash(SubsystemStats[subsystem].Checksum, value);
+}
+
+
+/**
+ *  The Verses scenario; explosions of random warheads against units of random
+ *  armor around the impact point, using the damage modification of the game.
+ */
+#define VERSES_WARHEAD_COUNT    40
+#define VERSES_ARMOR_COUNT      11
+#define VERSES_MAX_DAMAGE       1000
+#define VERSES_MIN_DAMAGE       1
+#define PIXEL_LEPTON_W          8
+
+struct WarheadStruct
+{
+    int SpreadFactor;
+    int MinDamage;
+    int DistanceDivisor;
+    DamageReciprocalStruct DistanceReciprocal;
+    double Modifiers[VERSES_ARMOR_COUNT];
+};
+
+static WarheadStruct Warheads[VERSES_WARHEAD_COUNT];
+
+/**
+ *  The damage done to each unit hit in a frame, drawn before the frame is timed.
+ */
+struct VersesHitStruct
+{
+    int Warhead;
+    int Damage;
+    int Armor;
+    int Distance;
+};
+
+static std::vector<VersesHitStruct> VersesHits;
+
+
+static void Verses_Setup(std::mt19937 &random)
+{
+    for (WarheadStruct &warhead : Warheads) {
+        warhead.SpreadFactor = (int)(random() % 4);
+        warhead.MinDamage = (random() % 4) == 0 ? (int)(random() % 10) : -1;
+
+        if (!warhead.SpreadFactor) {
+            warhead.DistanceDivisor = PIXEL_LEPTON_W / 2;
+        } else {
+            warhead.DistanceDivisor = warhead.SpreadFactor * (PIXEL_LEPTON_W / 2 + 1);
+        }
+        warhead.DistanceReciprocal = Make_Reciprocal(warhead.DistanceDivisor);
+
+        for (double &modifier : warhead.Modifiers) {
+            modifier = (random() % 5) == 0 ? 0.0 : (double)(random() % 200) / 100.0;
+        }
+    }
+}
+
+
+/**
+ *  The equivalent of Modify_Damage for a warhead with a damage profile.
+ */
+static int Verses_Modify_Damage(int damage, const WarheadStruct &warhead, int armor, int distance)
+{
+    if (damage == 0) {
+        return 0;
+    }
+
+    if (damage < 0) {
+        return distance < 8 ? damage : 0;
+    }
+
+    const int min_damage = warhead.MinDamage >= 0 ? warhead.MinDamage : VERSES_MIN_DAMAGE;
+
+    damage *= warhead.Modifiers[armor];
+    damage = std::max(min_damage, damage);
+
+    if (damage) {
+        distance = Damage_Falloff_Step(distance, warhead.DistanceDivisor, warhead.DistanceReciprocal);
+
+        if (distance) {
+            damage = Damage_Falloff(damage, distance);
+        }
+
+        if (distance < 4) {
+            damage = std::max(damage, min_damage);
+        }
+    }
+
+    return std::min(damage, VERSES_MAX_DAMAGE);
+}
+
+
+static void Verses_Frame(std::mt19937 &random)
+{
+    VersesHits.clear();
+
+    int explosions = (int)(random() % 24);
+    for (int explosion = 0; explosion < explosions; ++explosion) {
+        VersesHitStruct hit;
+        hit.Warhead = (int)(random() % VERSES_WARHEAD_COUNT);
+        hit.Damage = (int)(random() % 300) - 20;
+
+        /**
+         *  Everything within a few cells of the impact point is damaged.
+         */
+        int targets = 1 + (int)(random() % 40);
+        for (int target = 0; target < targets; ++target) {
+            hit.Armor = (int)(random() % VERSES_ARMOR_COUNT);
+            hit.Distance = (int)(random() % 1024);
+            VersesHits.push_back(hit);
+        }
+    }
+
+    SubsystemTimerClass timer(SUBSYSTEM_VERSES);
+
+    for (const VersesHitStruct &hit : VersesHits) {
+        Checksum(SUBSYSTEM_VERSES, Verses_Modify_Damage(hit.Damage, Warheads[hit.Warhead], hit.Armor, hit.Distance));
+    }
+}
+
+
+/**
+ *  The buildables scenario; houses gaining, losing and capturing objects while
+ *  the factories of the player fetch what can be built every update, as in
+ *  the house AI and the sidebar.
+ */
+#define BUILDABLES_LIST_COUNT   4
+#define BUILDABLES_TYPE_COUNT   48
+#define BUILDABLES_HOUSE_COUNT  4
+#define BUILDABLES_FACTORIES    12
+
+struct BuildableTypeStruct
+{
+    int Prerequisite;
+    int TechLevel;
+    bool NeedsPower;
+};
+
+struct BuildableHouseStruct
+{
+    int Power;
+    int Drain;
+    int TechLevel;
+    int Owned[BUILDABLES_LIST_COUNT][BUILDABLES_TYPE_COUNT];
+};
+
+static BuildableTypeStruct BuildableTypes[BUILDABLES_LIST_COUNT][BUILDABLES_TYPE_COUNT];
+static BuildableHouseStruct BuildableHouses[BUILDABLES_HOUSE_COUNT];
+
+
+static uint32_t Buildables_Tech_State(void *param)
+{
+    const BuildableHouseStruct &house = *(BuildableHouseStruct *)param;
+    uint32_t hash = BuildablesCacheClass::HASH_START;
+
+    BuildablesCacheClass::Hash(hash, house.Power);
+    BuildablesCacheClass::Hash(hash, house.Drain);
+    BuildablesCacheClass::Hash(hash, house.TechLevel);
+
+    for (int list = 0; list < BUILDABLES_LIST_COUNT; ++list) {
+        for (int type = 0; type < BUILDABLES_TYPE_COUNT; ++type) {
+            BuildablesCacheClass::Hash(hash, house.Owned[list][type]);
+        }
+    }
+
+    return hash;
+}
+
+
+static uint32_t Buildables_Quick_State(const BuildableHouseStruct &house)
+{
+    uint32_t hash = BuildablesCacheClass::HASH_START;
+
+    BuildablesCacheClass::Hash(hash, house.Power);
+    BuildablesCacheClass::Hash(hash, house.Drain);
+    BuildablesCacheClass::Hash(hash, house.TechLevel);
+
+    for (int list = 0; list < BUILDABLES_LIST_COUNT; ++list) {
+        int count = 0;
+        for (const BuildableHouseStruct &other : BuildableHouses) {
+            for (int type = 0; type < BUILDABLES_TYPE_COUNT; ++type) {
+                count += other.Owned[list][type];
+            }
+        }
+        BuildablesCacheClass::Hash(hash, count);
+    }
+
+    return hash;
+}
+
+
+static void Buildables_Build(void *param, int list, std::vector<int> &buildables)
+{
+    const BuildableHouseStruct &house = *(BuildableHouseStruct *)param;
+
+    for (int type = 0; type < BUILDABLES_TYPE_COUNT; ++type) {
+        const BuildableTypeStruct &info = BuildableTypes[list][type];
+
+        if (info.TechLevel > house.TechLevel) {
+            continue;
+        }
+        if (info.Prerequisite >= 0 && house.Owned[0][info.Prerequisite] == 0) {
+            continue;
+        }
+        if (info.NeedsPower && house.Power < house.Drain) {
+            continue;
+        }
+
+        buildables.push_back(type);
+    }
+}
+
+
+static void Buildables_Setup(std::mt19937 &random)
+{
+    for (int list = 0; list < BUILDABLES_LIST_COUNT; ++list) {
+        for (int type = 0; type < BUILDABLES_TYPE_COUNT; ++type) {
+            BuildableTypeStruct &info = BuildableTypes[list][type];
+            info.Prerequisite = (random() % 4) == 0 ? -1 : (int)(random() % BUILDABLES_TYPE_COUNT);
+            info.TechLevel = (int)(random() % 10);
+            info.NeedsPower = (random() % 3) == 0;
+        }
+    }
+
+    for (BuildableHouseStruct &house : BuildableHouses) {
+        std::memset(&house, 0, sizeof(house));
+        house.Power = 100;
+        house.Drain = 50;
+        house.TechLevel = 7;
+        house.Owned[0][0] = 1;
+    }
+}
+
+
+static void Buildables_Frame(std::mt19937 &random, BuildablesCacheClass &cache, int frame)
+{
+    BuildableHouseStruct &player = BuildableHouses[0];
+
+    /**
+     *  Something changes in one frame out of four.
+     */
+    if (random() % 4 == 0) {
+        BuildableHouseStruct &house = BuildableHouses[random() % BUILDABLES_HOUSE_COUNT];
+        int list = (int)(random() % BUILDABLES_LIST_COUNT);
+        int type = (int)(random() % BUILDABLES_TYPE_COUNT);
+
+        switch (random() % 3) {
+            case 0:
+                ++house.Owned[list][type];
+                break;
+
+            case 1:
+                if (house.Owned[list][type] > 0) {
+                    --house.Owned[list][type];
+                }
+                break;
+
+            default:
+                player.Power += (int)(random() % 61) - 30;
+                break;
+        }
+    }
+
+    SubsystemTimerClass timer(SUBSYSTEM_BUILDABLES);
+
+    const uint32_t quick_state = Buildables_Quick_State(player);
+
+    for (int factory = 0; factory < BUILDABLES_FACTORIES; ++factory) {
+        const std::vector<int> &buildables = cache.Fetch(&player, factory % BUILDABLES_LIST_COUNT, frame, quick_state);
+        Checksum(SUBSYSTEM_BUILDABLES, (int)buildables.size());
+    }
+}
+
+
+/**
+ *  The shape scenario; the shroud and fog shapes are expanded when a game is
+ *  loaded, generated here as compressed shapes of the same layout.
+ */
+#define SHAPE_FRAME_COUNT       48
+#define SHAPE_FRAME_WIDTH       60
+#define SHAPE_FRAME_HEIGHT      30
+#define SHAPE_LOADS             50
+
+
+static void Shape_Encode_Line(const unsigned char *pixels, int width, std::vector<unsigned char> &output)
+{
+    std::vector<unsigned char> line(2);
+
+    for (int x = 0; x < width; ) {
+        if (pixels[x] == 0) {
+            int run = 0;
+            while (x < width && pixels[x] == 0 && run < 255) {
+                ++run;
+                ++x;
+            }
+            line.push_back(0);
+            line.push_back((unsigned char)run);
+        } else {
+            line.push_back(pixels[x++]);
+        }
+    }
+
+    line[0] = (unsigned char)line.size();
+    line[1] = (unsigned char)(line.size() >> 8);
+
+    output.insert(output.end(), line.begin(), line.end());
+}
+
+
+static std::vector<unsigned char> Shape_Generate(std::mt19937 &random)
+{
+    std::vector<unsigned char> shape(sizeof(ShapeExpandHeaderStruct) + SHAPE_FRAME_COUNT * sizeof(ShapeExpandFrameStruct));
+
+    ShapeExpandHeaderStruct header = { 0, SHAPE_FRAME_WIDTH, SHAPE_FRAME_HEIGHT, SHAPE_FRAME_COUNT };
+    std::memcpy(&shape[0], &header, sizeof(header));
+
+    std::vector<unsigned char> pixels(SHAPE_FRAME_WIDTH);
+
+    for (int frame = 0; frame < SHAPE_FRAME_COUNT; ++frame) {
+
+        ShapeExpandFrameStruct info;
+        std::memset(&info, 0, sizeof(info));
+        info.Width = SHAPE_FRAME_WIDTH;
+        info.Height = SHAPE_FRAME_HEIGHT;
+        info.Flags = SHAPE_FRAME_COMPRESSED|SHAPE_FRAME_TRANSPARENT;
+        info.Offset = (unsigned int)shape.size();
+
+        /**
+         *  A diamond of shading with transparent corners, like the cell edges.
+         */
+        for (int y = 0; y < SHAPE_FRAME_HEIGHT; ++y) {
+            int half = std::min(y, SHAPE_FRAME_HEIGHT - 1 - y) * 2 + 1;
+            for (int x = 0; x < SHAPE_FRAME_WIDTH; ++x) {
+                bool inside = x >= SHAPE_FRAME_WIDTH / 2 - half && x < SHAPE_FRAME_WIDTH / 2 + half;
+                pixels[x] = inside && (random() % 8) ? (unsigned char)(1 + random() % 255) : 0;
+            }
+            Shape_Encode_Line(pixels.data(), SHAPE_FRAME_WIDTH, shape);
+        }
+
+        std::memcpy(&shape[sizeof(ShapeExpandHeaderStruct) + frame * sizeof(ShapeExpandFrameStruct)], &info, sizeof(info));
+    }
+
+    return shape;
+}
+
+
+static void Shape_Load(const std::vector<unsigned char> &shroud, const std::vector<unsigned char> &fog)
+{
+    /**
+     *  The expanded shapes are kept between loads, as they are in the game.
+     */
+    static std::vector<unsigned char> expanded_shroud;
+    static std::vector<unsigned char> expanded_fog;
+
+    {
+        SubsystemTimerClass timer(SUBSYSTEM_SHAPE_EXPAND);
+
+        Checksum(SUBSYSTEM_SHAPE_EXPAND, Shape_Expand(shroud.data(), shroud.size(), expanded_shroud));
+        Checksum(SUBSYSTEM_SHAPE_EXPAND, Shape_Expand(fog.data(), fog.size(), expanded_fog));
+    }
+
+    for (unsigned char pixel : expanded_shroud) {
+        Checksum(SUBSYSTEM_SHAPE_EXPAND, pixel);
+    }
+    for (unsigned char pixel : expanded_fog) {
+        Checksum(SUBSYSTEM_SHAPE_EXPAND, pixel);
+    }
+}
+
+
+static bool Write_Results(std::FILE *out, int frames, unsigned seed)
+{
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"frames\": %d,\n", frames);
+    std::fprintf(out, "  \"seed\": %u,\n", seed);
+    std::fprintf(out, "  \"subsystems\": [\n");
+
+    for (int subsystem = 0; subsystem < SUBSYSTEM_COUNT; ++subsystem) {
+        const SubsystemStatsStruct &stats = SubsystemStats[subsystem];
+
+        std::fprintf(out, "    {\"name\": \"%s\", \"calls\": %d, \"total_ms\": %.3f, \"average_ms\": %.5f, \"peak_ms\": %.5f, \"allocations\": %lld, \"frees\": %lld, \"checksum\": \"%08x\"}%s\n",
+            SubsystemNames[subsystem],
+            stats.Calls,
+            stats.TotalTime,
+            stats.Calls ? stats.TotalTime / stats.Calls : 0.0,
+            stats.PeakTime,
+            stats.Allocations,
+            stats.Frees,
+            stats.Checksum,
+            (subsystem < SUBSYSTEM_COUNT-1) ? "," : "");
+    }
+
+    std::fprintf(out, "  ]\n");
+    std::fprintf(out, "}\n");
+
+    return std::ferror(out) == 0;
+}
+
+
+/**
+ *  Usage: simbench [frames] [seed] [output]
+ *
+ *  Runs the portable logic modules through a scripted game of the given number
+ *  of frames (3000 by default) from a fixed seed (1 by default), and writes the
+ *  time and the number of allocations of each subsystem as JSON to the output
+ *  file, or to the standard output. The same seed always does the same work,
+ *  which the checksum of each subsystem confirms, so the times can be compared
+ *  from commit to commit.
+ */
+int main(int argc, char **argv)
+{
+    if (argc > 4) {
+        std::fprintf(stderr, "Usage: %s [frames] [seed] [output]\n", argv[0]);
+        return 1;
+    }
+
+    const int frames = argc > 1 ? std::atoi(argv[1]) : 3000;
+    const unsigned seed = argc > 2 ? (unsigned)std::strtoul(argv[2], nullptr, 10) : 1;
+
+    if (frames <= 0) {
+        std::fprintf(stderr, "Invalid frame count \"%s\"!\n", argv[1]);
+        return 1;
+    }
+
+    std::mt19937 random(seed);
+
+    Verses_Setup(random);
+    Buildables_Setup(random);
+
+    const std::vector<unsigned char> shroud = Shape_Generate(random);
+    const std::vector<unsigned char> fog = Shape_Generate(random);
+
+    for (int load = 0; load < SHAPE_LOADS; ++load) {
+        Shape_Load(shroud, fog);
+    }
+
+    BuildablesCacheClass cache(BUILDABLES_LIST_COUNT, Buildables_Tech_State, Buildables_Build);
+
+    for (int frame = 0; frame < frames; ++frame) {
+        Verses_Frame(random);
+        Buildables_Frame(random, cache, frame);
+    }
+
+    std::FILE *out = stdout;
+    if (argc > 3) {
+        out = std::fopen(argv[3], "w");
+        if (!out) {
+            std::fprintf(stderr, "Failed to open \"%s\"!\n", argv[3]);
+            return 1;
+        }
+    }
+
+    bool written = Write_Results(out, frames, seed);
+
+    if (out != stdout) {
+        written = (std::fclose(out) == 0) && written;
+    }
+
+    return written ? 0 : 1;
+}